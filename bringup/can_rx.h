@@ -11,11 +11,10 @@
 
 namespace tvsc::bringup {
 
-template <size_t QUEUE_SIZE, size_t NUM_HANDLERS>
-tvsc::system::System::Task can_bus_receive(
-    tvsc::hal::can_bus::CanBusPeripheral& can_peripheral,
-    tvsc::message::CanBusMessageQueue<QUEUE_SIZE, NUM_HANDLERS>& queue,
-    tvsc::hal::led::LedPeripheral& led_peripheral) {
+template <typename QueueType>
+tvsc::system::System::Task can_bus_receive(tvsc::hal::can_bus::CanBusPeripheral& can_peripheral,
+                                           QueueType& queue,
+                                           tvsc::hal::led::LedPeripheral& led_peripheral) {
   using namespace std::chrono_literals;
   using namespace tvsc::hal::can_bus;
   using namespace tvsc::hal::gpio;
@@ -40,7 +39,15 @@ tvsc::system::System::Task can_bus_receive(
       auto led{led_peripheral.access()};
 
       tvsc::message::CanBusMessage message{};
-      if (can.receive(RxFifo::FIFO_ZERO, message) && queue.enqueue(message)) {
+      bool enqueued{false};
+      if (can.receive(RxFifo::FIFO_ZERO, message)) {
+        // Stamp the frame as soon as it has been read. The HAL does not report when the frame
+        // reached the FIFO, so the time that it waited there for this poll is not traced. Without
+        // latency tracing, this is zero and the clock is not read.
+        const auto received_at{QueueType::trace_timestamp()};
+        enqueued = queue.enqueue(message, received_at);
+      }
+      if (enqueued) {
         led.on();
         co_yield 50ms;
         led.off();
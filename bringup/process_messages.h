@@ -1,17 +1,49 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 
 #include "system/system.h"
 
 namespace tvsc::bringup {
 
+// Bounds on the work done at each wakeup, so that a busy bus cannot starve the other tasks.
+inline constexpr size_t MAX_MESSAGES_PER_BATCH{8};
+inline constexpr std::chrono::microseconds MESSAGE_BATCH_BUDGET{1000};
+
+/**
+ * Process the messages in the queue in batches. Between batches, the task sleeps until it is woken
+ * by the scheduler; wake it when a message is enqueued, for example from the queue's message
+ * available callback. The idle timeout is only a fallback in case a wakeup is missed.
+ */
 template <typename QueueType>
 tvsc::system::System::Task process_messages(QueueType& queue) {
   using namespace std::chrono_literals;
+  using ClockType = tvsc::system::System::ClockType;
+  while (true) {
+    queue.template drain<ClockType>(MAX_MESSAGES_PER_BATCH, MESSAGE_BATCH_BUDGET);
+    if (queue.has_message()) {
+      co_yield 0ms;
+    } else {
+      co_yield 1s;
+    }
+  }
+}
+
+/**
+ * As above, but routing each message through dispatcher.
+ */
+template <typename QueueType, typename DispatcherType>
+tvsc::system::System::Task process_messages(QueueType& queue, const DispatcherType& dispatcher) {
+  using namespace std::chrono_literals;
+  using ClockType = tvsc::system::System::ClockType;
   while (true) {
-    queue.process_next_message();
-    co_yield 50ms;
+    queue.template drain<ClockType>(dispatcher, MAX_MESSAGES_PER_BATCH, MESSAGE_BATCH_BUDGET);
+    if (queue.has_message()) {
+      co_yield 0ms;
+    } else {
+      co_yield 1s;
+    }
   }
 }
 
@@ -9,10 +9,13 @@
 #include "bringup/flash_target.h"
 #include "bringup/process_messages.h"
 #include "bringup/read_board_id.h"
+#include "buffer/notification.h"
 #include "hal/board/board.h"
 #include "hal/board_identification/board_ids.h"
+#include "hal/flight_recorder.h"
 #include "hal/mcu_identification/mcu_identification.h"
 #include "message/announce.h"
+#include "message/dispatcher.h"
 #include "message/leds.h"
 #include "message/message.h"
 #include "message/processor.h"
@@ -59,24 +62,20 @@ class LedControl final : public tvsc::message::Processor<tvsc::message::CanBusMe
       : led_peripheral_(std::move(led_peripheral)) {}
 
   bool process(const tvsc::message::CanBusMessage& msg) override {
-    const tvsc::message::Type type{msg.retrieve_type()};
-    if (type == tvsc::message::Type::COMMAND) {
-      const tvsc::message::Subsystem subsystem{
-          static_cast<tvsc::message::Subsystem>(msg.payload()[0])};
-      if (subsystem == tvsc::message::Subsystem::LED) {
-        if (msg.payload()[1] == 0x01) {
-          if (!led_.is_valid()) {
-            led_ = led_peripheral_.access();
-            led_.set_pin_mode(tvsc::hal::gpio::PinMode::OUTPUT_PUSH_PULL);
-          }
-          led_.write_pin(/* ON */ 1);
-        } else if (msg.payload()[1] == 0x00) {
-          if (led_.is_valid()) {
-            led_.write_pin(/* OFF */ 0);
-          }
+    tvsc::message::LedCommand command{};
+    if (msg.retrieve_type() == tvsc::message::Type::COMMAND &&
+        tvsc::message::LedCommandCodec::decode(msg, command) &&
+        command.subsystem == tvsc::message::Subsystem::LED) {
+      if (command.turn_on) {
+        if (!led_.is_valid()) {
+          led_ = led_peripheral_.access();
+          led_.set_pin_mode(tvsc::hal::gpio::PinMode::OUTPUT_PUSH_PULL);
         }
-        return true;
+        led_.write_pin(/* ON */ 1);
+      } else if (led_.is_valid()) {
+        led_.write_pin(/* OFF */ 0);
       }
+      return true;
     }
     return false;
   }
@@ -84,6 +83,7 @@ class LedControl final : public tvsc::message::Processor<tvsc::message::CanBusMe
 
 int main(int argc, char* argv[]) {
   tvsc::initialize(&argc, &argv);
+  tvsc::hal::initialize_flight_recorder();
   using Pinout = System::PinoutType;
   auto& system{System::get()};
 
@@ -103,9 +103,20 @@ int main(int argc, char* argv[]) {
 
   static constexpr size_t QUEUE_SIZE{5};
   static constexpr size_t NUM_PROCESSORS{2};
-  tvsc::message::CanBusMessageQueue<QUEUE_SIZE, NUM_PROCESSORS> can_bus_message_queue{};
+  // The queue wakes the message processing task whenever a message is enqueued.
+  tvsc::message::Queue<tvsc::message::CanBusMessage, QUEUE_SIZE, NUM_PROCESSORS,
+                       tvsc::message::QueueOrdering::FIFO, tvsc::buffer::StdFunctionNotification>
+      can_bus_message_queue{};
+
+  // Messages are routed by type and subsystem. Each route can fan out to the sniffer and one other
+  // processor.
+  static constexpr size_t PROCESSORS_PER_ROUTE{2};
+  tvsc::message::CanBusMessageDispatcher<PROCESSORS_PER_ROUTE> can_bus_message_dispatcher{};
   CanBusSniffer can_bus_sniffer{};
-  (void)can_bus_message_queue.attach_processor(can_bus_sniffer);
+  for (size_t type = 0; type < tvsc::message::NUM_TYPES; ++type) {
+    (void)can_bus_message_dispatcher.attach_processor(static_cast<tvsc::message::Type>(type),
+                                                      can_bus_sniffer);
+  }
 
   system.scheduler().add_task(
       flash_target(system.board().programmer(), system.board().debug_led()));
@@ -115,7 +126,12 @@ int main(int argc, char* argv[]) {
   system.scheduler().add_task(
       can_bus_receive(system.mcu().can<0>(), can_bus_message_queue, system.board().debug_led()));
 
-  system.scheduler().add_task(process_messages(can_bus_message_queue));
+  const size_t process_messages_task{system.scheduler().add_task(
+      process_messages(can_bus_message_queue, can_bus_message_dispatcher))};
+  can_bus_message_queue.set_message_available_callback(
+      [&system, process_messages_task](auto& /*queue*/) {
+        system.scheduler().wake_task(process_messages_task);
+      });
 
   if (board_id == static_cast<tvsc::hal::board_identification::BoardId>(
                       tvsc::hal::board_identification::CanonicalBoardIds::COMMS_BOARD_1)) {
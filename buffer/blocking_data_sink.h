@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <mutex>
 
 #include "buffer/ring_buffer.h"
@@ -8,41 +11,82 @@
 namespace tvsc::buffer {
 
 /**
- * DataSink for a RingBuffer whose read() method blocks until data is available.
+ * Consumer adapter for a RingBuffer whose read() method blocks until data is available.
  *
- * The DataSink makes it easier to consume data from a RingBuffer when it is appropriate to have a
- * thread just block and wait for the data to be available.
+ * The BlockingDataSink makes it easier to consume data from a RingBuffer when it is appropriate to
+ * have a thread just block and wait for the data, rather than spin on consume() returning zero.
+ *
+ * The sink installs itself as the RingBuffer's data available callback and sets the RingBuffer's
+ * data available threshold to the high watermark. A blocked reader is woken only once the number of
+ * elements available reaches the high watermark, or when its timeout expires, never per element.
+ * With an EDGE-triggered RingBuffer, the callback itself only runs when the occupancy crosses the
+ * high watermark. With a LEVEL-triggered RingBuffer, the callback runs after every operation, but
+ * it only takes the lock and signals when a reader is actually waiting.
+ *
+ * The RingBuffer must use the StdFunctionNotification policy, and it must outlive the sink.
  */
-template <typename ElementT, size_t BUFFER_SIZE, size_t NUM_BUFFERS>
-class BlockingDataSink final : public RingBuffer<ElementT, BUFFER_SIZE, NUM_BUFFERS>::DataSink {
+template <typename RingT>
+class BlockingDataSink final {
+ public:
+  using ElementType = typename RingT::ElementType;
+
  private:
+  RingT* ring_;
   std::mutex mutex_{};
   std::condition_variable condition_variable_{};
-  Buffer<ElementT, BUFFER_SIZE> buffer_{};
-  bool data_available_{false};
+  std::atomic<size_t> num_waiting_{0};
+  std::atomic<size_t> num_notifications_{0};
 
- public:
-  void signal_data_available() override {
-    {
-      std::unique_lock lock{mutex_};
-      data_available_ = true;
+  bool watermark_reached() const {
+    return ring_->elements_available() >= ring_->data_available_threshold();
+  }
+
+  void signal_data_available() {
+    if (num_waiting_.load() > 0) {
+      {
+        std::lock_guard lock{mutex_};
+        num_notifications_.fetch_add(1);
+      }
+      condition_variable_.notify_all();
     }
-    condition_variable_.notify_one();
   }
 
-  bool data_available() const { return data_available_; }
+ public:
+  explicit BlockingDataSink(RingT& ring) : BlockingDataSink(ring, ring.mtu()) {}
+
+  BlockingDataSink(RingT& ring, size_t high_watermark) : ring_(&ring) {
+    ring_->set_data_available_threshold(high_watermark);
+    ring_->set_data_available_callback([this](RingT& /*ring*/) { signal_data_available(); });
+  }
+
+  ~BlockingDataSink() { ring_->set_data_available_callback({}); }
 
+  BlockingDataSink(const BlockingDataSink&) = delete;
+  BlockingDataSink& operator=(const BlockingDataSink&) = delete;
+
+  size_t high_watermark() const { return ring_->data_available_threshold(); }
+
+  /**
+   * Number of times a blocked reader was signalled. Useful for verifying that wakeups are batched.
+   */
+  size_t num_notifications() const { return num_notifications_.load(); }
+
+  /**
+   * Block until the high watermark is reached or the timeout expires, then consume up to
+   * num_elements. On timeout, whatever is available, possibly nothing, is consumed.
+   *
+   * Returns the number of elements consumed.
+   */
   template <typename Rep, typename Period>
-  size_t read(size_t num_elements, ElementT* buffer,
+  size_t read(size_t num_elements, ElementType* dest,
               const std::chrono::duration<Rep, Period>& timeout) {
-    size_t elements_read{0};
-    std::unique_lock lock{mutex_};
-    condition_variable_.wait_for(lock, timeout, [this]() { return this->data_available_; });
-    if (data_available_) {
-      data_available_ = false;
-      elements_read = this->ring_buffer()->consume(buffer_.size(), buffer_.data());
+    if (!watermark_reached()) {
+      std::unique_lock lock{mutex_};
+      num_waiting_.fetch_add(1);
+      condition_variable_.wait_for(lock, timeout, [this]() { return watermark_reached(); });
+      num_waiting_.fetch_sub(1);
     }
-    return elements_read;
+    return ring_->consume_bulk(num_elements, dest);
   }
 };
 
@@ -0,0 +1,85 @@
+#include "buffer/blocking_data_sink.h"
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include "buffer/notification.h"
+#include "buffer/ring_buffer.h"
+#include "gtest/gtest.h"
+
+namespace tvsc::buffer {
+
+using namespace std::chrono_literals;
+
+using EdgeTriggeredRing =
+    RingBuffer<int, 1, 64, true, StdFunctionNotification, NotificationTrigger::EDGE>;
+
+TEST(BlockingDataSinkTest, ReadReturnsImmediatelyWhenWatermarkReached) {
+  EdgeTriggeredRing ring{};
+  BlockingDataSink sink{ring, 4};
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(ring.supply(i));
+  }
+
+  std::array<int, 8> values{};
+  EXPECT_EQ(4, sink.read(values.size(), values.data(), 10s));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(i, values[i]);
+  }
+  EXPECT_EQ(0, sink.num_notifications());
+}
+
+TEST(BlockingDataSinkTest, ReadReturnsPartialDataOnTimeout) {
+  EdgeTriggeredRing ring{};
+  BlockingDataSink sink{ring, 16};
+  ASSERT_TRUE(ring.supply(42));
+
+  std::array<int, 8> values{};
+  EXPECT_EQ(1, sink.read(values.size(), values.data(), 10ms));
+  EXPECT_EQ(42, values[0]);
+}
+
+TEST(BlockingDataSinkTest, ReadReturnsNothingOnTimeoutWhenEmpty) {
+  EdgeTriggeredRing ring{};
+  BlockingDataSink sink{ring, 16};
+
+  std::array<int, 8> values{};
+  EXPECT_EQ(0, sink.read(values.size(), values.data(), 10ms));
+}
+
+TEST(BlockingDataSinkTest, ProducerWakesReaderOncePerBatch) {
+  EdgeTriggeredRing ring{};
+  BlockingDataSink sink{ring, 16};
+
+  std::thread producer{[&ring]() {
+    std::this_thread::sleep_for(20ms);
+    for (int i = 0; i < 32; ++i) {
+      ring.supply(i);
+    }
+  }};
+
+  std::array<int, 32> values{};
+  const auto start{std::chrono::steady_clock::now()};
+  const size_t num_read{sink.read(values.size(), values.data(), 10s)};
+  const auto elapsed{std::chrono::steady_clock::now() - start};
+  producer.join();
+
+  // The reader must have been woken by the producer, not by the timeout.
+  EXPECT_LT(elapsed, 5s);
+  EXPECT_GE(num_read, 16);
+  for (size_t i = 0; i < num_read; ++i) {
+    EXPECT_EQ(static_cast<int>(i), values[i]);
+  }
+
+  // Only the crossing of the high watermark signals the reader, not each of the 32 elements.
+  EXPECT_LE(sink.num_notifications(), 1);
+}
+
+TEST(BlockingDataSinkTest, DefaultHighWatermarkIsOnePage) {
+  RingBuffer<int, 8, 4> ring{};
+  BlockingDataSink sink{ring};
+  EXPECT_EQ(8, sink.high_watermark());
+}
+
+}  // namespace tvsc::buffer
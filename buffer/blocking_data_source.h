@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+#include "buffer/ring_buffer.h"
+
+namespace tvsc::buffer {
+
+/**
+ * Producer adapter for a RingBuffer whose write() method blocks until there is space for data.
+ *
+ * The BlockingDataSource is the counterpart of BlockingDataSink. It installs itself as the
+ * RingBuffer's data needed callback. A blocked writer is woken only once the number of elements in
+ * the RingBuffer drains to the low watermark, or when its timeout expires, never per element. The
+ * RingBuffer's data needed threshold is set to the free space that corresponds to the low
+ * watermark.
+ *
+ * The RingBuffer must use the StdFunctionNotification policy, and it must outlive the source.
+ */
+template <typename RingT>
+class BlockingDataSource final {
+ public:
+  using ElementType = typename RingT::ElementType;
+
+ private:
+  RingT* ring_;
+  std::mutex mutex_{};
+  std::condition_variable condition_variable_{};
+  std::atomic<size_t> num_waiting_{0};
+  std::atomic<size_t> num_notifications_{0};
+
+  bool watermark_reached() const {
+    return ring_->max_buffered_elements() - ring_->elements_available() >=
+           ring_->data_needed_threshold();
+  }
+
+  void signal_data_needed() {
+    if (num_waiting_.load() > 0) {
+      {
+        std::lock_guard lock{mutex_};
+        num_notifications_.fetch_add(1);
+      }
+      condition_variable_.notify_all();
+    }
+  }
+
+ public:
+  explicit BlockingDataSource(RingT& ring)
+      : BlockingDataSource(ring, ring.max_buffered_elements() - ring.mtu()) {}
+
+  BlockingDataSource(RingT& ring, size_t low_watermark) : ring_(&ring) {
+    ring_->set_data_needed_threshold(ring_->max_buffered_elements() - low_watermark);
+    ring_->set_data_needed_callback([this](RingT& /*ring*/) { signal_data_needed(); });
+  }
+
+  ~BlockingDataSource() { ring_->set_data_needed_callback({}); }
+
+  BlockingDataSource(const BlockingDataSource&) = delete;
+  BlockingDataSource& operator=(const BlockingDataSource&) = delete;
+
+  size_t low_watermark() const {
+    return ring_->max_buffered_elements() - ring_->data_needed_threshold();
+  }
+
+  /**
+   * Number of times a blocked writer was signalled. Useful for verifying that wakeups are batched.
+   */
+  size_t num_notifications() const { return num_notifications_.load(); }
+
+  /**
+   * Block until the RingBuffer has drained to the low watermark or the timeout expires, then supply
+   * up to num_elements. On timeout, as many elements as fit, possibly none, are supplied.
+   *
+   * Returns the number of elements supplied.
+   */
+  template <typename Rep, typename Period>
+  size_t write(size_t num_elements, const ElementType* src,
+               const std::chrono::duration<Rep, Period>& timeout) {
+    if (!watermark_reached()) {
+      std::unique_lock lock{mutex_};
+      num_waiting_.fetch_add(1);
+      condition_variable_.wait_for(lock, timeout, [this]() { return watermark_reached(); });
+      num_waiting_.fetch_sub(1);
+    }
+    return ring_->supply_bulk(num_elements, src);
+  }
+};
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,72 @@
+#include "buffer/blocking_data_source.h"
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include "buffer/notification.h"
+#include "buffer/ring_buffer.h"
+#include "gtest/gtest.h"
+
+namespace tvsc::buffer {
+
+using namespace std::chrono_literals;
+
+using EdgeTriggeredRing =
+    RingBuffer<int, 1, 64, true, StdFunctionNotification, NotificationTrigger::EDGE>;
+
+TEST(BlockingDataSourceTest, WriteReturnsImmediatelyWhenSpaceAvailable) {
+  EdgeTriggeredRing ring{};
+  BlockingDataSource source{ring, 16};
+
+  std::array<int, 8> values{1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_EQ(8, source.write(values.size(), values.data(), 10s));
+  EXPECT_EQ(8, ring.elements_available());
+  EXPECT_EQ(0, source.num_notifications());
+}
+
+TEST(BlockingDataSourceTest, WriteSuppliesWhatFitsOnTimeout) {
+  EdgeTriggeredRing ring{};
+  BlockingDataSource source{ring, 16};
+
+  std::array<int, 64> values{};
+  ASSERT_EQ(60, ring.supply_bulk(60, values.data()));
+
+  EXPECT_EQ(4, source.write(values.size(), values.data(), 10ms));
+  EXPECT_TRUE(ring.full());
+}
+
+TEST(BlockingDataSourceTest, ConsumerWakesWriterAtLowWatermark) {
+  EdgeTriggeredRing ring{};
+  BlockingDataSource source{ring, 16};
+
+  std::array<int, 64> values{};
+  ASSERT_EQ(64, ring.supply_bulk(values.size(), values.data()));
+
+  std::thread consumer{[&ring]() {
+    std::this_thread::sleep_for(20ms);
+    int value{};
+    while (ring.consume(&value)) {
+    }
+  }};
+
+  const auto start{std::chrono::steady_clock::now()};
+  const size_t num_written{source.write(32, values.data(), 10s)};
+  const auto elapsed{std::chrono::steady_clock::now() - start};
+  consumer.join();
+
+  // The writer must have been woken by the consumer, not by the timeout.
+  EXPECT_LT(elapsed, 5s);
+  EXPECT_EQ(32, num_written);
+
+  // Only the crossing of the low watermark signals the writer, not each of the 64 elements.
+  EXPECT_LE(source.num_notifications(), 1);
+}
+
+TEST(BlockingDataSourceTest, DefaultLowWatermarkLeavesSpaceForOnePage) {
+  RingBuffer<int, 8, 4> ring{};
+  BlockingDataSource source{ring};
+  EXPECT_EQ(24, source.low_watermark());
+}
+
+}  // namespace tvsc::buffer
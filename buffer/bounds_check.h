@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "base/except.h"
+
+namespace tvsc::buffer {
+
+/**
+ * Policy for validating indices into a BufferT or a BufferView.
+ *
+ * - ALWAYS: every access, single element or bulk, is checked. This is the default.
+ * - DEBUG_ONLY: accesses are checked only in builds without NDEBUG.
+ * - BULK_ONLY: bulk operations (read/write of ranges, copy_from(), as_string_view()) are checked,
+ *   since the check is paid once per range. Single element accesses via operator[], read(index)
+ *   and write(index, element) are not checked. Those are the accesses made inside per-element
+ *   loops on the hot path.
+ *
+ * The default for all Buffers can be changed at build time by defining
+ * BUFFER_BOUNDS_CHECK_DEBUG_ONLY or BUFFER_BOUNDS_CHECK_BULK_ONLY. A single Buffer can choose its
+ * own policy via its template parameters.
+ */
+enum class BoundsCheck : uint8_t {
+  ALWAYS,
+  DEBUG_ONLY,
+  BULK_ONLY,
+};
+
+#if defined(BUFFER_BOUNDS_CHECK_DEBUG_ONLY)
+inline constexpr BoundsCheck DEFAULT_BOUNDS_CHECK{BoundsCheck::DEBUG_ONLY};
+#elif defined(BUFFER_BOUNDS_CHECK_BULK_ONLY)
+inline constexpr BoundsCheck DEFAULT_BOUNDS_CHECK{BoundsCheck::BULK_ONLY};
+#else
+inline constexpr BoundsCheck DEFAULT_BOUNDS_CHECK{BoundsCheck::ALWAYS};
+#endif
+
+namespace internal {
+
+template <BoundsCheck BOUNDS_CHECK>
+struct BoundsCheckTraits final {
+#ifdef NDEBUG
+  static constexpr bool IS_DEBUG_BUILD{false};
+#else
+  static constexpr bool IS_DEBUG_BUILD{true};
+#endif
+
+  static constexpr bool CHECK_BULK{BOUNDS_CHECK != BoundsCheck::DEBUG_ONLY || IS_DEBUG_BUILD};
+  static constexpr bool CHECK_ELEMENT{BOUNDS_CHECK == BoundsCheck::ALWAYS ||
+                                      (BOUNDS_CHECK == BoundsCheck::DEBUG_ONLY && IS_DEBUG_BUILD)};
+};
+
+/**
+ * Out of line, so that building the exception message does not get inlined into every access.
+ */
+[[gnu::cold]] [[gnu::noinline]] inline void throw_invalid_index(size_t index, size_t num_elements) {
+  using std::to_string;
+  except<std::out_of_range>("Invalid index " + to_string(index) +
+                            " (NUM_ELEMENTS: " + to_string(num_elements) + ")");
+}
+
+}  // namespace internal
+
+}  // namespace tvsc::buffer
@@ -1,17 +1,62 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <cstring>
 #include <iomanip>
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "base/except.h"
+#include "buffer/bounds_check.h"
+#include "buffer/buffer_view.h"
 
 namespace tvsc::buffer {
 
+namespace internal {
+
+/**
+ * Fill count trivially copyable elements at dest with value. If every byte of value is the same,
+ * as with a zero value, this is a single memset(3). Otherwise, the first element is assigned, and
+ * then the filled prefix is doubled with memcpy(3) until the range is full, which takes O(log n)
+ * calls, each of which can use the widest copies that the platform supports.
+ */
+template <typename ElementT>
+void fill_trivially_copyable(ElementT* dest, size_t count, const ElementT& value) {
+  if (count == 0) {
+    return;
+  }
+  const unsigned char* value_bytes{reinterpret_cast<const unsigned char*>(&value)};
+  bool all_bytes_equal{true};
+  for (size_t i = 1; i < sizeof(ElementT); ++i) {
+    if (value_bytes[i] != value_bytes[0]) {
+      all_bytes_equal = false;
+      break;
+    }
+  }
+  if (all_bytes_equal) {
+    std::memset(static_cast<void*>(dest), value_bytes[0], count * sizeof(ElementT));
+    return;
+  }
+
+  dest[0] = value;
+  size_t filled{1};
+  while (filled < count) {
+    const size_t to_copy{std::min(filled, count - filled)};
+    std::memcpy(static_cast<void*>(dest + filled), static_cast<const void*>(dest),
+                to_copy * sizeof(ElementT));
+    filled += to_copy;
+  }
+}
+
+}  // namespace internal
+
 /**
  * std::array-like buffer type with bounds checking and bulk operations for trivially copyable
  * (https://en.cppreference.com/w/cpp/named_req/TriviallyCopyable) types. If a type is trivially
@@ -27,52 +72,72 @@ namespace tvsc::buffer {
  *
  * The Buffer type makes the syntax of choosing the correct BufferT template overload easier. It is
  * defined after the two template overloads.
+ *
+ * BOUNDS_CHECK selects which accesses are validated. See BoundsCheck in buffer/bounds_check.h.
  */
-template <typename ElementT, size_t NUM_ELEMENTS, bool is_trivially_copyable>
+template <typename ElementT, size_t NUM_ELEMENTS, bool is_trivially_copyable,
+          BoundsCheck BOUNDS_CHECK = DEFAULT_BOUNDS_CHECK>
 class BufferT final {
  private:
   static_assert(NUM_ELEMENTS > 0, "Number of elements in the buffer must be positive");
 
   ElementT elements_[NUM_ELEMENTS]{};
 
-  void validate_index(size_t index) const {
-    if (index < 0 || index >= NUM_ELEMENTS) {
-      using std::to_string;
-      except<std::out_of_range>("Invalid index " + to_string(index) +
-                                " (NUM_ELEMENTS: " + to_string(NUM_ELEMENTS));
+  using Traits = internal::BoundsCheckTraits<BOUNDS_CHECK>;
+
+  static void validate_index(size_t index) {
+    if (index >= NUM_ELEMENTS) {
+      internal::throw_invalid_index(index, NUM_ELEMENTS);
+    }
+  }
+
+  static void validate_element(size_t index) {
+    if constexpr (Traits::CHECK_ELEMENT) {
+      validate_index(index);
     }
   }
 
-  template <typename, size_t, bool>
+  static void validate_range(size_t offset, size_t count) {
+    if constexpr (Traits::CHECK_BULK) {
+      validate_index(offset);
+      validate_index(offset + count - 1);
+    }
+  }
+
+  template <typename, size_t, bool, BoundsCheck>
   friend class BufferT;
 
  public:
   constexpr size_t size() const { return NUM_ELEMENTS; }
   constexpr size_t max_size() const { return NUM_ELEMENTS; }
 
-  void clear() {
-    ElementT default_element{};
-    for (size_t i = 0; i < NUM_ELEMENTS; ++i) {
-      operator[](i) = default_element;
-    }
-  }
+  void clear() { fill(ElementT{}); }
+
+  void fill(const ElementT& value) { std::fill(elements_, elements_ + NUM_ELEMENTS, value); }
 
   const ElementT& read(size_t index) const { return operator[](index); }
 
   void read_array(size_t offset, size_t count, ElementT dest[]) const {
-    validate_index(offset);
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
     for (size_t i = 0; i < count; ++i) {
-      dest[i] = operator[](i + offset);
+      dest[i] = elements_[i + offset];
     }
   }
 
   template <typename DestT>
   void read(size_t offset, size_t count, DestT& dest) const {
-    validate_index(offset);
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
     for (size_t i = 0; i < count; ++i) {
-      dest[i] = operator[](i + offset);
+      dest[i] = elements_[i + offset];
+    }
+  }
+
+  /**
+   * Read dest.size() elements, starting at offset, into the elements viewed by dest.
+   */
+  void read(size_t offset, BufferView<ElementT> dest) const {
+    if (!dest.empty()) {
+      read(offset, dest.size(), dest);
     }
   }
 
@@ -81,35 +146,103 @@ class BufferT final {
   void write(size_t index, ElementT&& element) { operator[](index) = std::move(element); }
 
   void write_array(size_t offset, size_t count, const ElementT src[]) {
-    validate_index(offset);
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
+    for (size_t i = 0; i < count; ++i) {
+      elements_[i + offset] = src[i];
+    }
+  }
+
+  /**
+   * Move count elements, starting at offset, into dest. Each element in this buffer is then reset
+   * to a default constructed element, so that it releases any resources that it held.
+   */
+  void move_out_array(size_t offset, size_t count, ElementT dest[]) {
+    validate_range(offset, count);
+    for (size_t i = 0; i < count; ++i) {
+      dest[i] = std::move(elements_[i + offset]);
+      if constexpr (!std::is_trivially_destructible_v<ElementT>) {
+        elements_[i + offset] = ElementT{};
+      }
+    }
+  }
+
+  /**
+   * Move count elements from src into this buffer, starting at offset.
+   */
+  void move_in_array(size_t offset, size_t count, ElementT src[]) {
+    validate_range(offset, count);
     for (size_t i = 0; i < count; ++i) {
-      operator[](i + offset) = src[i];
+      elements_[i + offset] = std::move(src[i]);
+    }
+  }
+
+  /**
+   * Replace the element at index with one constructed in place from args.
+   */
+  template <typename... Args>
+  ElementT& emplace(size_t index, Args&&... args) {
+    validate_element(index);
+    ElementT* element{elements_ + index};
+    if constexpr (std::is_nothrow_constructible_v<ElementT, Args...>) {
+      std::destroy_at(element);
+      return *std::construct_at(element, std::forward<Args>(args)...);
+    } else {
+      // Construct a temporary first so that the existing element is intact if construction throws.
+      *element = ElementT(std::forward<Args>(args)...);
+      return *element;
     }
   }
 
   template <typename SrcT>
   void write(size_t offset, size_t count, const SrcT& src) {
-    validate_index(offset);
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
+    for (size_t i = 0; i < count; ++i) {
+      elements_[i + offset] = src[i];
+    }
+  }
+
+  /**
+   * Write the elements viewed by src into this buffer, starting at offset.
+   */
+  void write(size_t offset, BufferView<const ElementT> src) {
+    if (!src.empty()) {
+      write(offset, src.size(), src);
+    }
+  }
+
+  /**
+   * Copy count elements directly from another buffer, starting at src_offset in src, into this
+   * buffer, starting at offset. The two ranges must not overlap.
+   */
+  template <size_t SRC_NUM_ELEMENTS, BoundsCheck SRC_BOUNDS_CHECK>
+  void copy_from(
+      size_t offset,
+      const BufferT<ElementT, SRC_NUM_ELEMENTS, is_trivially_copyable, SRC_BOUNDS_CHECK>& src,
+      size_t src_offset, size_t count) {
+    if (count == 0) {
+      return;
+    }
+    validate_range(offset, count);
+    src.validate_range(src_offset, count);
     for (size_t i = 0; i < count; ++i) {
-      operator[](i + offset) = src[i];
+      elements_[i + offset] = src.elements_[i + src_offset];
     }
   }
 
   const ElementT& operator[](size_t index) const {
-    validate_index(index);
+    validate_element(index);
     return elements_[index];
   }
 
   ElementT& operator[](size_t index) {
-    validate_index(index);
+    validate_element(index);
     return elements_[index];
   }
 
-  template <size_t RHS_NUM_ELEMENTS>
-  int compare(const BufferT<ElementT, RHS_NUM_ELEMENTS, is_trivially_copyable>& rhs,
-              size_t count = std::numeric_limits<size_t>::max()) const {
+  template <size_t RHS_NUM_ELEMENTS, BoundsCheck RHS_BOUNDS_CHECK>
+  int compare(
+      const BufferT<ElementT, RHS_NUM_ELEMENTS, is_trivially_copyable, RHS_BOUNDS_CHECK>& rhs,
+      size_t count = std::numeric_limits<size_t>::max()) const {
     if constexpr (RHS_NUM_ELEMENTS < NUM_ELEMENTS) {
       for (size_t i = 0; i < std::min(RHS_NUM_ELEMENTS, count); ++i) {
         if (elements_[i] < rhs.elements_[i]) {
@@ -131,84 +264,114 @@ class BufferT final {
     }
   }
 
-  template <size_t RHS_NUM_ELEMENTS>
-  bool is_equal(const BufferT<ElementT, RHS_NUM_ELEMENTS, is_trivially_copyable>& rhs,
-                size_t count = std::numeric_limits<size_t>::max()) const {
+  template <size_t RHS_NUM_ELEMENTS, BoundsCheck RHS_BOUNDS_CHECK>
+  bool is_equal(
+      const BufferT<ElementT, RHS_NUM_ELEMENTS, is_trivially_copyable, RHS_BOUNDS_CHECK>& rhs,
+      size_t count = std::numeric_limits<size_t>::max()) const {
     return compare(rhs, count) == 0;
   }
 
-  template <size_t RHS_NUM_ELEMENTS>
-  bool operator==(const BufferT<ElementT, RHS_NUM_ELEMENTS, is_trivially_copyable>& rhs) const {
+  template <size_t RHS_NUM_ELEMENTS, BoundsCheck RHS_BOUNDS_CHECK>
+  bool operator==(
+      const BufferT<ElementT, RHS_NUM_ELEMENTS, is_trivially_copyable, RHS_BOUNDS_CHECK>& rhs)
+      const {
     return compare(rhs) == 0;
   }
 
-  template <size_t RHS_NUM_ELEMENTS>
-  bool operator!=(const BufferT<ElementT, RHS_NUM_ELEMENTS, is_trivially_copyable>& rhs) const {
+  template <size_t RHS_NUM_ELEMENTS, BoundsCheck RHS_BOUNDS_CHECK>
+  bool operator!=(
+      const BufferT<ElementT, RHS_NUM_ELEMENTS, is_trivially_copyable, RHS_BOUNDS_CHECK>& rhs)
+      const {
     return compare(rhs) != 0;
   }
 
   constexpr ElementT* data() noexcept { return elements_; }
   constexpr const ElementT* data() const noexcept { return elements_; }
 
+  /**
+   * Non-owning views of the buffer's elements. See BufferView.
+   */
+  BufferView<ElementT> view() { return BufferView<ElementT>{elements_, NUM_ELEMENTS}; }
+  BufferView<const ElementT> view() const {
+    return BufferView<const ElementT>{elements_, NUM_ELEMENTS};
+  }
+  BufferView<ElementT> view(size_t offset, size_t count) { return view().subview(offset, count); }
+  BufferView<const ElementT> view(size_t offset, size_t count) const {
+    return view().subview(offset, count);
+  }
+
   constexpr std::string_view as_string_view() const {
     return std::string_view(reinterpret_cast<const char*>(elements_),
                             NUM_ELEMENTS * sizeof(ElementT));
   }
 
   constexpr std::string_view as_string_view(size_t count) const {
-    validate_index(count - 1);
+    validate_range(0, count);
     return std::string_view(reinterpret_cast<const char*>(elements_), count * sizeof(ElementT));
   }
 
   constexpr std::string_view as_string_view(size_t offset, size_t count) const {
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
     return std::string_view(reinterpret_cast<const char*>(elements_ + offset),
                             count * sizeof(ElementT));
   }
 };
 
 // BufferT implementation for trivially copyable ElementT types.
-template <typename ElementT, size_t NUM_ELEMENTS>
-class BufferT<ElementT, NUM_ELEMENTS, true> final {
+template <typename ElementT, size_t NUM_ELEMENTS, BoundsCheck BOUNDS_CHECK>
+class BufferT<ElementT, NUM_ELEMENTS, true, BOUNDS_CHECK> final {
  private:
   static_assert(NUM_ELEMENTS > 0, "Number of elements in the buffer must be positive");
 
   ElementT elements_[NUM_ELEMENTS];
 
-  void validate_index(size_t index) const {
-    if (index < 0 || index >= NUM_ELEMENTS) {
-      using std::to_string;
-      except<std::out_of_range>("Invalid index " + to_string(index) +
-                                " (NUM_ELEMENTS: " + to_string(NUM_ELEMENTS) + ")");
+  using Traits = internal::BoundsCheckTraits<BOUNDS_CHECK>;
+
+  static void validate_index(size_t index) {
+    if (index >= NUM_ELEMENTS) {
+      internal::throw_invalid_index(index, NUM_ELEMENTS);
+    }
+  }
+
+  static void validate_element(size_t index) {
+    if constexpr (Traits::CHECK_ELEMENT) {
+      validate_index(index);
     }
   }
 
+  static void validate_range(size_t offset, size_t count) {
+    if constexpr (Traits::CHECK_BULK) {
+      validate_index(offset);
+      validate_index(offset + count - 1);
+    }
+  }
+
+  template <typename, size_t, bool, BoundsCheck>
+  friend class BufferT;
+
  public:
   constexpr size_t size() const { return NUM_ELEMENTS; }
   constexpr size_t max_size() const { return NUM_ELEMENTS; }
 
-  void clear() {
-    // ElementT is trivially copyable, but that does not mean that we can just memset the elements_
-    // array to zero. We could however do increasingly sized memcpy's of a default initialized
-    // element for an O(ln n) process. For now, we assume that an O(n) clear() is sufficient.
-    ElementT default_element{};
-    for (size_t i = 0; i < NUM_ELEMENTS; ++i) {
-      operator[](i) = default_element;
-    }
+  // ElementT is trivially copyable, but that does not mean that we can just memset the elements_
+  // array to zero; a default initialized ElementT need not be all zero bytes. fill() memsets only
+  // when every byte of the value is the same, and otherwise uses increasingly sized memcpy's.
+  void clear() { fill(ElementT{}); }
+
+  void fill(const ElementT& value) {
+    internal::fill_trivially_copyable(elements_, NUM_ELEMENTS, value);
   }
 
   const ElementT& read(size_t index) const { return operator[](index); }
 
   void read_array(size_t offset, size_t count, ElementT dest[]) const {
-    validate_index(offset);
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
     std::memcpy(dest, elements_ + offset, count * sizeof(ElementT));
   }
 
   template <typename DestT>
   void read(size_t offset, size_t count, DestT& dest) const {
-    validate_index(offset);
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
     if (dest.max_size() < count) {
       using std::to_string;
       except<std::overflow_error>("dest has insufficient space (" + to_string(count) + " vs " +
@@ -218,20 +381,43 @@ class BufferT<ElementT, NUM_ELEMENTS, true> final {
     std::memcpy(dest.data(), elements_ + offset, count * sizeof(ElementT));
   }
 
+  /**
+   * Read dest.size() elements, starting at offset, into the elements viewed by dest.
+   */
+  void read(size_t offset, BufferView<ElementT> dest) const {
+    if (!dest.empty()) {
+      read(offset, dest.size(), dest);
+    }
+  }
+
   void write(size_t index, const ElementT& element) { operator[](index) = element; }
 
   void write(size_t index, ElementT&& element) { operator[](index) = std::move(element); }
 
   void write_array(size_t offset, size_t count, const ElementT src[]) {
-    validate_index(offset);
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
     std::memcpy(elements_ + offset, src, count * sizeof(ElementT));
   }
 
+  // Moving a trivially copyable element is a copy, so these are the same memcpy(3) as read_array()
+  // and write_array(). They exist so that generic code can move elements out of and into any
+  // buffer.
+  void move_out_array(size_t offset, size_t count, ElementT dest[]) {
+    read_array(offset, count, dest);
+  }
+
+  void move_in_array(size_t offset, size_t count, ElementT src[]) {
+    write_array(offset, count, src);
+  }
+
+  template <typename... Args>
+  ElementT& emplace(size_t index, Args&&... args) {
+    return operator[](index) = ElementT(std::forward<Args>(args)...);
+  }
+
   template <typename SrcT>
   void write(size_t offset, size_t count, const SrcT& src) {
-    validate_index(offset);
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
     if (src.max_size() < count) {
       using std::to_string;
       except<std::overflow_error>("src has insufficient space (" + to_string(count) + " vs " +
@@ -240,18 +426,43 @@ class BufferT<ElementT, NUM_ELEMENTS, true> final {
     std::memcpy(elements_ + offset, src.data(), count * sizeof(ElementT));
   }
 
+  /**
+   * Write the elements viewed by src into this buffer, starting at offset.
+   */
+  void write(size_t offset, BufferView<const ElementT> src) {
+    if (!src.empty()) {
+      write(offset, src.size(), src);
+    }
+  }
+
+  /**
+   * Copy count elements directly from another buffer, starting at src_offset in src, into this
+   * buffer, starting at offset. The two ranges must not overlap.
+   */
+  template <size_t SRC_NUM_ELEMENTS, BoundsCheck SRC_BOUNDS_CHECK>
+  void copy_from(size_t offset,
+                 const BufferT<ElementT, SRC_NUM_ELEMENTS, true, SRC_BOUNDS_CHECK>& src,
+                 size_t src_offset, size_t count) {
+    if (count == 0) {
+      return;
+    }
+    validate_range(offset, count);
+    src.validate_range(src_offset, count);
+    std::memcpy(elements_ + offset, src.elements_ + src_offset, count * sizeof(ElementT));
+  }
+
   const ElementT& operator[](size_t index) const {
-    validate_index(index);
+    validate_element(index);
     return elements_[index];
   }
 
   ElementT& operator[](size_t index) {
-    validate_index(index);
+    validate_element(index);
     return elements_[index];
   }
 
-  template <size_t RHS_NUM_ELEMENTS>
-  int compare(const BufferT<ElementT, RHS_NUM_ELEMENTS, true>& rhs,
+  template <size_t RHS_NUM_ELEMENTS, BoundsCheck RHS_BOUNDS_CHECK>
+  int compare(const BufferT<ElementT, RHS_NUM_ELEMENTS, true, RHS_BOUNDS_CHECK>& rhs,
               size_t count = std::numeric_limits<size_t>::max()) const {
     if constexpr (RHS_NUM_ELEMENTS < NUM_ELEMENTS) {
       return std::memcmp(elements_, rhs.elements_,
@@ -262,44 +473,58 @@ class BufferT<ElementT, NUM_ELEMENTS, true> final {
     }
   }
 
-  template <size_t RHS_NUM_ELEMENTS>
-  bool is_equal(const BufferT<ElementT, RHS_NUM_ELEMENTS, true>& rhs,
+  template <size_t RHS_NUM_ELEMENTS, BoundsCheck RHS_BOUNDS_CHECK>
+  bool is_equal(const BufferT<ElementT, RHS_NUM_ELEMENTS, true, RHS_BOUNDS_CHECK>& rhs,
                 size_t count = std::numeric_limits<size_t>::max()) const {
     return compare(rhs, count) == 0;
   }
 
-  template <size_t RHS_NUM_ELEMENTS>
-  bool operator==(const BufferT<ElementT, RHS_NUM_ELEMENTS, true>& rhs) const {
+  template <size_t RHS_NUM_ELEMENTS, BoundsCheck RHS_BOUNDS_CHECK>
+  bool operator==(const BufferT<ElementT, RHS_NUM_ELEMENTS, true, RHS_BOUNDS_CHECK>& rhs) const {
     return compare(rhs) == 0;
   }
 
-  template <size_t RHS_NUM_ELEMENTS>
-  bool operator!=(const BufferT<ElementT, RHS_NUM_ELEMENTS, true>& rhs) const {
+  template <size_t RHS_NUM_ELEMENTS, BoundsCheck RHS_BOUNDS_CHECK>
+  bool operator!=(const BufferT<ElementT, RHS_NUM_ELEMENTS, true, RHS_BOUNDS_CHECK>& rhs) const {
     return compare(rhs) != 0;
   }
 
   constexpr ElementT* data() noexcept { return elements_; }
   constexpr const ElementT* data() const noexcept { return elements_; }
 
+  /**
+   * Non-owning views of the buffer's elements. See BufferView.
+   */
+  BufferView<ElementT> view() { return BufferView<ElementT>{elements_, NUM_ELEMENTS}; }
+  BufferView<const ElementT> view() const {
+    return BufferView<const ElementT>{elements_, NUM_ELEMENTS};
+  }
+  BufferView<ElementT> view(size_t offset, size_t count) { return view().subview(offset, count); }
+  BufferView<const ElementT> view(size_t offset, size_t count) const {
+    return view().subview(offset, count);
+  }
+
   constexpr std::string_view as_string_view() const {
     return std::string_view(reinterpret_cast<const char*>(elements_),
                             NUM_ELEMENTS * sizeof(ElementT));
   }
 
   constexpr std::string_view as_string_view(size_t count) const {
-    validate_index(count - 1);
+    validate_range(0, count);
     return std::string_view(reinterpret_cast<const char*>(elements_), count * sizeof(ElementT));
   }
 
   constexpr std::string_view as_string_view(size_t offset, size_t count) const {
-    validate_index(offset + count - 1);
+    validate_range(offset, count);
     return std::string_view(reinterpret_cast<const char*>(elements_ + offset),
                             count * sizeof(ElementT));
   }
 };
 
-template <typename ElementT, size_t NUM_ELEMENTS, bool is_trivially_copyable>
-std::string to_string(const BufferT<ElementT, NUM_ELEMENTS, is_trivially_copyable>& buffer) {
+template <typename ElementT, size_t NUM_ELEMENTS, bool is_trivially_copyable,
+          BoundsCheck BOUNDS_CHECK>
+std::string to_string(
+    const BufferT<ElementT, NUM_ELEMENTS, is_trivially_copyable, BOUNDS_CHECK>& buffer) {
   using std::to_string;
   std::string result{};
   static constexpr size_t ROW_SIZE{10};
@@ -312,8 +537,8 @@ std::string to_string(const BufferT<ElementT, NUM_ELEMENTS, is_trivially_copyabl
   return result;
 }
 
-template <size_t NUM_ELEMENTS>
-std::string to_string(const BufferT<uint8_t, NUM_ELEMENTS, true>& buffer) {
+template <size_t NUM_ELEMENTS, BoundsCheck BOUNDS_CHECK>
+std::string to_string(const BufferT<uint8_t, NUM_ELEMENTS, true, BOUNDS_CHECK>& buffer) {
   std::ostringstream ss;
   static constexpr size_t ROW_SIZE{10};
   for (size_t i = 0; i < NUM_ELEMENTS; i += ROW_SIZE) {
@@ -327,7 +552,8 @@ std::string to_string(const BufferT<uint8_t, NUM_ELEMENTS, true>& buffer) {
   return ss.str();
 }
 
-template <typename ElementT, size_t NUM_ELEMENTS>
-using Buffer = BufferT<ElementT, NUM_ELEMENTS, std::is_trivially_copyable<ElementT>::value>;
+template <typename ElementT, size_t NUM_ELEMENTS, BoundsCheck BOUNDS_CHECK = DEFAULT_BOUNDS_CHECK>
+using Buffer =
+    BufferT<ElementT, NUM_ELEMENTS, std::is_trivially_copyable<ElementT>::value, BOUNDS_CHECK>;
 
 }  // namespace tvsc::buffer
@@ -0,0 +1,308 @@
+/**
+ * Benchmarks for the buffer package.
+ *
+ * These benchmarks are intended to guide the choice of PAGE_SIZE and NUM_PAGES for RingBuffer and
+ * the sizing of Buffer instances. To record results in a machine-readable form for comparison
+ * between releases, run with
+ *
+ *   bazel run -c opt //buffer:buffer_benchmark -- --benchmark_out=buffer_benchmark.json \
+ *       --benchmark_out_format=json
+ *
+ * The latency benchmarks report percentiles as the counters p50_ns, p90_ns, p99_ns and p999_ns.
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "buffer/buffer.h"
+#include "buffer/mpmc_ring_buffer.h"
+#include "buffer/ring_buffer.h"
+
+namespace tvsc::buffer {
+
+/**
+ * Trivially copyable element roughly the size of a radio fragment.
+ */
+struct Payload64 final {
+  std::array<uint8_t, 64> bytes{};
+};
+
+/**
+ * Records per-operation latencies and reports their percentiles as benchmark counters.
+ */
+class LatencyRecorder final {
+ private:
+  static constexpr size_t MAX_SAMPLES{1 << 20};
+
+  std::vector<int64_t> samples_{};
+
+ public:
+  LatencyRecorder() { samples_.reserve(MAX_SAMPLES); }
+
+  template <typename Fn>
+  void measure(Fn&& fn) {
+    const auto start{std::chrono::steady_clock::now()};
+    fn();
+    const auto end{std::chrono::steady_clock::now()};
+    if (samples_.size() < MAX_SAMPLES) {
+      samples_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+  }
+
+  void report(benchmark::State& state) {
+    if (samples_.empty()) {
+      return;
+    }
+    std::sort(samples_.begin(), samples_.end());
+    const auto percentile = [this](double p) {
+      return static_cast<double>(samples_[static_cast<size_t>(p * (samples_.size() - 1))]);
+    };
+    state.counters["p50_ns"] = percentile(0.50);
+    state.counters["p90_ns"] = percentile(0.90);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p999_ns"] = percentile(0.999);
+  }
+};
+
+template <typename ElementT, size_t PAGE_SIZE, size_t NUM_PAGES, bool PRIORITIZE_OLD_ELEMENTS,
+          bool WITH_CALLBACKS>
+struct RingConfig final {
+  using ElementType = ElementT;
+  using RingType = RingBuffer<ElementT, PAGE_SIZE, NUM_PAGES, PRIORITIZE_OLD_ELEMENTS>;
+  static constexpr size_t page_size{PAGE_SIZE};
+  static constexpr bool with_callbacks{WITH_CALLBACKS};
+};
+
+template <typename ConfigT>
+void connect_callbacks(typename ConfigT::RingType& ring, int64_t& callback_count) {
+  if constexpr (ConfigT::with_callbacks) {
+    ring.set_data_needed_callback(
+        [&callback_count](typename ConfigT::RingType& /*ring*/) { ++callback_count; });
+    ring.set_data_available_callback(
+        [&callback_count](typename ConfigT::RingType& /*ring*/) { ++callback_count; });
+  }
+}
+
+/**
+ * Single-threaded throughput: supply a page, then consume a page.
+ */
+template <typename ConfigT>
+void BM_RingBufferThroughput(benchmark::State& state) {
+  using ElementType = typename ConfigT::ElementType;
+  // The rings can be large. Keep them off of the stack.
+  static typename ConfigT::RingType ring{};
+  int64_t callback_count{0};
+  connect_callbacks<ConfigT>(ring, callback_count);
+
+  Buffer<ElementType, ConfigT::page_size> src{};
+  Buffer<ElementType, ConfigT::page_size> dest{};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ring.supply(ConfigT::page_size, src.data()));
+    benchmark::DoNotOptimize(ring.consume(ConfigT::page_size, dest.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * ConfigT::page_size);
+  state.SetBytesProcessed(state.iterations() * ConfigT::page_size * sizeof(ElementType));
+  state.counters["callbacks"] = benchmark::Counter(static_cast<double>(callback_count),
+                                                   benchmark::Counter::kAvgIterations);
+
+  ring.set_data_needed_callback({});
+  ring.set_data_available_callback({});
+}
+
+/**
+ * Single-threaded latency of individual supply() and consume() calls of a page each.
+ */
+template <typename ConfigT>
+void BM_RingBufferLatency(benchmark::State& state) {
+  using ElementType = typename ConfigT::ElementType;
+  static typename ConfigT::RingType ring{};
+  int64_t callback_count{0};
+  connect_callbacks<ConfigT>(ring, callback_count);
+
+  Buffer<ElementType, ConfigT::page_size> src{};
+  Buffer<ElementType, ConfigT::page_size> dest{};
+  LatencyRecorder recorder{};
+  for (auto _ : state) {
+    recorder.measure([&]() { ring.supply(ConfigT::page_size, src.data()); });
+    recorder.measure([&]() { ring.consume(ConfigT::page_size, dest.data()); });
+    benchmark::ClobberMemory();
+  }
+  recorder.report(state);
+
+  ring.set_data_needed_callback({});
+  ring.set_data_available_callback({});
+}
+
+/**
+ * Producer/consumer throughput across threads. Even numbered threads produce and odd numbered
+ * threads consume. Each iteration makes a single, non-blocking attempt to transfer a page. Only the
+ * elements that consumers receive are counted, since supplied elements may be refused or, with
+ * PRIORITIZE_OLD_ELEMENTS false, overwritten before they are consumed.
+ */
+template <typename ConfigT>
+void BM_RingBufferThreaded(benchmark::State& state) {
+  using ElementType = typename ConfigT::ElementType;
+  static typename ConfigT::RingType ring{};
+
+  const bool is_producer{state.thread_index() % 2 == 0};
+  Buffer<ElementType, ConfigT::page_size> page{};
+  int64_t elements_consumed{0};
+  for (auto _ : state) {
+    if (is_producer) {
+      ring.supply(ConfigT::page_size, page.data());
+    } else {
+      elements_consumed += ring.consume(ConfigT::page_size, page.data());
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(elements_consumed);
+}
+
+template <typename ElementT, size_t CAPACITY>
+void BM_MpmcRingBufferThreaded(benchmark::State& state) {
+  static MpmcRingBuffer<ElementT, CAPACITY> ring{};
+
+  const bool is_producer{state.thread_index() % 2 == 0};
+  ElementT element{};
+  int64_t elements_consumed{0};
+  for (auto _ : state) {
+    if (is_producer) {
+      ring.supply(element);
+    } else {
+      elements_consumed += ring.consume(&element) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(element);
+  }
+  state.SetItemsProcessed(elements_consumed);
+}
+
+#define RING_BUFFER_BENCHMARKS(ConfigT)                        \
+  BENCHMARK_TEMPLATE(BM_RingBufferThroughput, ConfigT);        \
+  BENCHMARK_TEMPLATE(BM_RingBufferLatency, ConfigT);           \
+  BENCHMARK_TEMPLATE(BM_RingBufferThreaded, ConfigT)->Threads(2)->UseRealTime()
+
+// Page geometries with a fixed element type and a fixed total capacity of 1024 elements.
+using Geometry1x1024 = RingConfig<uint32_t, 1, 1024, true, false>;
+using Geometry16x64 = RingConfig<uint32_t, 16, 64, true, false>;
+using Geometry64x16 = RingConfig<uint32_t, 64, 16, true, false>;
+using Geometry256x4 = RingConfig<uint32_t, 256, 4, true, false>;
+RING_BUFFER_BENCHMARKS(Geometry1x1024);
+RING_BUFFER_BENCHMARKS(Geometry16x64);
+RING_BUFFER_BENCHMARKS(Geometry64x16);
+RING_BUFFER_BENCHMARKS(Geometry256x4);
+
+// Element types.
+using Uint8Elements = RingConfig<uint8_t, 64, 16, true, false>;
+using Uint64Elements = RingConfig<uint64_t, 64, 16, true, false>;
+using Payload64Elements = RingConfig<Payload64, 64, 16, true, false>;
+RING_BUFFER_BENCHMARKS(Uint8Elements);
+RING_BUFFER_BENCHMARKS(Uint64Elements);
+RING_BUFFER_BENCHMARKS(Payload64Elements);
+
+// Overflow behavior.
+using PrioritizeNewElements = RingConfig<uint32_t, 64, 16, false, false>;
+RING_BUFFER_BENCHMARKS(PrioritizeNewElements);
+
+// Callbacks.
+using CallbacksPerElement = RingConfig<uint32_t, 1, 1024, true, true>;
+using CallbacksPerPage = RingConfig<uint32_t, 64, 16, true, true>;
+RING_BUFFER_BENCHMARKS(CallbacksPerElement);
+RING_BUFFER_BENCHMARKS(CallbacksPerPage);
+
+#undef RING_BUFFER_BENCHMARKS
+
+/**
+ * Round trip of heap-allocated elements through a RingBuffer, either copied in with supply_bulk()
+ * or moved in with supply_bulk_move(). In both cases, consume_bulk() moves them out.
+ */
+template <bool MOVE>
+void BM_RingBufferStrings(benchmark::State& state) {
+  static constexpr size_t NUM_ELEMENTS{16};
+  static RingBuffer<std::string, NUM_ELEMENTS, 4, true, NoNotification> ring{};
+  std::array<std::string, NUM_ELEMENTS> elements{};
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (auto& element : elements) {
+      element.assign(256, 'x');
+    }
+    state.ResumeTiming();
+    if constexpr (MOVE) {
+      ring.supply_bulk_move(NUM_ELEMENTS, elements.data());
+    } else {
+      ring.supply_bulk(NUM_ELEMENTS, elements.data());
+    }
+    ring.consume_bulk(NUM_ELEMENTS, elements.data());
+    benchmark::DoNotOptimize(elements.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_ELEMENTS);
+}
+
+BENCHMARK_TEMPLATE(BM_RingBufferStrings, false);
+BENCHMARK_TEMPLATE(BM_RingBufferStrings, true);
+
+// RingBuffer supports a single producer and a single consumer, so it is measured with two threads
+// above. The MpmcRingBuffer also covers four threads. There is always at least one consumer, since
+// only consumed elements are counted.
+BENCHMARK_TEMPLATE(BM_MpmcRingBufferThreaded, uint32_t, 1024)
+    ->Threads(2)
+    ->Threads(4)
+    ->UseRealTime();
+
+template <typename ElementT, size_t NUM_ELEMENTS>
+void BM_BufferCopy(benchmark::State& state) {
+  static Buffer<ElementT, NUM_ELEMENTS> src{};
+  static Buffer<ElementT, NUM_ELEMENTS> dest{};
+  for (auto _ : state) {
+    dest = src;
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * NUM_ELEMENTS * sizeof(ElementT));
+}
+
+template <typename ElementT, size_t NUM_ELEMENTS>
+void BM_BufferClear(benchmark::State& state) {
+  static Buffer<ElementT, NUM_ELEMENTS> buffer{};
+  for (auto _ : state) {
+    buffer.clear();
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * NUM_ELEMENTS * sizeof(ElementT));
+}
+
+template <typename ElementT, size_t NUM_ELEMENTS, BoundsCheck BOUNDS_CHECK = BoundsCheck::ALWAYS>
+void BM_BufferIndex(benchmark::State& state) {
+  static Buffer<ElementT, NUM_ELEMENTS, BOUNDS_CHECK> buffer{};
+  for (auto _ : state) {
+    ElementT sum{};
+    for (size_t i = 0; i < NUM_ELEMENTS; ++i) {
+      sum += buffer[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_ELEMENTS);
+}
+
+#define BUFFER_BENCHMARKS(ElementT, NUM_ELEMENTS)             \
+  BENCHMARK_TEMPLATE(BM_BufferCopy, ElementT, NUM_ELEMENTS);  \
+  BENCHMARK_TEMPLATE(BM_BufferClear, ElementT, NUM_ELEMENTS); \
+  BENCHMARK_TEMPLATE(BM_BufferIndex, ElementT, NUM_ELEMENTS)
+
+BUFFER_BENCHMARKS(uint8_t, 64);
+BUFFER_BENCHMARKS(uint8_t, 1024);
+BUFFER_BENCHMARKS(uint8_t, 16384);
+BUFFER_BENCHMARKS(uint32_t, 64);
+BUFFER_BENCHMARKS(uint32_t, 1024);
+BUFFER_BENCHMARKS(uint32_t, 16384);
+
+#undef BUFFER_BENCHMARKS
+
+// Element access without per-element bounds checks.
+BENCHMARK_TEMPLATE(BM_BufferIndex, uint8_t, 1024, BoundsCheck::BULK_ONLY);
+BENCHMARK_TEMPLATE(BM_BufferIndex, uint32_t, 1024, BoundsCheck::BULK_ONLY);
+
+}  // namespace tvsc::buffer
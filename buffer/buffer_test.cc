@@ -1,6 +1,7 @@
 #include "buffer/buffer.h"
 
 #include <array>
+#include <cstdint>
 #include <memory>
 
 #include "gtest/gtest.h"
@@ -192,6 +193,95 @@ TEST(BufferTest, CanBulkWriteViaStdArrayWithOffset) {
   }
 }
 
+TEST(BufferTest, CanCopyDirectlyFromAnotherBuffer) {
+  constexpr size_t SIZE{64};
+  constexpr size_t SRC_OFFSET{8};
+  constexpr size_t DEST_OFFSET{16};
+  constexpr size_t COUNT{32};
+  Buffer<int, SIZE> src{};
+  Buffer<int, SIZE / 2 + DEST_OFFSET> dest{};
+  for (size_t i = 0; i < SIZE; ++i) {
+    src[i] = i;
+  }
+  dest.copy_from(DEST_OFFSET, src, SRC_OFFSET, COUNT);
+  for (size_t i = 0; i < dest.size(); ++i) {
+    if (i < DEST_OFFSET) {
+      EXPECT_EQ(0, dest[i]);
+    } else {
+      EXPECT_EQ(i - DEST_OFFSET + SRC_OFFSET, dest[i]);
+    }
+  }
+}
+
+TEST(BufferTest, CopyFromAnotherBufferValidatesRanges) {
+  Buffer<int, 16> src{};
+  Buffer<int, 8> dest{};
+  EXPECT_THROW(dest.copy_from(0, src, 0, 9), std::out_of_range);
+  EXPECT_THROW(dest.copy_from(0, src, 12, 8), std::out_of_range);
+}
+
+TEST(BufferTest, AlwaysPolicyValidatesElementAccess) {
+  Buffer<int, 8, BoundsCheck::ALWAYS> buffer{};
+  EXPECT_THROW(buffer[8], std::out_of_range);
+  EXPECT_THROW(buffer.write(8, 1), std::out_of_range);
+}
+
+TEST(BufferTest, BulkOnlyPolicyStillValidatesBulkOperations) {
+  Buffer<int, 8, BoundsCheck::BULK_ONLY> buffer{};
+  std::array<int, 16> other{};
+  EXPECT_THROW(buffer.write(4, 8, other), std::out_of_range);
+  EXPECT_THROW(buffer.read(4, 8, other), std::out_of_range);
+  EXPECT_THROW(buffer.as_string_view(4, 8), std::out_of_range);
+}
+
+TEST(BufferTest, BoundsCheckPolicySelectsChecks) {
+  using Always = internal::BoundsCheckTraits<BoundsCheck::ALWAYS>;
+  using DebugOnly = internal::BoundsCheckTraits<BoundsCheck::DEBUG_ONLY>;
+  using BulkOnly = internal::BoundsCheckTraits<BoundsCheck::BULK_ONLY>;
+
+  EXPECT_TRUE(Always::CHECK_ELEMENT);
+  EXPECT_TRUE(Always::CHECK_BULK);
+  EXPECT_EQ(DebugOnly::IS_DEBUG_BUILD, DebugOnly::CHECK_ELEMENT);
+  EXPECT_EQ(DebugOnly::IS_DEBUG_BUILD, DebugOnly::CHECK_BULK);
+  EXPECT_FALSE(BulkOnly::CHECK_ELEMENT);
+  EXPECT_TRUE(BulkOnly::CHECK_BULK);
+}
+
+TEST(BufferTest, CanCompareAndCopyAcrossBoundsCheckPolicies) {
+  Buffer<int, 8, BoundsCheck::BULK_ONLY> src{};
+  Buffer<int, 8> dest{};
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = i;
+  }
+  dest.copy_from(0, src, 0, src.size());
+  EXPECT_EQ(dest, src);
+}
+
+TEST(BufferTest, CanFill) {
+  Buffer<int, 37> buffer{};
+  buffer.fill(0x01020304);
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    EXPECT_EQ(0x01020304, buffer[i]);
+  }
+}
+
+TEST(BufferTest, CanFillWithRepeatedByte) {
+  Buffer<int, 37> buffer{};
+  buffer.fill(-1);
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    EXPECT_EQ(-1, buffer[i]);
+  }
+}
+
+TEST(BufferTest, ClearResetsElements) {
+  Buffer<int, 37> buffer{};
+  buffer.fill(42);
+  buffer.clear();
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    EXPECT_EQ(0, buffer[i]);
+  }
+}
+
 class TriviallyCopyableType final {
  private:
   int value_{};
@@ -212,6 +302,38 @@ class TriviallyCopyableType final {
 bool operator==(int lhs, const TriviallyCopyableType& rhs) { return lhs == rhs.value(); }
 bool operator==(const TriviallyCopyableType& lhs, int rhs) { return lhs.value() == rhs; }
 
+/**
+ * Trivially copyable type whose default value is not all zero bytes.
+ */
+struct NonzeroDefault final {
+  uint16_t first{0x1234};
+  uint8_t second{0x56};
+  uint8_t third{0x78};
+
+  bool operator==(const NonzeroDefault& rhs) const = default;
+};
+
+TEST(TriviallyCopyableBufferTest, ClearRestoresNonzeroDefault) {
+  Buffer<NonzeroDefault, 65> buffer{};
+  buffer.fill(NonzeroDefault{1, 2, 3});
+  buffer.clear();
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    EXPECT_EQ(NonzeroDefault{}, buffer[i]);
+  }
+}
+
+TEST(TriviallyCopyableBufferTest, FillCoversOddSizes) {
+  Buffer<NonzeroDefault, 1> tiny{};
+  tiny.fill(NonzeroDefault{1, 2, 3});
+  EXPECT_EQ((NonzeroDefault{1, 2, 3}), tiny[0]);
+
+  Buffer<NonzeroDefault, 1000> large{};
+  large.fill(NonzeroDefault{1, 2, 3});
+  for (size_t i = 0; i < large.size(); ++i) {
+    EXPECT_EQ((NonzeroDefault{1, 2, 3}), large[i]);
+  }
+}
+
 TEST(TriviallyCopyableBufferTest, TriviallyCopyableIsTriviallyCopyable) {
   ASSERT_TRUE(std::is_trivially_copyable<TriviallyCopyableType>::value);
 }
@@ -620,4 +742,81 @@ TEST(NontrivialTypeBufferTest, CanBulkWriteViaStdArrayWithOffset) {
   }
 }
 
+TEST(NontrivialTypeBufferTest, CanFillAndClear) {
+  Buffer<NontrivialType, 16> buffer{};
+  buffer.fill(7);
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    EXPECT_EQ(7, buffer[i]);
+  }
+  buffer.clear();
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    EXPECT_EQ(0, buffer[i]);
+  }
+}
+
+TEST(NontrivialTypeBufferTest, CanCopyDirectlyFromAnotherBuffer) {
+  constexpr size_t SIZE{64};
+  constexpr size_t OFFSET{8};
+  Buffer<NontrivialType, SIZE> src{};
+  Buffer<NontrivialType, SIZE> dest{};
+  for (size_t i = 0; i < SIZE; ++i) {
+    src[i] = i;
+  }
+  dest.copy_from(0, src, OFFSET, SIZE - OFFSET);
+  for (size_t i = 0; i < SIZE - OFFSET; ++i) {
+    EXPECT_EQ(i + OFFSET, dest[i]);
+  }
+}
+
+TEST(MoveOnlyBufferTest, CanMoveElementsInAndOut) {
+  Buffer<std::unique_ptr<int>, 4> buffer{};
+  std::array<std::unique_ptr<int>, 2> src{std::make_unique<int>(1), std::make_unique<int>(2)};
+  buffer.move_in_array(1, src.size(), src.data());
+  EXPECT_EQ(nullptr, src[0]);
+  ASSERT_NE(nullptr, buffer[1]);
+  EXPECT_EQ(2, *buffer[2]);
+
+  std::array<std::unique_ptr<int>, 2> dest{};
+  buffer.move_out_array(1, dest.size(), dest.data());
+  EXPECT_EQ(1, *dest[0]);
+  EXPECT_EQ(2, *dest[1]);
+  EXPECT_EQ(nullptr, buffer[1]);
+  EXPECT_EQ(nullptr, buffer[2]);
+}
+
+TEST(MoveOnlyBufferTest, CanEmplace) {
+  Buffer<std::unique_ptr<int>, 2> buffer{};
+  buffer.emplace(1, new int{7});
+  ASSERT_NE(nullptr, buffer[1]);
+  EXPECT_EQ(7, *buffer[1]);
+  buffer.emplace(1);
+  EXPECT_EQ(nullptr, buffer[1]);
+}
+
+TEST(NontrivialTypeBufferTest, MoveOutReleasesResources) {
+  auto shared{std::make_shared<int>(3)};
+  Buffer<std::shared_ptr<int>, 2> buffer{};
+  buffer[0] = shared;
+  EXPECT_EQ(2, shared.use_count());
+
+  std::shared_ptr<int> dest{};
+  buffer.move_out_array(0, 1, &dest);
+  EXPECT_EQ(2, shared.use_count());
+  dest.reset();
+  EXPECT_EQ(1, shared.use_count());
+}
+
+TEST(TriviallyCopyableBufferTest, CanMoveElementsInAndOut) {
+  Buffer<int, 4> buffer{};
+  std::array<int, 2> src{1, 2};
+  buffer.move_in_array(2, src.size(), src.data());
+  buffer.emplace(0, 5);
+  std::array<int, 4> dest{};
+  buffer.move_out_array(0, dest.size(), dest.data());
+  EXPECT_EQ(5, dest[0]);
+  EXPECT_EQ(0, dest[1]);
+  EXPECT_EQ(1, dest[2]);
+  EXPECT_EQ(2, dest[3]);
+}
+
 }  // namespace tvsc::buffer
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "buffer/bounds_check.h"
+
+namespace tvsc::buffer {
+
+/**
+ * Non-owning view of a contiguous range of elements, similar to std::span, but with bounds
+ * checking.
+ *
+ * A BufferView lets a payload be parsed and handed from one layer to the next without copying it
+ * into an intermediate Buffer or std::array at every boundary. The view does not own the elements;
+ * the storage it refers to must outlive it.
+ *
+ * A BufferView<const ElementT> is a read-only view. A BufferView<ElementT> converts to one
+ * implicitly.
+ *
+ * Element accesses and sub-slicing are validated according to the BOUNDS_CHECK policy. See
+ * BoundsCheck.
+ */
+template <typename ElementT, BoundsCheck BOUNDS_CHECK = DEFAULT_BOUNDS_CHECK>
+class BufferView final {
+ private:
+  using Traits = internal::BoundsCheckTraits<BOUNDS_CHECK>;
+
+  ElementT* data_{nullptr};
+  size_t size_{0};
+
+  void validate_element(size_t index) const {
+    if constexpr (Traits::CHECK_ELEMENT) {
+      if (index >= size_) {
+        internal::throw_invalid_index(index, size_);
+      }
+    }
+  }
+
+  void validate_range(size_t offset, size_t count) const {
+    if constexpr (Traits::CHECK_BULK) {
+      if (offset > size_) {
+        internal::throw_invalid_index(offset, size_);
+      }
+      if (count > size_ - offset) {
+        internal::throw_invalid_index(offset + count - 1, size_);
+      }
+    }
+  }
+
+ public:
+  using ElementType = ElementT;
+
+  constexpr BufferView() = default;
+  constexpr BufferView(ElementT* data, size_t size) : data_(data), size_(size) {}
+
+  /**
+   * View of an entire container with contiguous storage, such as a Buffer or a std::array.
+   */
+  template <typename ContainerT>
+    requires(!std::is_same_v<std::remove_cvref_t<ContainerT>, BufferView> &&
+             requires(ContainerT& container) {
+               { container.data() } -> std::convertible_to<ElementT*>;
+               { container.size() } -> std::convertible_to<size_t>;
+             })
+  constexpr BufferView(ContainerT& container)
+      : data_(container.data()), size_(container.size()) {}
+
+  /**
+   * A view of mutable elements can always be used as a view of const elements.
+   */
+  template <typename OtherElementT, BoundsCheck OTHER_BOUNDS_CHECK>
+    requires(std::is_same_v<const OtherElementT, ElementT> &&
+             !std::is_same_v<OtherElementT, ElementT>)
+  constexpr BufferView(const BufferView<OtherElementT, OTHER_BOUNDS_CHECK>& rhs)
+      : data_(rhs.data()), size_(rhs.size()) {}
+
+  constexpr size_t size() const { return size_; }
+  constexpr size_t max_size() const { return size_; }
+  constexpr bool empty() const { return size_ == 0; }
+
+  constexpr ElementT* data() const { return data_; }
+
+  constexpr ElementT* begin() const { return data_; }
+  constexpr ElementT* end() const { return data_ + size_; }
+
+  ElementT& operator[](size_t index) const {
+    validate_element(index);
+    return data_[index];
+  }
+
+  /**
+   * View of count elements of this view, starting at offset. No elements are copied.
+   */
+  BufferView subview(size_t offset, size_t count) const {
+    validate_range(offset, count);
+    return BufferView{data_ + offset, count};
+  }
+
+  /**
+   * View of the elements of this view from offset to the end.
+   */
+  BufferView subview(size_t offset) const {
+    validate_range(offset, 0);
+    return BufferView{data_ + offset, size_ - offset};
+  }
+
+  BufferView first(size_t count) const { return subview(0, count); }
+  BufferView last(size_t count) const {
+    validate_range(0, count);
+    return BufferView{data_ + size_ - count, count};
+  }
+};
+
+template <typename ContainerT>
+BufferView(ContainerT&)
+    -> BufferView<std::remove_reference_t<decltype(*std::declval<ContainerT&>().data())>>;
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,167 @@
+#include "buffer/buffer_view.h"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+#include "buffer/buffer.h"
+#include "gtest/gtest.h"
+
+namespace tvsc::buffer {
+
+TEST(BufferViewTest, DefaultViewIsEmpty) {
+  BufferView<uint8_t> view{};
+  EXPECT_TRUE(view.empty());
+  EXPECT_EQ(0, view.size());
+  EXPECT_EQ(nullptr, view.data());
+}
+
+TEST(BufferViewTest, CanViewBuffer) {
+  Buffer<uint8_t, 16> buffer{};
+  BufferView view{buffer};
+  EXPECT_EQ(16, view.size());
+  EXPECT_EQ(buffer.data(), view.data());
+
+  view[3] = 42;
+  EXPECT_EQ(42, buffer[3]);
+}
+
+TEST(BufferViewTest, CanViewStdArray) {
+  std::array<uint8_t, 8> array{1, 2, 3, 4, 5, 6, 7, 8};
+  BufferView<const uint8_t> view{array};
+  EXPECT_EQ(8, view.size());
+  EXPECT_EQ(5, view[4]);
+}
+
+TEST(BufferViewTest, MutableViewConvertsToConstView) {
+  Buffer<uint8_t, 16> buffer{};
+  BufferView<uint8_t> view{buffer};
+  BufferView<const uint8_t> const_view{view};
+  EXPECT_EQ(view.data(), const_view.data());
+  EXPECT_EQ(view.size(), const_view.size());
+}
+
+TEST(BufferViewTest, SubviewSharesStorage) {
+  Buffer<uint8_t, 16> buffer{};
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = i;
+  }
+  BufferView<uint8_t> view{buffer};
+  BufferView<uint8_t> middle{view.subview(4, 8)};
+  EXPECT_EQ(buffer.data() + 4, middle.data());
+  EXPECT_EQ(8, middle.size());
+  EXPECT_EQ(4, middle[0]);
+  EXPECT_EQ(11, middle[7]);
+
+  BufferView<uint8_t> nested{middle.subview(2, 2)};
+  EXPECT_EQ(6, nested[0]);
+  EXPECT_EQ(7, nested[1]);
+
+  EXPECT_EQ(12, view.subview(4).size());
+  EXPECT_EQ(0, view.first(4)[0]);
+  EXPECT_EQ(12, view.last(4)[0]);
+}
+
+TEST(BufferViewTest, ValidatesIndex) {
+  Buffer<uint8_t, 16> buffer{};
+  BufferView<uint8_t, BoundsCheck::ALWAYS> view{buffer};
+  EXPECT_THROW(view[16], std::out_of_range);
+  EXPECT_THROW(view.subview(8, 9), std::out_of_range);
+  EXPECT_THROW(view.subview(17), std::out_of_range);
+  EXPECT_THROW(view.last(17), std::out_of_range);
+  EXPECT_NO_THROW(view.subview(16));
+  EXPECT_TRUE(view.subview(16).empty());
+}
+
+TEST(BufferViewTest, BufferCanProvideViews) {
+  Buffer<uint8_t, 16> buffer{};
+  buffer[8] = 42;
+  EXPECT_EQ(16, buffer.view().size());
+  EXPECT_EQ(42, buffer.view(8, 4)[0]);
+  EXPECT_THROW(buffer.view(8, 9), std::out_of_range);
+}
+
+TEST(BufferViewTest, BufferCanReadIntoAndWriteFromViews) {
+  Buffer<uint8_t, 16> src{};
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = i;
+  }
+  std::array<uint8_t, 4> array{};
+  src.read(8, BufferView<uint8_t>{array});
+  EXPECT_EQ(8, array[0]);
+  EXPECT_EQ(11, array[3]);
+
+  Buffer<uint8_t, 16> dest{};
+  dest.write(2, src.view(8, 4));
+  EXPECT_EQ(0, dest[1]);
+  EXPECT_EQ(8, dest[2]);
+  EXPECT_EQ(11, dest[5]);
+  EXPECT_EQ(0, dest[6]);
+
+  EXPECT_THROW(dest.write(14, src.view(0, 4)), std::out_of_range);
+}
+
+/**
+ * Element type that counts how many times elements are copied.
+ */
+class CopyCountingElement final {
+ private:
+  int value_{};
+
+ public:
+  static inline size_t copy_count{0};
+
+  CopyCountingElement() = default;
+  CopyCountingElement(int value) : value_(value) {}
+
+  CopyCountingElement(const CopyCountingElement& rhs) : value_(rhs.value_) { ++copy_count; }
+
+  CopyCountingElement& operator=(const CopyCountingElement& rhs) {
+    value_ = rhs.value_;
+    ++copy_count;
+    return *this;
+  }
+
+  int value() const { return value_; }
+};
+
+TEST(BufferViewTest, ForwardingViaViewHalvesCopies) {
+  // A frame is a header followed by a payload that is forwarded to the next layer.
+  static constexpr size_t HEADER_SIZE{4};
+  static constexpr size_t PAYLOAD_SIZE{16};
+  Buffer<CopyCountingElement, HEADER_SIZE + PAYLOAD_SIZE> frame{};
+  for (size_t i = 0; i < frame.size(); ++i) {
+    frame[i] = i;
+  }
+
+  // Before: the payload is copied out of the frame into an intermediate buffer, and then from that
+  // buffer into the next layer.
+  Buffer<CopyCountingElement, PAYLOAD_SIZE> forwarded_with_copies{};
+  CopyCountingElement::copy_count = 0;
+  {
+    Buffer<CopyCountingElement, PAYLOAD_SIZE> payload{};
+    frame.read(HEADER_SIZE, PAYLOAD_SIZE, payload);
+    forwarded_with_copies.write(0, PAYLOAD_SIZE, payload);
+  }
+  const size_t copies_before{CopyCountingElement::copy_count};
+  EXPECT_EQ(2 * PAYLOAD_SIZE, copies_before);
+
+  // After: the payload is parsed through a view of the frame, and each element is copied once,
+  // directly into the next layer.
+  Buffer<CopyCountingElement, PAYLOAD_SIZE> forwarded_with_view{};
+  CopyCountingElement::copy_count = 0;
+  {
+    BufferView<const CopyCountingElement> payload{frame.view(HEADER_SIZE, PAYLOAD_SIZE)};
+    EXPECT_EQ(0, CopyCountingElement::copy_count);
+    forwarded_with_view.write(0, payload);
+  }
+  const size_t copies_after{CopyCountingElement::copy_count};
+  EXPECT_EQ(PAYLOAD_SIZE, copies_after);
+
+  for (size_t i = 0; i < PAYLOAD_SIZE; ++i) {
+    EXPECT_EQ(forwarded_with_copies[i].value(), forwarded_with_view[i].value());
+    EXPECT_EQ(static_cast<int>(i + HEADER_SIZE), forwarded_with_view[i].value());
+  }
+}
+
+}  // namespace tvsc::buffer
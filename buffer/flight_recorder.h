@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace tvsc::buffer {
+
+/**
+ * A single event read back from a FlightRecorder.
+ */
+struct FlightRecorderEvent final {
+  // Position of the event in the sequence of all events appended since the recorder was cleared.
+  uint32_t sequence{};
+  uint32_t timestamp{};
+  uint32_t id{};
+  uint32_t value{};
+};
+
+/**
+ * Fixed-size ring of binary events intended to survive warm resets.
+ *
+ * The `.status.value` globals only hold the latest value of each variable. A FlightRecorder keeps
+ * the last NUM_EVENTS events, each an id, a value and a timestamp, so that after a watchdog reset
+ * or a failure() we can see what led up to it. An instance is meant to be placed in a section that
+ * the startup code neither zeroes nor initializes (see hal/flight_recorder.h). For that reason,
+ * this class is trivially default constructible and has no default member initializers; its
+ * contents are only set by initialize().
+ *
+ * append() is lock-free and safe to call from interrupt handlers. It claims a slot with a single
+ * atomic increment and then writes four words. Each slot carries its sequence number, written
+ * last, and the sequence number is cleared before the rest of the slot is overwritten. A reader
+ * skips any slot whose sequence number does not match its position, so an append that was
+ * interrupted by a reset, or by another append that lapped it, never yields a torn event.
+ *
+ * The recorder is read while its writers are stopped: by a debugger with the core halted, or after
+ * a reset. Compiler fences are therefore enough to keep the stores in order. No hardware barriers
+ * are needed, which keeps an append to a few dozen cycles.
+ *
+ * All fields are 32-bit words so that the recorder can be read over SWD with word-sized accesses
+ * and decoded on another machine. See serial_wire/flight_recorder.h.
+ */
+template <size_t NUM_EVENTS>
+class FlightRecorder final {
+ public:
+  // "FLTR" in ASCII. Distinguishes a recorder retained across a warm reset from uninitialized RAM.
+  static constexpr uint32_t MAGIC{0x464c5452};
+
+ private:
+  static_assert(NUM_EVENTS >= 2, "FlightRecorder must hold at least two events");
+  static_assert((NUM_EVENTS & (NUM_EVENTS - 1)) == 0,
+                "FlightRecorder size must be a power of two");
+
+  static constexpr uint32_t INDEX_MASK{NUM_EVENTS - 1};
+
+  struct Slot final {
+    // Sequence number of the event plus one. Zero marks a slot that is empty or being written.
+    uint32_t tag;
+    uint32_t timestamp;
+    uint32_t id;
+    uint32_t value;
+  };
+
+  uint32_t magic_;
+  uint32_t num_events_;
+  uint32_t boot_count_;
+  uint32_t next_sequence_;
+  Slot slots_[NUM_EVENTS];
+
+ public:
+  /**
+   * Prepare the recorder for use. If it holds a recorder of the same size that was retained across
+   * a warm reset, its events are kept, the boot count is incremented, and new events continue the
+   * sequence. Otherwise, the recorder is cleared.
+   *
+   * Returns true if earlier events were retained.
+   */
+  bool initialize() noexcept {
+    if (is_valid()) {
+      ++boot_count_;
+      return true;
+    }
+    clear();
+    return false;
+  }
+
+  void clear() noexcept {
+    magic_ = MAGIC;
+    num_events_ = NUM_EVENTS;
+    boot_count_ = 0;
+    next_sequence_ = 0;
+    for (Slot& slot : slots_) {
+      slot = Slot{};
+    }
+  }
+
+  bool is_valid() const noexcept { return magic_ == MAGIC && num_events_ == NUM_EVENTS; }
+
+  static constexpr size_t capacity() noexcept { return NUM_EVENTS; }
+
+  /**
+   * Number of warm resets survived since the recorder was last cleared.
+   */
+  uint32_t boot_count() const noexcept { return boot_count_; }
+
+  /**
+   * Total number of events appended since the recorder was last cleared, including those that have
+   * since been overwritten.
+   */
+  uint32_t num_appended() const noexcept {
+    return std::atomic_ref<const uint32_t>{next_sequence_}.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Append an event, overwriting the oldest event if the recorder is full. Safe to call from
+   * interrupt handlers and from multiple threads.
+   */
+  void append(uint32_t id, uint32_t value, uint32_t timestamp) noexcept {
+    const uint32_t sequence{
+        std::atomic_ref<uint32_t>{next_sequence_}.fetch_add(1, std::memory_order_relaxed)};
+    Slot& slot{slots_[sequence & INDEX_MASK]};
+    std::atomic_ref<uint32_t> tag{slot.tag};
+
+    tag.store(0, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_release);
+    slot.timestamp = timestamp;
+    slot.id = id;
+    slot.value = value;
+    std::atomic_signal_fence(std::memory_order_release);
+    tag.store(sequence + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Invoke fn with each complete event still in the recorder, oldest first. Nothing is invoked if
+   * the recorder is not valid.
+   */
+  template <typename Fn>
+  void for_each_event(Fn&& fn) const {
+    if (!is_valid()) {
+      return;
+    }
+    const uint32_t end{next_sequence_};
+    const uint32_t begin{end > NUM_EVENTS ? end - static_cast<uint32_t>(NUM_EVENTS) : 0};
+    for (uint32_t sequence = begin; sequence != end; ++sequence) {
+      const Slot& slot{slots_[sequence & INDEX_MASK]};
+      if (slot.tag == sequence + 1) {
+        fn(FlightRecorderEvent{sequence, slot.timestamp, slot.id, slot.value});
+      }
+    }
+  }
+};
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,159 @@
+#include "buffer/flight_recorder.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace tvsc::buffer {
+
+std::vector<FlightRecorderEvent> read_all(const FlightRecorder<8>& recorder) {
+  std::vector<FlightRecorderEvent> events{};
+  recorder.for_each_event([&events](const FlightRecorderEvent& event) { events.push_back(event); });
+  return events;
+}
+
+TEST(FlightRecorderTest, IsTriviallyDefaultConstructible) {
+  // Required so that an instance in a no-init section is not overwritten by static initialization.
+  EXPECT_TRUE(std::is_trivially_default_constructible_v<FlightRecorder<8>>);
+  EXPECT_TRUE(std::is_trivially_copyable_v<FlightRecorder<8>>);
+}
+
+TEST(FlightRecorderTest, InitializeClearsGarbage) {
+  auto recorder{std::make_unique<FlightRecorder<8>>()};
+  std::memset(static_cast<void*>(recorder.get()), 0xa5, sizeof(FlightRecorder<8>));
+  EXPECT_FALSE(recorder->is_valid());
+  EXPECT_TRUE(read_all(*recorder).empty());
+
+  EXPECT_FALSE(recorder->initialize());
+  EXPECT_TRUE(recorder->is_valid());
+  EXPECT_EQ(0, recorder->boot_count());
+  EXPECT_EQ(0, recorder->num_appended());
+  EXPECT_TRUE(read_all(*recorder).empty());
+}
+
+TEST(FlightRecorderTest, EventsAreReadOldestFirst) {
+  FlightRecorder<8> recorder{};
+  recorder.initialize();
+  recorder.append(1, 10, 100);
+  recorder.append(2, 20, 200);
+
+  const auto events{read_all(recorder)};
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ(0, events[0].sequence);
+  EXPECT_EQ(1, events[0].id);
+  EXPECT_EQ(10, events[0].value);
+  EXPECT_EQ(100, events[0].timestamp);
+  EXPECT_EQ(1, events[1].sequence);
+  EXPECT_EQ(2, events[1].id);
+}
+
+TEST(FlightRecorderTest, OverwritesOldestEvents) {
+  FlightRecorder<8> recorder{};
+  recorder.initialize();
+  for (uint32_t i = 0; i < 20; ++i) {
+    recorder.append(i, i, i);
+  }
+  EXPECT_EQ(20, recorder.num_appended());
+
+  const auto events{read_all(recorder)};
+  ASSERT_EQ(8, events.size());
+  for (uint32_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(12 + i, events[i].sequence);
+    EXPECT_EQ(12 + i, events[i].id);
+  }
+}
+
+TEST(FlightRecorderTest, RetainsEventsAcrossWarmReset) {
+  FlightRecorder<8> recorder{};
+  recorder.initialize();
+  recorder.append(1, 1, 1);
+
+  // A warm reset runs initialize() again on the retained contents.
+  EXPECT_TRUE(recorder.initialize());
+  EXPECT_EQ(1, recorder.boot_count());
+  recorder.append(2, 2, 2);
+
+  const auto events{read_all(recorder)};
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ(1, events[0].id);
+  EXPECT_EQ(2, events[1].id);
+  EXPECT_EQ(1, events[1].sequence);
+}
+
+TEST(FlightRecorderTest, SkipsTornEvent) {
+  FlightRecorder<8> recorder{};
+  recorder.initialize();
+  for (uint32_t i = 0; i < 4; ++i) {
+    recorder.append(i, i, i);
+  }
+
+  // Simulate a reset in the middle of overwriting the second event: the first word of each slot is
+  // the tag, which append() clears before writing the rest of the slot.
+  static constexpr size_t HEADER_WORDS{4};
+  static constexpr size_t SLOT_WORDS{4};
+  uint32_t words[sizeof(FlightRecorder<8>) / sizeof(uint32_t)];
+  std::memcpy(words, &recorder, sizeof(words));
+  words[HEADER_WORDS + 1 * SLOT_WORDS] = 0;
+  std::memcpy(static_cast<void*>(&recorder), words, sizeof(words));
+
+  const auto events{read_all(recorder)};
+  ASSERT_EQ(3, events.size());
+  EXPECT_EQ(0, events[0].id);
+  EXPECT_EQ(2, events[1].id);
+  EXPECT_EQ(3, events[2].id);
+}
+
+TEST(FlightRecorderTest, CanDecodeCopyOfRawWords) {
+  // This is how a recorder read from a target over SWD is decoded.
+  FlightRecorder<8> recorder{};
+  recorder.initialize();
+  recorder.append(7, 42, 1000);
+
+  std::vector<uint32_t> words(sizeof(FlightRecorder<8>) / sizeof(uint32_t));
+  std::memcpy(words.data(), &recorder, sizeof(FlightRecorder<8>));
+  FlightRecorder<8> image{};
+  std::memcpy(static_cast<void*>(&image), words.data(), sizeof(FlightRecorder<8>));
+
+  const auto events{read_all(image)};
+  ASSERT_EQ(1, events.size());
+  EXPECT_EQ(7, events[0].id);
+  EXPECT_EQ(42, events[0].value);
+  EXPECT_EQ(1000, events[0].timestamp);
+}
+
+TEST(FlightRecorderTest, ConcurrentAppendsClaimDistinctSlots) {
+  static constexpr uint32_t NUM_THREADS{4};
+  static constexpr uint32_t EVENTS_PER_THREAD{2};
+  static FlightRecorder<8> recorder{};
+  recorder.initialize();
+
+  std::vector<std::thread> threads{};
+  for (uint32_t t = 0; t < NUM_THREADS; ++t) {
+    threads.emplace_back([t]() {
+      for (uint32_t i = 0; i < EVENTS_PER_THREAD; ++i) {
+        recorder.append(t, i, 0);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const auto events{read_all(recorder)};
+  ASSERT_EQ(NUM_THREADS * EVENTS_PER_THREAD, events.size());
+  uint32_t per_thread[NUM_THREADS]{};
+  for (const auto& event : events) {
+    ASSERT_LT(event.id, NUM_THREADS);
+    ++per_thread[event.id];
+  }
+  for (uint32_t count : per_thread) {
+    EXPECT_EQ(EVENTS_PER_THREAD, count);
+  }
+}
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace tvsc::buffer {
+
+/**
+ * Lock-free bounded ring buffer for multiple producers and multiple consumers.
+ *
+ * RingBuffer assumes a single producer and a single consumer. When several threads race on it, the
+ * losing thread discovers that it lost only after it has copied its data, and then it discards that
+ * work. This class avoids that by stamping each slot with a sequence number. A thread first claims
+ * a slot by advancing the shared write (or read) pointer, and only then copies the element. A
+ * thread that loses the race to claim a slot has done no copying and simply retries with the next
+ * slot.
+ *
+ * Each slot's sequence number tells the threads what state the slot is in:
+ * - sequence == position: the slot is empty and can be written by the producer that claims
+ *   position.
+ * - sequence == position + 1: the slot holds the element written at position and can be read by
+ *   the consumer that claims position.
+ * - sequence == position + CAPACITY: the slot has been read and is ready for the producer on the
+ *   next lap around the ring.
+ *
+ * This design follows Dmitry Vyukov's bounded MPMC queue.
+ *
+ * Unlike RingBuffer, this class has no page structure and no data needed/available callbacks; it
+ * targets host-side pipelines where threads block or poll on their own. It also only supports
+ * tail drop (https://en.wikipedia.org/wiki/Tail_drop). Overwriting the oldest element would require
+ * producers to take slots away from consumers that may already have claimed them.
+ */
+template <typename ElementT, size_t CAPACITY>
+class MpmcRingBuffer final {
+ private:
+  static_assert(CAPACITY >= 2, "MpmcRingBuffer must have a capacity of at least two elements");
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "MpmcRingBuffer capacity must be a power of two");
+
+  // Size used to keep the producer and consumer pointers on separate cache lines. 64 bytes covers
+  // the host processors that we use.
+  static constexpr size_t CACHE_LINE_SIZE{64};
+  static constexpr size_t INDEX_MASK{CAPACITY - 1};
+
+  struct Slot final {
+    std::atomic<size_t> sequence{};
+    ElementT element{};
+  };
+
+  std::array<Slot, CAPACITY> slots_{};
+
+  // Like the pointers in RingBuffer, these pointers are monotonically increasing. They count the
+  // total number of slots claimed for writing and for reading.
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> write_pointer_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> read_pointer_{0};
+
+  static std::ptrdiff_t compare_sequence(size_t sequence, size_t expected) {
+    return static_cast<std::ptrdiff_t>(sequence - expected);
+  }
+
+  /**
+   * Claim the next slot for writing. Returns nullptr if the ring is full.
+   */
+  Slot* claim_write_slot(size_t& position) {
+    position = write_pointer_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot{slots_[position & INDEX_MASK]};
+      const size_t sequence{slot.sequence.load(std::memory_order_acquire)};
+      const std::ptrdiff_t difference{compare_sequence(sequence, position)};
+      if (difference == 0) {
+        if (write_pointer_.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+          return &slot;
+        }
+        // On failure, compare_exchange_weak() has loaded the current write pointer into position.
+      } else if (difference < 0) {
+        // The slot still holds an element from the previous lap. The ring is full.
+        return nullptr;
+      } else {
+        // Another producer claimed this slot. Try again from the current write pointer.
+        position = write_pointer_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Claim the next slot for reading. Returns nullptr if the ring is empty.
+   */
+  Slot* claim_read_slot(size_t& position) {
+    position = read_pointer_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot{slots_[position & INDEX_MASK]};
+      const size_t sequence{slot.sequence.load(std::memory_order_acquire)};
+      const std::ptrdiff_t difference{compare_sequence(sequence, position + 1)};
+      if (difference == 0) {
+        if (read_pointer_.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+          return &slot;
+        }
+      } else if (difference < 0) {
+        // The slot has not been written yet on this lap. The ring is empty.
+        return nullptr;
+      } else {
+        position = read_pointer_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ public:
+  MpmcRingBuffer() {
+    for (size_t i = 0; i < CAPACITY; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+  MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+  constexpr size_t max_buffered_elements() const { return CAPACITY; }
+
+  /**
+   * Supply a single element to the ring. Returns true if the element was accepted; false, if the
+   * ring is full.
+   */
+  bool supply(const ElementT& src) {
+    size_t position;
+    Slot* slot{claim_write_slot(position)};
+    if (slot == nullptr) {
+      return false;
+    }
+    slot->element = src;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool supply(ElementT&& src) {
+    size_t position;
+    Slot* slot{claim_write_slot(position)};
+    if (slot == nullptr) {
+      return false;
+    }
+    slot->element = std::move(src);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Supply up to num_elements to the ring. Elements are claimed one slot at a time, so elements
+   * from concurrent producers may be interleaved.
+   *
+   * Returns the number of elements actually copied into the ring.
+   */
+  size_t supply(size_t num_elements, const ElementT* src) {
+    size_t elements_supplied{0};
+    while (elements_supplied < num_elements && supply(src[elements_supplied])) {
+      ++elements_supplied;
+    }
+    return elements_supplied;
+  }
+
+  /**
+   * Consume a single element from the ring. Returns true if an element was consumed.
+   */
+  bool consume(ElementT* dest) {
+    size_t position;
+    Slot* slot{claim_read_slot(position)};
+    if (slot == nullptr) {
+      return false;
+    }
+    *dest = std::move(slot->element);
+    slot->sequence.store(position + CAPACITY, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Consume up to num_elements from the ring.
+   *
+   * Returns the number of elements actually consumed.
+   */
+  size_t consume(size_t num_elements, ElementT* dest) {
+    size_t elements_consumed{0};
+    while (elements_consumed < num_elements && consume(dest + elements_consumed)) {
+      ++elements_consumed;
+    }
+    return elements_consumed;
+  }
+
+  /**
+   * Number of elements in the ring. With concurrent producers and consumers, this value is only a
+   * snapshot and may be stale by the time it is returned.
+   */
+  size_t elements_available() const {
+    // Load the read pointer first. Consumers never claim a slot before it has been claimed by a
+    // producer, so the write pointer that we load afterwards is never behind it. It may, however,
+    // have moved far enough ahead of our stale read pointer to appear to exceed the capacity.
+    const size_t read_pointer_value{read_pointer_.load(std::memory_order_acquire)};
+    const size_t write_pointer_value{write_pointer_.load(std::memory_order_acquire)};
+    return std::min(write_pointer_value - read_pointer_value, CAPACITY);
+  }
+
+  bool empty() const { return elements_available() == 0; }
+
+  bool full() const { return elements_available() >= max_buffered_elements(); }
+};
+
+}  // namespace tvsc::buffer
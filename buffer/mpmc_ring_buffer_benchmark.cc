@@ -0,0 +1,66 @@
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "buffer/mpmc_ring_buffer.h"
+#include "buffer/ring_buffer.h"
+
+namespace tvsc::buffer {
+
+static constexpr size_t CAPACITY{1024};
+
+/**
+ * Contended throughput. Even numbered threads produce and odd numbered threads consume. Each
+ * iteration makes a single, non-blocking attempt, and only the elements that consumers receive are
+ * counted, so the reported items per second is the number of elements that made it through the
+ * ring.
+ */
+template <typename RingT>
+void BM_ContendedTransfer(benchmark::State& state) {
+  static RingT ring{};
+
+  const bool is_producer{state.thread_index() % 2 == 0};
+  uint64_t element{0};
+  int64_t elements_consumed{0};
+  for (auto _ : state) {
+    if (is_producer) {
+      if (ring.supply(element)) {
+        ++element;
+      }
+    } else {
+      if (ring.consume(&element)) {
+        ++elements_consumed;
+      }
+    }
+    benchmark::DoNotOptimize(element);
+  }
+  state.SetItemsProcessed(elements_consumed);
+}
+
+// RingBuffer is only safe with a single producer and a single consumer. With more producers, they
+// race and RingBuffer::supply() detects the corruption and throws.
+BENCHMARK_TEMPLATE(BM_ContendedTransfer, RingBuffer<uint64_t, 1, CAPACITY>)
+    ->Threads(2)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ContendedTransfer, MpmcRingBuffer<uint64_t, CAPACITY>)
+    ->ThreadRange(2, 8)
+    ->UseRealTime();
+
+/**
+ * Uncontended round trip of a single element, to show the baseline cost of each implementation.
+ */
+template <typename RingT>
+void BM_UncontendedRoundTrip(benchmark::State& state) {
+  RingT ring{};
+  uint64_t element{0};
+  for (auto _ : state) {
+    ring.supply(element);
+    ring.consume(&element);
+    benchmark::DoNotOptimize(element);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_UncontendedRoundTrip, RingBuffer<uint64_t, 1, CAPACITY>);
+BENCHMARK_TEMPLATE(BM_UncontendedRoundTrip, MpmcRingBuffer<uint64_t, CAPACITY>);
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,141 @@
+#include "buffer/mpmc_ring_buffer.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace tvsc::buffer {
+
+TEST(MpmcRingBufferTest, NewRingIsEmpty) {
+  MpmcRingBuffer<int, 8> ring{};
+  EXPECT_TRUE(ring.empty());
+  EXPECT_FALSE(ring.full());
+  EXPECT_EQ(0, ring.elements_available());
+  EXPECT_EQ(8, ring.max_buffered_elements());
+}
+
+TEST(MpmcRingBufferTest, CanSupplyAndConsumeSingleElement) {
+  MpmcRingBuffer<int, 8> ring{};
+  EXPECT_TRUE(ring.supply(42));
+  EXPECT_EQ(1, ring.elements_available());
+
+  int value{};
+  EXPECT_TRUE(ring.consume(&value));
+  EXPECT_EQ(42, value);
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(MpmcRingBufferTest, ConsumeFromEmptyRingFails) {
+  MpmcRingBuffer<int, 8> ring{};
+  int value{-1};
+  EXPECT_FALSE(ring.consume(&value));
+  EXPECT_EQ(-1, value);
+}
+
+TEST(MpmcRingBufferTest, RejectsElementsWhenFull) {
+  MpmcRingBuffer<int, 4> ring{};
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(ring.supply(i));
+  }
+  EXPECT_TRUE(ring.full());
+  EXPECT_FALSE(ring.supply(4));
+
+  int value{};
+  ASSERT_TRUE(ring.consume(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(ring.supply(4));
+}
+
+TEST(MpmcRingBufferTest, PreservesOrderAcrossManyLaps) {
+  MpmcRingBuffer<int, 4> ring{};
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(ring.supply(i));
+    int value{};
+    ASSERT_TRUE(ring.consume(&value));
+    EXPECT_EQ(i, value);
+  }
+}
+
+TEST(MpmcRingBufferTest, BulkOperationsStopAtCapacity) {
+  MpmcRingBuffer<int, 8> ring{};
+  std::array<int, 10> src{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_EQ(8, ring.supply(src.size(), src.data()));
+
+  std::array<int, 10> dest{};
+  EXPECT_EQ(8, ring.consume(dest.size(), dest.data()));
+  for (size_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(src[i], dest[i]);
+  }
+}
+
+/**
+ * Multiple producers and consumers hammer a small ring. Each element encodes its producer and a
+ * per-producer sequence number. We verify that every element is delivered exactly once and that
+ * each consumer sees the elements from any one producer in order.
+ */
+TEST(MpmcRingBufferTest, StressTestDeliversEveryElementExactlyOnce) {
+  static constexpr size_t NUM_PRODUCERS{4};
+  static constexpr size_t NUM_CONSUMERS{4};
+  static constexpr uint64_t ELEMENTS_PER_PRODUCER{100'000};
+  static constexpr uint64_t PRODUCER_SHIFT{32};
+
+  MpmcRingBuffer<uint64_t, 64> ring{};
+
+  std::atomic<uint64_t> total_consumed{0};
+  std::vector<std::vector<uint64_t>> consumed(NUM_CONSUMERS);
+
+  std::vector<std::thread> threads{};
+  for (uint64_t producer = 0; producer < NUM_PRODUCERS; ++producer) {
+    threads.emplace_back([&ring, producer]() {
+      for (uint64_t i = 0; i < ELEMENTS_PER_PRODUCER; ++i) {
+        const uint64_t element{(producer << PRODUCER_SHIFT) | i};
+        while (!ring.supply(element)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (size_t consumer = 0; consumer < NUM_CONSUMERS; ++consumer) {
+    threads.emplace_back([&ring, &total_consumed, &received = consumed[consumer]]() {
+      while (total_consumed.load() < NUM_PRODUCERS * ELEMENTS_PER_PRODUCER) {
+        uint64_t element{};
+        if (ring.consume(&element)) {
+          received.push_back(element);
+          total_consumed.fetch_add(1);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_TRUE(ring.empty());
+
+  std::vector<uint64_t> all_elements{};
+  for (const auto& received : consumed) {
+    std::array<int64_t, NUM_PRODUCERS> last_sequence{};
+    last_sequence.fill(-1);
+    for (uint64_t element : received) {
+      const uint64_t producer{element >> PRODUCER_SHIFT};
+      const int64_t sequence{static_cast<int64_t>(element & ((1ULL << PRODUCER_SHIFT) - 1))};
+      ASSERT_LT(producer, NUM_PRODUCERS);
+      ASSERT_LT(last_sequence[producer], sequence);
+      last_sequence[producer] = sequence;
+    }
+    all_elements.insert(all_elements.end(), received.begin(), received.end());
+  }
+
+  ASSERT_EQ(NUM_PRODUCERS * ELEMENTS_PER_PRODUCER, all_elements.size());
+  std::sort(all_elements.begin(), all_elements.end());
+  EXPECT_EQ(all_elements.end(), std::adjacent_find(all_elements.begin(), all_elements.end()));
+}
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,177 @@
+/**
+ * Notification policies for RingBuffer.
+ *
+ * A RingBuffer can signal its source when it has space for more data and its sink when data is
+ * available. How those signals are delivered is chosen at compile time with one of the policies
+ * below:
+ *
+ * - NoNotification: no callbacks at all. The RingBuffer carries no callback storage, and the
+ *   checks after each supply or consume compile away.
+ * - FunctionPointerNotification: callbacks are plain function pointers, set at runtime. This avoids
+ *   the size and the type-erasure overhead of std::function.
+ * - StdFunctionNotification: callbacks are std::function instances, set at runtime. This is the
+ *   default and allows capturing lambdas.
+ * - FunctorNotification: callbacks are functor types fixed at compile time and can be inlined into
+ *   the RingBuffer's supply and consume methods.
+ *
+ * Independently, the NotificationTrigger selects when the callbacks fire. With LEVEL triggering,
+ * the callbacks fire after every operation that leaves the RingBuffer at or past the threshold.
+ * With EDGE triggering, they fire only when the occupancy crosses the threshold, so that, for
+ * example, a consumer task can be woken once per batch rather than once per element.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace tvsc::buffer {
+
+enum class NotificationTrigger : uint8_t {
+  LEVEL,
+  EDGE,
+};
+
+struct NoNotification final {};
+
+struct FunctionPointerNotification final {};
+
+struct StdFunctionNotification final {};
+
+/**
+ * Policy with callbacks fixed at compile time. DataNeededFn and DataAvailableFn are invoked with a
+ * reference to the RingBuffer. They must be default constructible, or an instance of this policy
+ * must be passed to the RingBuffer's constructor.
+ */
+template <typename DataNeededFn, typename DataAvailableFn>
+struct FunctorNotification final {
+  [[no_unique_address]] DataNeededFn data_needed{};
+  [[no_unique_address]] DataAvailableFn data_available{};
+};
+
+namespace internal {
+
+/**
+ * Storage and dispatch for the callbacks of each notification policy. RingBuffer holds one of these
+ * and only ever calls the members below.
+ */
+template <typename PolicyT, typename RingT>
+class Notifier;
+
+template <typename RingT>
+class Notifier<NoNotification, RingT> final {
+ public:
+  static constexpr bool ENABLED{false};
+  static constexpr bool RUNTIME_CONFIGURABLE{false};
+
+  // Placeholder so that RingBuffer can name a callback type for every policy.
+  using Callback = std::nullptr_t;
+
+  constexpr bool has_data_needed() const { return false; }
+  constexpr bool has_data_available() const { return false; }
+  void data_needed(RingT& /*ring*/) {}
+  void data_available(RingT& /*ring*/) {}
+};
+
+template <typename RingT>
+class Notifier<FunctionPointerNotification, RingT> final {
+ public:
+  static constexpr bool ENABLED{true};
+  static constexpr bool RUNTIME_CONFIGURABLE{true};
+
+  using Callback = void (*)(RingT&);
+
+ private:
+  Callback data_needed_{nullptr};
+  Callback data_available_{nullptr};
+
+ public:
+  Notifier() = default;
+  Notifier(Callback data_needed, Callback data_available)
+      : data_needed_(data_needed), data_available_(data_available) {}
+
+  void set_data_needed(Callback callback) { data_needed_ = callback; }
+  void set_data_available(Callback callback) { data_available_ = callback; }
+
+  bool has_data_needed() const { return data_needed_ != nullptr; }
+  bool has_data_available() const { return data_available_ != nullptr; }
+  void data_needed(RingT& ring) { data_needed_(ring); }
+  void data_available(RingT& ring) { data_available_(ring); }
+};
+
+template <typename RingT>
+class Notifier<StdFunctionNotification, RingT> final {
+ public:
+  static constexpr bool ENABLED{true};
+  static constexpr bool RUNTIME_CONFIGURABLE{true};
+
+  using Callback = std::function<void(RingT&)>;
+
+ private:
+  Callback data_needed_{};
+  Callback data_available_{};
+
+ public:
+  Notifier() = default;
+  Notifier(Callback data_needed, Callback data_available)
+      : data_needed_(std::move(data_needed)), data_available_(std::move(data_available)) {}
+
+  void set_data_needed(Callback callback) { data_needed_ = std::move(callback); }
+  void set_data_available(Callback callback) { data_available_ = std::move(callback); }
+
+  bool has_data_needed() const { return bool(data_needed_); }
+  bool has_data_available() const { return bool(data_available_); }
+  void data_needed(RingT& ring) { data_needed_(ring); }
+  void data_available(RingT& ring) { data_available_(ring); }
+};
+
+template <typename DataNeededFn, typename DataAvailableFn, typename RingT>
+class Notifier<FunctorNotification<DataNeededFn, DataAvailableFn>, RingT> final {
+ public:
+  static constexpr bool ENABLED{true};
+  static constexpr bool RUNTIME_CONFIGURABLE{false};
+
+  using Callback = std::nullptr_t;
+
+ private:
+  [[no_unique_address]] FunctorNotification<DataNeededFn, DataAvailableFn> policy_{};
+
+ public:
+  Notifier() = default;
+  explicit Notifier(FunctorNotification<DataNeededFn, DataAvailableFn> policy)
+      : policy_(std::move(policy)) {}
+
+  constexpr bool has_data_needed() const { return true; }
+  constexpr bool has_data_available() const { return true; }
+  void data_needed(RingT& ring) { policy_.data_needed(ring); }
+  void data_available(RingT& ring) { policy_.data_available(ring); }
+};
+
+/**
+ * Thresholds of a RingBuffer's callbacks, and the state needed for edge triggering. Like the
+ * callbacks, these are only stored if the policy has callbacks, so that a RingBuffer without
+ * notification carries none of this state.
+ */
+template <typename PolicyT>
+struct NotificationThresholds final {
+  size_t data_available_threshold;
+  size_t data_needed_threshold;
+
+  // Occupancy seen by the most recent edge-triggered check. Each change in occupancy is claimed by
+  // exactly one thread via exchange(), so each crossing of a threshold fires exactly once.
+  std::atomic<size_t> last_notified_occupancy{0};
+
+  explicit NotificationThresholds(size_t threshold)
+      : data_available_threshold(threshold), data_needed_threshold(threshold) {}
+};
+
+template <>
+struct NotificationThresholds<NoNotification> final {
+  explicit constexpr NotificationThresholds(size_t /*threshold*/) {}
+};
+
+}  // namespace internal
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "base/except.h"
+#include "buffer/buffer.h"
+#include "buffer/buffer_view.h"
+
+namespace tvsc::buffer {
+
+/**
+ * Lock-free ring buffer of variable-length byte records for exactly one producer and exactly one
+ * consumer.
+ *
+ * RingBuffer and SpscRingBuffer hold fixed-size elements. To queue records that vary in size, like
+ * radio fragments, CAN frames or log lines, each element must be sized for the largest record, and
+ * most of that memory goes unused. This class instead stores each record as a LengthT length prefix
+ * followed by the record's bytes, packed one after another in a single byte array. Ten to twenty
+ * byte fragments take ten to twenty bytes, plus the prefix, rather than a full MTU.
+ *
+ * Records are never split across the end of the storage. This follows Simon Cooke's bip-buffer: if
+ * a record does not fit in the space left before the end of the storage, the producer writes it at
+ * the beginning instead, and it records the end of the valid data so that the consumer knows where
+ * to wrap. As a result, both sides work with contiguous spans. The producer can reserve() space and
+ * build a record in place, for example as the destination of a DMA transfer, and then commit() it.
+ * The consumer can borrow() a record, parse it in place, and then release() it. The cost is that
+ * the space skipped at the end of the storage is unusable until the consumer wraps.
+ *
+ * A record can be at most max_record_size() bytes, which is about half of the storage; see below.
+ * Records of zero bytes are not supported; committing zero bytes cancels the reservation.
+ *
+ * Like SpscRingBuffer, each position has a single writer, so they are published with release stores
+ * and read with acquire loads. Only tail drop (https://en.wikipedia.org/wiki/Tail_drop) is
+ * supported.
+ */
+template <size_t CAPACITY, typename LengthT = uint16_t>
+class RecordRingBuffer final {
+ public:
+  static constexpr size_t HEADER_SIZE{sizeof(LengthT)};
+
+ private:
+  static_assert(std::is_unsigned_v<LengthT>, "LengthT must be an unsigned integer type");
+  static_assert(CAPACITY / 2 > HEADER_SIZE,
+                "RecordRingBuffer must have room for at least one record of one byte");
+
+  // Unlike the other rings, these are offsets into storage_, not monotonically increasing counts.
+  // The ring is empty when they are equal. The producer never lets the write position catch up to
+  // the read position from behind, so equal positions never mean that the ring is full.
+  //
+  // When the producer wraps, it stores the end of the valid data in end_of_data_ before it
+  // publishes the new write position. The consumer only reads end_of_data_ while the write position
+  // is behind the read position, and the producer does not change it again until the consumer has
+  // wrapped as well.
+
+  // Producer side. Only the producer writes these.
+  std::atomic<size_t> write_position_{0};
+  std::atomic<size_t> end_of_data_{0};
+  size_t reserved_position_{0};
+  size_t reserved_size_{0};
+
+  // Consumer side. Only the consumer writes these.
+  std::atomic<size_t> read_position_{0};
+  size_t borrowed_position_{0};
+  size_t borrowed_size_{0};
+
+  Buffer<uint8_t, CAPACITY> storage_{};
+
+  void write_header(size_t position, size_t record_size) {
+    const LengthT length{static_cast<LengthT>(record_size)};
+    std::memcpy(storage_.data() + position, &length, HEADER_SIZE);
+  }
+
+  size_t read_header(size_t position) const {
+    LengthT length;
+    std::memcpy(&length, storage_.data() + position, HEADER_SIZE);
+    return length;
+  }
+
+  /**
+   * Position of the next record for the consumer, wrapping to the beginning of the storage if the
+   * consumer has reached the end of the valid data. Returns CAPACITY if the ring is empty.
+   */
+  size_t next_record_position() const {
+    const size_t read_position{read_position_.load(std::memory_order_relaxed)};
+    const size_t write_position{write_position_.load(std::memory_order_acquire)};
+    if (read_position == write_position) {
+      return CAPACITY;
+    }
+    if (write_position < read_position &&
+        read_position == end_of_data_.load(std::memory_order_relaxed)) {
+      return 0;
+    }
+    return read_position;
+  }
+
+ public:
+  RecordRingBuffer() = default;
+
+  RecordRingBuffer(const RecordRingBuffer&) = delete;
+  RecordRingBuffer& operator=(const RecordRingBuffer&) = delete;
+
+  constexpr size_t capacity() const { return CAPACITY; }
+
+  /**
+   * Largest record that can be stored, including when the ring is empty.
+   *
+   * Only the consumer moves the read position, so an empty ring cannot start over at the beginning
+   * of the storage. A record, with its header, must fit either between the shared position and the
+   * end of the storage, or, with the write position strictly behind the read position, before the
+   * shared position. Both are possible at every position only if the record takes at most half of
+   * the storage. A larger record could be refused forever, even though the ring is empty.
+   */
+  static constexpr size_t max_record_size() {
+    return std::min(CAPACITY / 2 - HEADER_SIZE,
+                    static_cast<size_t>(std::numeric_limits<LengthT>::max()));
+  }
+
+  /**
+   * Reserve contiguous space for a record of up to max_size bytes. On success, the returned view
+   * covers max_size writable bytes. If there is no contiguous space for a record of that size, the
+   * returned view is empty. Must only be called from the producer.
+   *
+   * The record is not visible to the consumer until commit() is called. Only a single reservation
+   * may be outstanding at a time; calling reserve() again replaces the previous reservation.
+   */
+  BufferView<uint8_t> reserve(size_t max_size) {
+    reserved_size_ = 0;
+    if (max_size == 0 || max_size > max_record_size()) {
+      return {};
+    }
+
+    const size_t total_size{HEADER_SIZE + max_size};
+    const size_t write_position{write_position_.load(std::memory_order_relaxed)};
+    const size_t read_position{read_position_.load(std::memory_order_acquire)};
+
+    if (write_position >= read_position) {
+      if (CAPACITY - write_position >= total_size) {
+        reserved_position_ = write_position;
+      } else if (read_position > total_size) {
+        // Not enough room before the end of the storage, but there is room at the beginning.
+        reserved_position_ = 0;
+      } else {
+        return {};
+      }
+    } else if (read_position - write_position > total_size) {
+      reserved_position_ = write_position;
+    } else {
+      return {};
+    }
+
+    reserved_size_ = max_size;
+    return storage_.view(reserved_position_ + HEADER_SIZE, max_size);
+  }
+
+  /**
+   * Publish the first record_size bytes of the current reservation as a record. record_size may be
+   * smaller than the reservation, but not larger. Committing zero bytes cancels the reservation.
+   */
+  void commit(size_t record_size) {
+    if (record_size > reserved_size_) {
+      throw std::logic_error("Attempt to commit more bytes than were reserved.");
+    }
+    reserved_size_ = 0;
+    if (record_size == 0) {
+      return;
+    }
+
+    write_header(reserved_position_, record_size);
+    const size_t write_position{write_position_.load(std::memory_order_relaxed)};
+    if (reserved_position_ != write_position) {
+      end_of_data_.store(write_position, std::memory_order_relaxed);
+    }
+    write_position_.store(reserved_position_ + HEADER_SIZE + record_size,
+                          std::memory_order_release);
+  }
+
+  /**
+   * Copy record into the ring as a single record. Returns false if the record is empty, too large,
+   * or there is no contiguous space for it.
+   */
+  bool supply(BufferView<const uint8_t> record) {
+    BufferView<uint8_t> dest{reserve(record.size())};
+    if (dest.empty()) {
+      return false;
+    }
+    std::memcpy(dest.data(), record.data(), record.size());
+    commit(record.size());
+    return true;
+  }
+
+  /**
+   * Borrow the oldest record without copying it. The returned view is empty if the ring is empty.
+   * The record remains in the ring until release() is called. Must only be called from the
+   * consumer.
+   */
+  BufferView<const uint8_t> borrow() {
+    borrowed_size_ = 0;
+    const size_t position{next_record_position()};
+    if (position == CAPACITY) {
+      return {};
+    }
+    borrowed_position_ = position;
+    borrowed_size_ = read_header(position);
+    return std::as_const(storage_).view(position + HEADER_SIZE, borrowed_size_);
+  }
+
+  /**
+   * Remove the record returned by the most recent borrow() from the ring. Returns false if there
+   * was no borrowed record.
+   */
+  bool release() {
+    if (borrowed_size_ == 0) {
+      return false;
+    }
+    read_position_.store(borrowed_position_ + HEADER_SIZE + borrowed_size_,
+                         std::memory_order_release);
+    borrowed_size_ = 0;
+    return true;
+  }
+
+  /**
+   * Copy the oldest record into dest and remove it from the ring.
+   *
+   * Returns the size of the record, or zero if the ring is empty. Throws std::overflow_error,
+   * leaving the record in the ring, if dest is too small to hold it.
+   */
+  size_t consume(BufferView<uint8_t> dest) {
+    const BufferView<const uint8_t> record{borrow()};
+    if (record.empty()) {
+      return 0;
+    }
+    if (record.size() > dest.size()) {
+      using std::to_string;
+      except<std::overflow_error>("dest has insufficient space (" + to_string(record.size()) +
+                                  " vs " + to_string(dest.size()) + ")");
+    }
+    std::memcpy(dest.data(), record.data(), record.size());
+    release();
+    return record.size();
+  }
+
+  /**
+   * Size of the oldest record, or zero if the ring is empty. Must only be called from the
+   * consumer.
+   */
+  size_t next_record_size() const {
+    const size_t position{next_record_position()};
+    return position == CAPACITY ? 0 : read_header(position);
+  }
+
+  bool empty() const {
+    return read_position_.load(std::memory_order_acquire) ==
+           write_position_.load(std::memory_order_acquire);
+  }
+};
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,254 @@
+#include "buffer/record_ring_buffer.h"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+#include "buffer/ring_buffer.h"
+#include "gtest/gtest.h"
+
+namespace tvsc::buffer {
+
+template <size_t SIZE>
+std::array<uint8_t, SIZE> make_record(uint8_t first) {
+  std::array<uint8_t, SIZE> record{};
+  for (size_t i = 0; i < SIZE; ++i) {
+    record[i] = static_cast<uint8_t>(first + i);
+  }
+  return record;
+}
+
+template <size_t SIZE, typename RingT>
+bool supply_record(RingT& ring, uint8_t first) {
+  const auto record{make_record<SIZE>(first)};
+  return ring.supply(record);
+}
+
+TEST(RecordRingBufferTest, NewRingIsEmpty) {
+  RecordRingBuffer<64> ring{};
+  EXPECT_TRUE(ring.empty());
+  EXPECT_EQ(0, ring.next_record_size());
+  EXPECT_TRUE(ring.borrow().empty());
+  EXPECT_FALSE(ring.release());
+}
+
+TEST(RecordRingBufferTest, CanSupplyAndConsumeRecordsOfDifferentSizes) {
+  RecordRingBuffer<64> ring{};
+  const auto short_record{make_record<3>(10)};
+  const auto long_record{make_record<17>(20)};
+  ASSERT_TRUE(ring.supply(short_record));
+  ASSERT_TRUE(ring.supply(long_record));
+
+  std::array<uint8_t, 32> dest{};
+  EXPECT_EQ(3, ring.next_record_size());
+  ASSERT_EQ(3, ring.consume(dest));
+  EXPECT_TRUE(std::equal(short_record.begin(), short_record.end(), dest.begin()));
+  ASSERT_EQ(17, ring.consume(dest));
+  EXPECT_TRUE(std::equal(long_record.begin(), long_record.end(), dest.begin()));
+  EXPECT_EQ(0, ring.consume(dest));
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(RecordRingBufferTest, CanBuildRecordInPlace) {
+  RecordRingBuffer<64> ring{};
+  BufferView<uint8_t> reservation{ring.reserve(16)};
+  ASSERT_EQ(16, reservation.size());
+  reservation[0] = 0xaa;
+  reservation[1] = 0xbb;
+  EXPECT_TRUE(ring.empty());
+  ring.commit(2);
+
+  BufferView<const uint8_t> record{ring.borrow()};
+  ASSERT_EQ(2, record.size());
+  EXPECT_EQ(0xaa, record[0]);
+  EXPECT_EQ(0xbb, record[1]);
+  EXPECT_TRUE(ring.release());
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(RecordRingBufferTest, CommittingZeroBytesCancelsReservation) {
+  RecordRingBuffer<64> ring{};
+  ASSERT_FALSE(ring.reserve(8).empty());
+  ring.commit(0);
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(RecordRingBufferTest, CannotCommitMoreThanReserved) {
+  RecordRingBuffer<64> ring{};
+  ASSERT_FALSE(ring.reserve(8).empty());
+  EXPECT_THROW(ring.commit(9), std::logic_error);
+}
+
+TEST(RecordRingBufferTest, RejectsEmptyAndOversizedRecords) {
+  RecordRingBuffer<16, uint8_t> ring{};
+  EXPECT_EQ(7, ring.max_record_size());
+  EXPECT_TRUE(ring.reserve(0).empty());
+  EXPECT_TRUE(ring.reserve(8).empty());
+  EXPECT_FALSE(ring.reserve(7).empty());
+}
+
+TEST(RecordRingBufferTest, EmptyRingAlwaysAcceptsLargestRecord) {
+  static constexpr size_t MAX_RECORD_SIZE{RecordRingBuffer<64>::max_record_size()};
+  static_assert(MAX_RECORD_SIZE == 30);
+  const std::array<uint8_t, MAX_RECORD_SIZE> padding{};
+  std::array<uint8_t, MAX_RECORD_SIZE> dest{};
+  for (size_t padding_size = 1; padding_size <= MAX_RECORD_SIZE; ++padding_size) {
+    RecordRingBuffer<64> ring{};
+    // A record of more than half the storage could be refused forever once the ring is empty at
+    // some positions, so it is never accepted.
+    EXPECT_TRUE(ring.reserve(40).empty());
+
+    // Leave the empty ring at a different position each time, then supply, consume and supply
+    // again the largest record.
+    ASSERT_TRUE(ring.supply(BufferView<const uint8_t>{padding.data(), padding_size}));
+    ASSERT_EQ(padding_size, ring.consume(dest));
+    for (uint8_t first : {0, 1, 2}) {
+      ASSERT_TRUE(supply_record<MAX_RECORD_SIZE>(ring, first)) << "padding " << padding_size;
+      ASSERT_EQ(MAX_RECORD_SIZE, ring.consume(dest));
+      EXPECT_EQ(make_record<MAX_RECORD_SIZE>(first), dest);
+    }
+  }
+}
+
+TEST(RecordRingBufferTest, ConsumeIntoSmallBufferThrowsAndKeepsRecord) {
+  RecordRingBuffer<64> ring{};
+  ASSERT_TRUE(supply_record<8>(ring, 0));
+  std::array<uint8_t, 4> small{};
+  EXPECT_THROW(ring.consume(small), std::overflow_error);
+  EXPECT_EQ(8, ring.next_record_size());
+}
+
+TEST(RecordRingBufferTest, RejectsRecordsWhenFull) {
+  // Each record takes 10 bytes including its header, leaving 3 bytes.
+  RecordRingBuffer<33> ring{};
+  ASSERT_TRUE(supply_record<8>(ring, 0));
+  ASSERT_TRUE(supply_record<8>(ring, 1));
+  ASSERT_TRUE(supply_record<8>(ring, 2));
+  EXPECT_FALSE(supply_record<8>(ring, 3));
+  // A smaller record still fits in the space remaining at the end.
+  EXPECT_TRUE(supply_record<1>(ring, 4));
+}
+
+TEST(RecordRingBufferTest, RecordsAreNeverSplitAcrossWrap) {
+  // Each record takes 10 bytes including its header, so the fourth record does not fit in the 2
+  // bytes left at the end and goes to the beginning.
+  RecordRingBuffer<32> ring{};
+  std::array<uint8_t, 8> dest{};
+  ASSERT_TRUE(supply_record<8>(ring, 0));
+  ASSERT_TRUE(supply_record<8>(ring, 10));
+  ASSERT_TRUE(supply_record<8>(ring, 20));
+
+  // The beginning is only free once the first record is consumed. The write position must stay
+  // strictly behind the read position, so a 9 byte record still does not fit.
+  EXPECT_TRUE(ring.reserve(8).empty());
+  ASSERT_EQ(8, ring.consume(dest));
+  EXPECT_TRUE(ring.reserve(9).empty());
+  EXPECT_TRUE(supply_record<7>(ring, 30));
+
+  for (uint8_t first : {10, 20}) {
+    ASSERT_EQ(8, ring.consume(dest));
+    EXPECT_EQ(make_record<8>(first), dest);
+  }
+  BufferView<const uint8_t> wrapped{ring.borrow()};
+  ASSERT_EQ(7, wrapped.size());
+  for (size_t i = 0; i < wrapped.size(); ++i) {
+    EXPECT_EQ(30 + i, wrapped[i]);
+  }
+  EXPECT_TRUE(ring.release());
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(RecordRingBufferTest, PreservesOrderAcrossManyLaps) {
+  // Large enough for any two consecutive records, wherever the wrap falls.
+  RecordRingBuffer<80> ring{};
+  std::array<uint8_t, 16> dest{};
+  for (int i = 0; i < 1000; ++i) {
+    const size_t size{static_cast<size_t>(1 + i % 16)};
+    BufferView<uint8_t> reservation{ring.reserve(size)};
+    ASSERT_EQ(size, reservation.size());
+    for (size_t j = 0; j < size; ++j) {
+      reservation[j] = static_cast<uint8_t>(i + j);
+    }
+    ring.commit(size);
+    if (i % 2 == 1) {
+      for (int k = i - 1; k <= i; ++k) {
+        const size_t expected_size{static_cast<size_t>(1 + k % 16)};
+        ASSERT_EQ(expected_size, ring.consume(dest));
+        for (size_t j = 0; j < expected_size; ++j) {
+          ASSERT_EQ(static_cast<uint8_t>(k + j), dest[j]);
+        }
+      }
+    }
+  }
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(RecordRingBufferTest, StoresMoreSmallRecordsThanFixedSizeRing) {
+  // The same 512 bytes of storage, holding 12 byte fragments with a 64 byte MTU.
+  static constexpr size_t STORAGE_SIZE{512};
+  static constexpr size_t MTU{64};
+  RecordRingBuffer<STORAGE_SIZE, uint8_t> records{};
+  RingBuffer<std::array<uint8_t, MTU>, 1, STORAGE_SIZE / MTU, true, NoNotification> fixed{};
+
+  const auto fragment{make_record<12>(0)};
+  size_t num_records{0};
+  while (records.supply(fragment)) {
+    ++num_records;
+  }
+  size_t num_fixed{0};
+  while (fixed.supply(std::array<uint8_t, MTU>{})) {
+    ++num_fixed;
+  }
+
+  EXPECT_EQ(39, num_records);
+  EXPECT_EQ(8, num_fixed);
+}
+
+/**
+ * A producer and a consumer thread transfer a long sequence of records of varying sizes through a
+ * small ring. The consumer must see every record exactly once, in order, and intact.
+ */
+TEST(RecordRingBufferTest, StressTestPreservesOrder) {
+  static constexpr uint32_t NUM_RECORDS{200'000};
+  static constexpr size_t MAX_SIZE{20};
+
+  RecordRingBuffer<128> ring{};
+
+  std::thread producer{[&ring]() {
+    uint32_t next{0};
+    while (next < NUM_RECORDS) {
+      const size_t size{1 + next % MAX_SIZE};
+      BufferView<uint8_t> reservation{ring.reserve(size)};
+      if (reservation.empty()) {
+        std::this_thread::yield();
+        continue;
+      }
+      for (size_t i = 0; i < size; ++i) {
+        reservation[i] = static_cast<uint8_t>(next + i);
+      }
+      ring.commit(size);
+      ++next;
+    }
+  }};
+
+  uint32_t expected{0};
+  while (expected < NUM_RECORDS) {
+    BufferView<const uint8_t> record{ring.borrow()};
+    if (record.empty()) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(1 + expected % MAX_SIZE, record.size());
+    for (size_t i = 0; i < record.size(); ++i) {
+      ASSERT_EQ(static_cast<uint8_t>(expected + i), record[i]);
+    }
+    ASSERT_TRUE(ring.release());
+    ++expected;
+  }
+  producer.join();
+
+  EXPECT_TRUE(ring.empty());
+}
+
+}  // namespace tvsc::buffer
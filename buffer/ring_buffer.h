@@ -5,9 +5,14 @@
 #include <atomic>
 #include <functional>
 #include <mutex>
+#include <stdexcept>
 #include <thread>
+#include <type_traits>
+#include <utility>
 
 #include "buffer/buffer.h"
+#include "buffer/notification.h"
+#include "buffer/statistics.h"
 
 namespace tvsc::buffer {
 
@@ -36,13 +41,41 @@ namespace tvsc::buffer {
  * (https://en.wikipedia.org/wiki/Tail_drop) queuing behavior. The second (PRIORITIZE_OLD_ELEMENTS
  * equals false) allows for streaming use cases where data loses importance as it ages (think
  * telemetry systems or video streaming).
+ *
+ * NotificationPolicyT selects how the callbacks are stored and invoked, and TRIGGER selects when
+ * they fire. See buffer/notification.h for the options. By default, the callbacks are
+ * std::function instances that are checked after every operation (level triggered). The thresholds
+ * for both callbacks default to a page, but can be changed with set_data_available_threshold() and
+ * set_data_needed_threshold().
+ *
+ * StatisticsPolicyT optionally records dropped elements, the high-water mark, an occupancy
+ * histogram and the time spent full. See buffer/statistics.h. By default, nothing is recorded.
+ *
+ * Element types need not be trivially copyable. The consume() and consume_bulk() overloads that
+ * take a pointer move elements out of the RingBuffer, and emplace(), supply(ElementT&&) and
+ * supply_bulk_move() construct or move elements into it, so that types like std::string are not
+ * deep copied on the way through. Elements that leave the RingBuffer are reset to a default
+ * constructed element so that they release their resources right away rather than when their slot
+ * is next written. Trivially copyable types are still transferred with memcpy(3). Note that if
+ * PRIORITIZE_OLD_ELEMENTS is false and the producer and consumer run concurrently, the elements
+ * must be trivially copyable, since the producer may overwrite an element while the consumer is
+ * still reading it.
  */
 template <typename ElementT, size_t PAGE_SIZE, size_t NUM_PAGES,
-          bool PRIORITIZE_OLD_ELEMENTS = true>
+          bool PRIORITIZE_OLD_ELEMENTS = true,
+          typename NotificationPolicyT = StdFunctionNotification,
+          NotificationTrigger TRIGGER = NotificationTrigger::LEVEL,
+          typename StatisticsPolicyT = NoStatistics>
 class RingBuffer final {
+ private:
+  using NotifierType = internal::Notifier<NotificationPolicyT, RingBuffer>;
+  using ThresholdsType = internal::NotificationThresholds<NotificationPolicyT>;
+  using StatisticsType = internal::StatisticsRecorder<StatisticsPolicyT>;
+
  public:
-  using DataNeededCallback = std::function<void(RingBuffer&)>;
-  using DataAvailableCallback = std::function<void(RingBuffer&)>;
+  using ElementType = ElementT;
+  using DataNeededCallback = typename NotifierType::Callback;
+  using DataAvailableCallback = typename NotifierType::Callback;
 
  private:
   // These pointers are monotonically increasing. They count the total number of elements written
@@ -53,25 +86,80 @@ class RingBuffer final {
   std::atomic<size_t> read_pointer_{0};
   std::atomic<size_t> write_pointer_{0};
 
-  std::array<Buffer<ElementT, PAGE_SIZE>, NUM_PAGES> buffers_{};
+  // Storage for all of the pages. The pages are laid out contiguously so that transfers that span
+  // page boundaries, including the wrap from the last page to the first, need at most two copies.
+  Buffer<ElementT, NUM_PAGES * PAGE_SIZE> elements_{};
+
+  // State for the zero-copy API. The number of elements handed out by the most recent reserve()
+  // that have not yet been committed, and the position and size of the most recent borrow() that
+  // has not yet been released.
+  size_t reserved_elements_{0};
+  size_t borrowed_read_pointer_{0};
+  size_t borrowed_elements_{0};
 
-  DataNeededCallback data_needed_callback_{};
-  DataAvailableCallback data_available_callback_{};
+  [[no_unique_address]] NotifierType notifier_{};
+  [[no_unique_address]] ThresholdsType thresholds_{PAGE_SIZE};
+  [[no_unique_address]] StatisticsType statistics_{};
 
   void check_data_available() {
-    // If we have an mtu's worth of data, signal the sink that it can read more data.
-    if (data_available_callback_) {
-      if (elements_available() >= mtu()) {
-        data_available_callback_(*this);
+    if constexpr (NotifierType::ENABLED) {
+      // If we have a threshold's worth of data, signal the sink that it can read more data.
+      if (notifier_.has_data_available()) {
+        if (elements_available() >= thresholds_.data_available_threshold) {
+          notifier_.data_available(*this);
+        }
       }
     }
   }
 
   void check_data_needed() {
-    // If we have space to store an mtu's worth of data, signal the source to provide more data.
-    if (data_needed_callback_) {
-      if (max_buffered_elements() - elements_available() >= mtu()) {
-        data_needed_callback_(*this);
+    if constexpr (NotifierType::ENABLED) {
+      // If we have space to store a threshold's worth of data, signal the source to provide more
+      // data.
+      if (notifier_.has_data_needed()) {
+        if (max_buffered_elements() - elements_available() >= thresholds_.data_needed_threshold) {
+          notifier_.data_needed(*this);
+        }
+      }
+    }
+  }
+
+  void check_threshold_crossings() {
+    const size_t occupancy{elements_available()};
+    const size_t previous_occupancy{thresholds_.last_notified_occupancy.exchange(occupancy)};
+    const size_t data_available_threshold{thresholds_.data_available_threshold};
+    const size_t data_needed_threshold{thresholds_.data_needed_threshold};
+
+    if (notifier_.has_data_available()) {
+      if (previous_occupancy < data_available_threshold && occupancy >= data_available_threshold) {
+        notifier_.data_available(*this);
+      }
+    }
+
+    if (notifier_.has_data_needed()) {
+      const size_t space{max_buffered_elements() - occupancy};
+      const size_t previous_space{max_buffered_elements() - previous_occupancy};
+      if (previous_space < data_needed_threshold && space >= data_needed_threshold) {
+        notifier_.data_needed(*this);
+      }
+    }
+  }
+
+  /**
+   * Record statistics and signal the source and sink, as appropriate, after an operation that
+   * changed the contents of the RingBuffer.
+   */
+  void notify() {
+    if constexpr (StatisticsType::ENABLED) {
+      statistics_.record_occupancy(elements_available(), max_buffered_elements());
+    }
+
+    if constexpr (NotifierType::ENABLED) {
+      if constexpr (TRIGGER == NotificationTrigger::LEVEL) {
+        check_data_available();
+        check_data_needed();
+      } else {
+        check_threshold_crossings();
       }
     }
   }
@@ -82,10 +170,151 @@ class RingBuffer final {
 
   size_t compute_pointer(size_t index, size_t offset) const { return index * PAGE_SIZE + offset; }
 
+  size_t compute_storage_offset(size_t index, size_t offset) const {
+    return (index % NUM_PAGES) * PAGE_SIZE + offset;
+  }
+
+  size_t compute_storage_offset(size_t pointer) const { return pointer % max_buffered_elements(); }
+
   size_t compute_elements_available(size_t read_pointer_value, size_t write_pointer_value) const {
     return write_pointer_value - read_pointer_value;
   }
 
+  /**
+   * Reset count elements, starting at pointer, so that they release any resources that they hold.
+   * This is a no-op for trivially destructible types.
+   */
+  void recycle(size_t pointer, size_t count) {
+    if constexpr (!std::is_trivially_destructible_v<ElementT>) {
+      for_each_span(pointer, count, [this](size_t storage_offset, size_t, size_t span_count) {
+        for (size_t i = 0; i < span_count; ++i) {
+          elements_.emplace(storage_offset + i);
+        }
+      });
+    }
+  }
+
+  /**
+   * Invoke copy(storage_offset, transfer_offset, count) for each contiguous span of storage
+   * covering count elements starting at pointer. The elements wrap from the end of the storage to
+   * the beginning at most once, so copy is called at most twice.
+   */
+  template <typename CopyFn>
+  void for_each_span(size_t pointer, size_t count, CopyFn&& copy) const {
+    const size_t storage_offset{compute_storage_offset(pointer)};
+    const size_t first_count{std::min(count, max_buffered_elements() - storage_offset)};
+    copy(storage_offset, 0, first_count);
+    if (count > first_count) {
+      copy(0, first_count, count - first_count);
+    }
+  }
+
+  /**
+   * Move count elements, starting at storage_offset, into dest. The elements are reset separately,
+   * by recycle().
+   */
+  void move_out(size_t storage_offset, size_t count, ElementT* dest) {
+    if constexpr (std::is_trivially_copyable_v<ElementT>) {
+      elements_.read_array(storage_offset, count, dest);
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        dest[i] = std::move(elements_[storage_offset + i]);
+      }
+    }
+  }
+
+  /**
+   * Remove count elements, starting at read_pointer_value, from the RingBuffer. Each contiguous span
+   * is passed to copy(storage_offset, transfer_offset, count), then the elements are reset, and the
+   * read pointer is moved past them.
+   *
+   * If PRIORITIZE_OLD_ELEMENTS is false, a producer may drop the elements, and write new ones in
+   * their slots, before the read pointer is updated. In that case, this returns false, and neither
+   * the elements that were dropped nor the new ones are removed or reset.
+   */
+  template <typename CopyFn>
+  bool remove_elements(size_t read_pointer_value, size_t count, CopyFn&& copy) {
+    if constexpr (PRIORITIZE_OLD_ELEMENTS || std::is_trivially_copyable_v<ElementT>) {
+      // Either only the consumer moves the read pointer, so the slots belong to the consumer until
+      // it does, or the elements are trivially copyable and may be overwritten by a concurrent
+      // producer, in which case the failed exchange below discards the copy.
+      for_each_span(read_pointer_value, count, copy);
+      recycle(read_pointer_value, count);
+      return read_pointer_.compare_exchange_strong(read_pointer_value, read_pointer_value + count);
+    } else {
+      // The producer and consumer cannot run concurrently with these elements, but the producer may
+      // have dropped them since they were borrowed. Claim them before moving them out.
+      if (!read_pointer_.compare_exchange_strong(read_pointer_value,
+                                                 read_pointer_value + count)) {
+        return false;
+      }
+      for_each_span(read_pointer_value, count, copy);
+      recycle(read_pointer_value, count);
+      return true;
+    }
+  }
+
+  template <typename CopyFn>
+  size_t consume_spans(size_t num_elements, CopyFn&& copy) {
+    size_t read_pointer_value{read_pointer_.load()};
+    size_t write_pointer_value{write_pointer_.load()};
+
+    size_t elements_consumed{std::min(
+        compute_elements_available(read_pointer_value, write_pointer_value), num_elements)};
+
+    if (elements_consumed > 0 && !remove_elements(read_pointer_value, elements_consumed, copy)) {
+      elements_consumed = 0;
+    }
+
+    notify();
+
+    return elements_consumed;
+  }
+
+  template <typename CopyFn>
+  size_t supply_spans(size_t num_elements, CopyFn&& copy) {
+    size_t read_pointer_value{read_pointer_.load()};
+    size_t write_pointer_value{write_pointer_.load()};
+
+    const size_t elements_available{
+        compute_elements_available(read_pointer_value, write_pointer_value)};
+
+    size_t elements_supplied{};
+    if constexpr (PRIORITIZE_OLD_ELEMENTS) {
+      elements_supplied = std::min(max_buffered_elements() - elements_available, num_elements);
+    } else {
+      elements_supplied = std::min(max_buffered_elements(), num_elements);
+    }
+
+    if (elements_supplied > 0) {
+      if constexpr (!PRIORITIZE_OLD_ELEMENTS) {
+        if (elements_available + elements_supplied > max_buffered_elements()) {
+          size_t new_read_pointer_value{read_pointer_value + elements_available +
+                                        elements_supplied - max_buffered_elements()};
+          if (read_pointer_.compare_exchange_strong(read_pointer_value, new_read_pointer_value)) {
+            statistics_.record_dropped(new_read_pointer_value - read_pointer_value);
+          } else {
+            elements_supplied = 0;
+          }
+        }
+      }
+
+      if (elements_supplied > 0) {
+        for_each_span(write_pointer_value, elements_supplied, copy);
+
+        if (!write_pointer_.compare_exchange_strong(write_pointer_value,
+                                                    write_pointer_value + elements_supplied)) {
+          elements_supplied = 0;
+        }
+      }
+    }
+
+    statistics_.record_dropped(num_elements - elements_supplied);
+    notify();
+
+    return elements_supplied;
+  }
+
   size_t compute_elements_to_accept(size_t num_elements, size_t write_buffer_offset,
                                     __attribute__((unused)) size_t read_pointer_value,
                                     __attribute__((unused)) size_t write_pointer_value) const {
@@ -103,22 +332,62 @@ class RingBuffer final {
   RingBuffer() = default;
 
   RingBuffer(DataNeededCallback data_needed_callback, DataAvailableCallback data_available_callback)
-      : data_needed_callback_(std::move(data_needed_callback)),
-        data_available_callback_(std::move(data_available_callback)) {
+    requires NotifierType::RUNTIME_CONFIGURABLE
+      : notifier_(std::move(data_needed_callback), std::move(data_available_callback)) {
+    check_data_available();
+    check_data_needed();
+  }
+
+  explicit RingBuffer(NotificationPolicyT policy)
+    requires(NotifierType::ENABLED && !NotifierType::RUNTIME_CONFIGURABLE)
+      : notifier_(std::move(policy)) {
     check_data_available();
     check_data_needed();
   }
 
-  void set_data_needed_callback(DataNeededCallback callback) {
-    data_needed_callback_ = std::move(callback);
+  void set_data_needed_callback(DataNeededCallback callback)
+    requires NotifierType::RUNTIME_CONFIGURABLE
+  {
+    notifier_.set_data_needed(std::move(callback));
     check_data_needed();
   }
 
-  void set_data_available_callback(DataAvailableCallback callback) {
-    data_available_callback_ = std::move(callback);
+  void set_data_available_callback(DataAvailableCallback callback)
+    requires NotifierType::RUNTIME_CONFIGURABLE
+  {
+    notifier_.set_data_available(std::move(callback));
     check_data_available();
   }
 
+  /**
+   * Number of elements that must be available before the sink is signalled. Defaults to a page.
+   */
+  size_t data_available_threshold() const
+    requires NotifierType::ENABLED
+  {
+    return thresholds_.data_available_threshold;
+  }
+  void set_data_available_threshold(size_t threshold)
+    requires NotifierType::ENABLED
+  {
+    thresholds_.data_available_threshold = threshold;
+  }
+
+  /**
+   * Amount of free space, in elements, that must be available before the source is signalled.
+   * Defaults to a page.
+   */
+  size_t data_needed_threshold() const
+    requires NotifierType::ENABLED
+  {
+    return thresholds_.data_needed_threshold;
+  }
+  void set_data_needed_threshold(size_t threshold)
+    requires NotifierType::ENABLED
+  {
+    thresholds_.data_needed_threshold = threshold;
+  }
+
   constexpr size_t mtu() const { return PAGE_SIZE; }
   constexpr size_t buffer_size() const { return PAGE_SIZE; }
   constexpr size_t num_buffers() const { return NUM_PAGES; }
@@ -127,7 +396,7 @@ class RingBuffer final {
   /**
    * Consume up to num_elements from the RingBuffer. The number of elements made available may be
    * fewer than num_elements based on number of elements available and how they align with the
-   * internal buffering.
+   * internal buffering. The elements are moved into dest.
    *
    * Returns the number of elements actually consumed.
    */
@@ -135,38 +404,67 @@ class RingBuffer final {
     size_t read_pointer_value{read_pointer_.load()};
     size_t write_pointer_value{write_pointer_.load()};
 
-    size_t read_buffer_index{compute_buffer_index(read_pointer_value)};
     size_t read_buffer_offset{compute_buffer_offset(read_pointer_value)};
 
     size_t elements_consumed{
         std::min(compute_elements_available(read_pointer_value, write_pointer_value),
                  std::min(PAGE_SIZE - read_buffer_offset, num_elements))};
 
-    if (elements_consumed > 0) {
-      buffers_[read_buffer_index % NUM_PAGES].read_array(read_buffer_offset, elements_consumed, dest);
-
-      read_buffer_offset += elements_consumed;
-      size_t new_read_pointer_value = compute_pointer(read_buffer_index, read_buffer_offset);
-      if (!read_pointer_.compare_exchange_strong(read_pointer_value, new_read_pointer_value)) {
-        elements_consumed = 0;
-      }
+    // The elements are within a page, so they are a single span.
+    if (elements_consumed > 0 &&
+        !remove_elements(read_pointer_value, elements_consumed,
+                         [this, dest](size_t storage_offset, size_t, size_t count) {
+                           move_out(storage_offset, count, dest);
+                         })) {
+      elements_consumed = 0;
     }
 
-    check_data_available();
-    check_data_needed();
+    notify();
 
     return elements_consumed;
   }
 
   /**
-   * Consume a buffer's worth of elements.
+   * Consume up to a buffer's worth of elements. The elements are transferred directly between the
+   * RingBuffer's storage and the buffer, and the transfer is not limited to the current page.
    */
   template <size_t NUM_ELEMENTS>
   size_t consume(Buffer<ElementT, NUM_ELEMENTS>& buffer) {
-    // TODO(james): Provide a direct implementation in terms of the Buffer API. Transferring
-    // directly between Buffer instances, especially if they have the same size, should be
-    // incredibly efficient.
-    return consume(NUM_ELEMENTS, buffer.data());
+    return consume_bulk(NUM_ELEMENTS, buffer);
+  }
+
+  /**
+   * Consume up to num_elements from the RingBuffer. Unlike consume(), this method is not limited to
+   * the current page. It transfers as many elements as are available, up to num_elements, using at
+   * most two contiguous copies and a single update of the read pointer. The callbacks are checked
+   * once per call, rather than once per page. The elements are moved into dest.
+   *
+   * Returns the number of elements actually consumed.
+   */
+  size_t consume_bulk(size_t num_elements, ElementT* dest) {
+    return consume_spans(num_elements,
+                         [this, dest](size_t storage_offset, size_t dest_offset, size_t count) {
+                           move_out(storage_offset, count, dest + dest_offset);
+                         });
+  }
+
+  /**
+   * Consume up to num_elements from the RingBuffer directly into buffer, starting at offset in the
+   * buffer. The number of elements is also limited by the space remaining in the buffer.
+   *
+   * Returns the number of elements actually consumed.
+   */
+  template <size_t NUM_ELEMENTS>
+  size_t consume_bulk(size_t num_elements, Buffer<ElementT, NUM_ELEMENTS>& buffer,
+                      size_t offset = 0) {
+    if (offset > NUM_ELEMENTS) {
+      throw std::out_of_range("Offset is past the end of the destination buffer.");
+    }
+    return consume_spans(
+        std::min(num_elements, NUM_ELEMENTS - offset),
+        [this, &buffer, offset](size_t storage_offset, size_t dest_offset, size_t count) {
+          buffer.copy_from(offset + dest_offset, elements_, storage_offset, count);
+        });
   }
 
   /**
@@ -192,7 +490,7 @@ class RingBuffer final {
                             0};
 
     if (elements_available) {
-      *dest = &buffers_[read_buffer_index % NUM_PAGES][read_buffer_offset];
+      *dest = &elements_[compute_storage_offset(read_buffer_index, read_buffer_offset)];
     }
 
     return elements_available;
@@ -207,22 +505,15 @@ class RingBuffer final {
     size_t read_pointer_value{read_pointer_.load()};
     size_t write_pointer_value{write_pointer_.load()};
 
-    size_t read_buffer_index{compute_buffer_index(read_pointer_value)};
-    size_t read_buffer_offset{compute_buffer_offset(read_pointer_value)};
-
     bool elements_available{compute_elements_available(read_pointer_value, write_pointer_value) >
                             0};
 
-    if (elements_available) {
-      read_buffer_offset += 1;
-      size_t new_read_pointer_value = compute_pointer(read_buffer_index, read_buffer_offset);
-      if (!read_pointer_.compare_exchange_strong(read_pointer_value, new_read_pointer_value)) {
-        elements_available = false;
-      }
+    if (elements_available &&
+        !remove_elements(read_pointer_value, 1, [](size_t, size_t, size_t) {})) {
+      elements_available = false;
     }
 
-    check_data_available();
-    check_data_needed();
+    notify();
 
     return elements_available;
   }
@@ -241,6 +532,10 @@ class RingBuffer final {
     size_t write_buffer_index{compute_buffer_index(write_pointer_value)};
     size_t write_buffer_offset{compute_buffer_offset(write_pointer_value)};
 
+    // Elements beyond the end of the current page are not dropped; the caller supplies them in the
+    // next call.
+    const size_t elements_requested{std::min(num_elements, PAGE_SIZE - write_buffer_offset)};
+
     const size_t elements_available{
         compute_elements_available(read_pointer_value, write_pointer_value)};
     size_t elements_supplied{compute_elements_to_accept(num_elements, write_buffer_offset,
@@ -255,15 +550,17 @@ class RingBuffer final {
         } else {
           new_read_pointer_value +=
               elements_available + elements_supplied - max_buffered_elements();
-          if (!read_pointer_.compare_exchange_strong(read_pointer_value, new_read_pointer_value)) {
+          if (read_pointer_.compare_exchange_strong(read_pointer_value, new_read_pointer_value)) {
+            statistics_.record_dropped(new_read_pointer_value - read_pointer_value);
+          } else {
             elements_supplied = 0;
           }
         }
       }
 
       if (elements_supplied > 0) {
-        buffers_[write_buffer_index % NUM_PAGES].write_array(write_buffer_offset, elements_supplied,
-                                                             src);
+        elements_.write_array(compute_storage_offset(write_buffer_index, write_buffer_offset),
+                              elements_supplied, src);
 
         write_buffer_offset += elements_supplied;
 
@@ -275,21 +572,56 @@ class RingBuffer final {
       }
     }
 
-    check_data_available();
-    check_data_needed();
+    statistics_.record_dropped(elements_requested - elements_supplied);
+    notify();
 
     return elements_supplied;
   }
 
   /**
-   * Supply a buffer's worth of data.
+   * Supply a buffer's worth of data. The elements are transferred directly between the buffer and
+   * the RingBuffer's storage, and the transfer is not limited to the current page.
    */
   template <size_t NUM_ELEMENTS>
   size_t supply(const Buffer<ElementT, NUM_ELEMENTS>& buffer) {
-    // TODO(james): Provide a direct implementation in terms of the Buffer API. Transferring
-    // directly between Buffer instances, especially if they have the same size, should be
-    // incredibly efficient.
-    return supply(NUM_ELEMENTS, buffer.data());
+    return supply_bulk(NUM_ELEMENTS, buffer);
+  }
+
+  /**
+   * Supply num_elements to the RingBuffer. Unlike supply(), this method is not limited to the
+   * current page. It transfers as many elements as the RingBuffer can accept, up to num_elements,
+   * using at most two contiguous copies and a single update of the write pointer. The callbacks are
+   * checked once per call, rather than once per page.
+   *
+   * If PRIORITIZE_OLD_ELEMENTS is false, the oldest elements are dropped to make room, but no more
+   * than max_buffered_elements() are accepted in a single call.
+   *
+   * Returns the number of elements actually copied into the RingBuffer.
+   */
+  size_t supply_bulk(size_t num_elements, const ElementT* src) {
+    return supply_spans(num_elements,
+                        [this, src](size_t storage_offset, size_t src_offset, size_t count) {
+                          elements_.write_array(storage_offset, count, src + src_offset);
+                        });
+  }
+
+  /**
+   * Supply num_elements directly from buffer, starting at offset in the buffer. The number of
+   * elements is also limited by the elements remaining in the buffer.
+   *
+   * Returns the number of elements actually copied into the RingBuffer.
+   */
+  template <size_t NUM_ELEMENTS>
+  size_t supply_bulk(size_t num_elements, const Buffer<ElementT, NUM_ELEMENTS>& buffer,
+                     size_t offset = 0) {
+    if (offset > NUM_ELEMENTS) {
+      throw std::out_of_range("Offset is past the end of the source buffer.");
+    }
+    return supply_spans(
+        std::min(num_elements, NUM_ELEMENTS - offset),
+        [this, &buffer, offset](size_t storage_offset, size_t src_offset, size_t count) {
+          elements_.copy_from(storage_offset, buffer, offset + src_offset, count);
+        });
   }
 
   /**
@@ -298,6 +630,181 @@ class RingBuffer final {
    */
   bool supply(const ElementT& src) { return supply(1, &src) == 1; }
 
+  /**
+   * Move a single element into the RingBuffer. Returns true if the element was accepted. If it was
+   * not, src is left unchanged.
+   */
+  bool supply(ElementT&& src) {
+    return supply_spans(1, [this, &src](size_t storage_offset, size_t, size_t) {
+             elements_[storage_offset] = std::move(src);
+           }) == 1;
+  }
+
+  /**
+   * Construct a single element in place in the RingBuffer from args. Returns true if there was
+   * room for the element.
+   */
+  template <typename... Args>
+  bool emplace(Args&&... args) {
+    return supply_spans(1, [this, &args...](size_t storage_offset, size_t, size_t) {
+             elements_.emplace(storage_offset, std::forward<Args>(args)...);
+           }) == 1;
+  }
+
+  /**
+   * Move up to num_elements from src into the RingBuffer. Like supply_bulk(), this method is not
+   * limited to the current page. Elements that are not accepted are left unchanged in src.
+   *
+   * Returns the number of elements actually moved into the RingBuffer.
+   */
+  size_t supply_bulk_move(size_t num_elements, ElementT* src) {
+    return supply_spans(num_elements,
+                        [this, src](size_t storage_offset, size_t src_offset, size_t count) {
+                          elements_.move_in_array(storage_offset, count, src + src_offset);
+                        });
+  }
+
+  /**
+   * Reserve space for up to num_elements in the RingBuffer so that they can be written in place,
+   * for example, as the destination of a DMA transfer. On success, *dest points to the first
+   * writable element in the current page. The reserved span never crosses a page boundary, so the
+   * number of elements reserved may be fewer than num_elements.
+   *
+   * If PRIORITIZE_OLD_ELEMENTS is true, the reservation is limited to the free space in the
+   * RingBuffer. If it is false, the oldest elements that overlap the reservation are dropped
+   * immediately, since their storage is about to be overwritten.
+   *
+   * The elements are not visible to consumers until commit() is called. Only a single reservation
+   * may be outstanding at a time; calling reserve() again replaces the previous reservation.
+   *
+   * Returns the number of elements reserved.
+   */
+  size_t reserve(size_t num_elements, ElementT** dest) {
+    size_t read_pointer_value{read_pointer_.load()};
+    size_t write_pointer_value{write_pointer_.load()};
+
+    size_t write_buffer_index{compute_buffer_index(write_pointer_value)};
+    size_t write_buffer_offset{compute_buffer_offset(write_pointer_value)};
+
+    const size_t elements_available{
+        compute_elements_available(read_pointer_value, write_pointer_value)};
+    size_t elements_reserved{compute_elements_to_accept(num_elements, write_buffer_offset,
+                                                        read_pointer_value, write_pointer_value)};
+
+    if constexpr (!PRIORITIZE_OLD_ELEMENTS) {
+      if (elements_reserved > 0 &&
+          elements_available + elements_reserved > max_buffered_elements()) {
+        size_t new_read_pointer_value{read_pointer_value + elements_available +
+                                      elements_reserved - max_buffered_elements()};
+        if (read_pointer_.compare_exchange_strong(read_pointer_value, new_read_pointer_value)) {
+          statistics_.record_dropped(new_read_pointer_value - read_pointer_value);
+        } else {
+          elements_reserved = 0;
+        }
+      }
+    }
+
+    if (elements_reserved > 0) {
+      *dest = elements_.data() + compute_storage_offset(write_buffer_index, write_buffer_offset);
+    }
+    reserved_elements_ = elements_reserved;
+
+    return elements_reserved;
+  }
+
+  /**
+   * Make num_elements of the current reservation visible to consumers. num_elements may be smaller
+   * than the number of elements reserved, but not larger. Any uncommitted portion of the
+   * reservation is released.
+   *
+   * Returns the number of elements committed.
+   */
+  size_t commit(size_t num_elements) {
+    if (num_elements > reserved_elements_) {
+      throw std::logic_error("Attempt to commit more elements than were reserved.");
+    }
+    reserved_elements_ = 0;
+
+    if (num_elements > 0) {
+      write_pointer_.fetch_add(num_elements);
+    }
+
+    notify();
+
+    return num_elements;
+  }
+
+  /**
+   * Borrow up to num_elements from the RingBuffer without copying them. On success, *src points to
+   * the first readable element in the current page. Like consume(), the span never crosses a page
+   * boundary, so the number of elements borrowed may be fewer than num_elements.
+   *
+   * The elements remain in the RingBuffer until release() is called. Only a single borrow may be
+   * outstanding at a time. Note that if PRIORITIZE_OLD_ELEMENTS is false, a producer may overwrite
+   * borrowed elements before they are released; release() reports this by releasing zero elements.
+   *
+   * Returns the number of elements borrowed.
+   */
+  size_t borrow(size_t num_elements, const ElementT** src) {
+    size_t read_pointer_value{read_pointer_.load()};
+    size_t write_pointer_value{write_pointer_.load()};
+
+    size_t read_buffer_index{compute_buffer_index(read_pointer_value)};
+    size_t read_buffer_offset{compute_buffer_offset(read_pointer_value)};
+
+    size_t elements_borrowed{
+        std::min(compute_elements_available(read_pointer_value, write_pointer_value),
+                 std::min(PAGE_SIZE - read_buffer_offset, num_elements))};
+
+    if (elements_borrowed > 0) {
+      *src = elements_.data() + compute_storage_offset(read_buffer_index, read_buffer_offset);
+    }
+    borrowed_read_pointer_ = read_pointer_value;
+    borrowed_elements_ = elements_borrowed;
+
+    return elements_borrowed;
+  }
+
+  /**
+   * Remove num_elements previously borrowed with borrow() from the RingBuffer. num_elements may be
+   * smaller than the number of elements borrowed, but not larger.
+   *
+   * Returns the number of elements released. This will be zero if the borrowed elements were
+   * overwritten by a producer in the meantime.
+   */
+  size_t release(size_t num_elements) {
+    if (num_elements > borrowed_elements_) {
+      throw std::logic_error("Attempt to release more elements than were borrowed.");
+    }
+    borrowed_elements_ = 0;
+
+    size_t elements_released{num_elements};
+    if (elements_released > 0 && !remove_elements(borrowed_read_pointer_, elements_released,
+                                                  [](size_t, size_t, size_t) {})) {
+      elements_released = 0;
+    }
+
+    notify();
+
+    return elements_released;
+  }
+
+  /**
+   * Snapshot of the statistics recorded for this RingBuffer. Only available if StatisticsPolicyT
+   * records statistics.
+   */
+  RingStatistics statistics() const
+    requires StatisticsType::ENABLED
+  {
+    return statistics_.counters().snapshot();
+  }
+
+  void reset_statistics()
+    requires StatisticsType::ENABLED
+  {
+    statistics_.counters().reset();
+  }
+
   size_t elements_available() const {
     size_t read_pointer_value{read_pointer_.load()};
     size_t write_pointer_value{write_pointer_.load()};
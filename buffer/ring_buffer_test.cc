@@ -1,6 +1,11 @@
 #include "buffer/ring_buffer.h"
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "buffer/buffer.h"
 #include "glog/logging.h"
@@ -372,6 +377,301 @@ TYPED_TEST(RingBufferTest, CapsWriteAtAnMtuWorthOfData) {
   EXPECT_EQ(2, source.num_supply_calls());
 }
 
+TYPED_TEST(RingBufferTest, CanReserveAndCommitPageInPlace) {
+  typename TestFixture::DataSinkT sink{};
+
+  typename TestFixture::RingBufferT ring{};
+  sink.connect(ring);
+
+  int* dest{nullptr};
+  const size_t elements_reserved{ring.reserve(ring.mtu(), &dest)};
+  ASSERT_EQ(ring.mtu(), elements_reserved);
+  ASSERT_NE(nullptr, dest);
+
+  for (size_t i = 0; i < elements_reserved; ++i) {
+    dest[i] = static_cast<int>(i);
+  }
+
+  // Reserved elements are not visible until they are committed.
+  EXPECT_TRUE(ring.empty());
+  EXPECT_FALSE(sink.data_available());
+
+  EXPECT_EQ(ring.mtu(), ring.commit(elements_reserved));
+  EXPECT_EQ(ring.mtu(), ring.elements_available());
+  EXPECT_TRUE(sink.data_available());
+
+  ASSERT_EQ(ring.mtu(), sink.try_consume());
+  for (size_t i = 0; i < ring.mtu(); ++i) {
+    EXPECT_EQ(static_cast<int>(i), sink.last_buffer_read()[i]);
+  }
+}
+
+TYPED_TEST(RingBufferTest, ReservationStopsAtPageBoundary) {
+  typename TestFixture::RingBufferT ring{};
+
+  ring.supply(1);
+
+  int* dest{nullptr};
+  EXPECT_EQ(ring.mtu() - 1, ring.reserve(ring.mtu(), &dest));
+}
+
+TYPED_TEST(RingBufferTest, CanCommitPartialReservation) {
+  typename TestFixture::RingBufferT ring{};
+
+  int* dest{nullptr};
+  ASSERT_EQ(ring.mtu(), ring.reserve(ring.mtu(), &dest));
+  dest[0] = 42;
+  EXPECT_EQ(1, ring.commit(1));
+  EXPECT_EQ(1, ring.elements_available());
+
+  int value{};
+  ASSERT_TRUE(ring.consume(&value));
+  EXPECT_EQ(42, value);
+}
+
+TYPED_TEST(RingBufferTest, CannotCommitMoreThanReserved) {
+  typename TestFixture::RingBufferT ring{};
+
+  int* dest{nullptr};
+  ASSERT_EQ(1, ring.reserve(1, &dest));
+  EXPECT_THROW(ring.commit(2), std::logic_error);
+}
+
+TYPED_TEST(RingBufferTest, ReservationRespectsCapacityWhenPrioritizingOldElements) {
+  typename TestFixture::DataSourceT source{};
+
+  typename TestFixture::RingBufferT ring{};
+  source.connect(ring);
+
+  ASSERT_EQ(ring.max_buffered_elements(), source.try_supply(ring.max_buffered_elements()));
+
+  int* dest{nullptr};
+  EXPECT_EQ(0, ring.reserve(1, &dest));
+}
+
+TYPED_TEST(RingBufferTest, CanBorrowAndReleaseInPlace) {
+  typename TestFixture::DataSourceT source{};
+
+  typename TestFixture::RingBufferT ring{};
+  source.connect(ring);
+
+  ASSERT_EQ(ring.mtu(), source.try_supply(ring.mtu()));
+
+  const int* src{nullptr};
+  const size_t elements_borrowed{ring.borrow(ring.mtu(), &src)};
+  ASSERT_EQ(ring.mtu(), elements_borrowed);
+
+  int expected_element = source.prev_element();
+  for (size_t i = 0; i < elements_borrowed; ++i) {
+    EXPECT_EQ(expected_element, src[i]);
+    ++expected_element;
+  }
+
+  // Borrowed elements stay in the ring until they are released.
+  EXPECT_EQ(ring.mtu(), ring.elements_available());
+
+  source.signal_data_needed();
+  EXPECT_EQ(ring.mtu(), ring.release(elements_borrowed));
+  EXPECT_TRUE(ring.empty());
+  EXPECT_TRUE(source.data_needed());
+}
+
+TYPED_TEST(RingBufferTest, BorrowOfEmptyRingReturnsNothing) {
+  typename TestFixture::RingBufferT ring{};
+
+  const int* src{nullptr};
+  EXPECT_EQ(0, ring.borrow(ring.mtu(), &src));
+  EXPECT_EQ(nullptr, src);
+}
+
+TYPED_TEST(RingBufferTest, CannotReleaseMoreThanBorrowed) {
+  typename TestFixture::RingBufferT ring{};
+
+  ring.supply(1);
+
+  const int* src{nullptr};
+  ASSERT_EQ(1, ring.borrow(ring.mtu(), &src));
+  EXPECT_THROW(ring.release(2), std::logic_error);
+}
+
+TYPED_TEST(PrioritizeNewRingBufferTest,
+           ReservationDropsOldestElementsIfPrioritizeOldElementsIsFalse) {
+  typename TestFixture::DataSourceT source{};
+
+  typename TestFixture::RingBufferT ring{};
+  source.connect(ring);
+
+  ASSERT_EQ(ring.max_buffered_elements(), source.try_supply(ring.max_buffered_elements()));
+
+  int* dest{nullptr};
+  ASSERT_EQ(ring.mtu(), ring.reserve(ring.mtu(), &dest));
+  EXPECT_EQ(ring.max_buffered_elements() - ring.mtu(), ring.elements_available());
+
+  ring.commit(ring.mtu());
+  EXPECT_TRUE(ring.full());
+}
+
+TYPED_TEST(PrioritizeNewRingBufferTest, ReleaseOfOverwrittenElementsReleasesNothing) {
+  typename TestFixture::DataSourceT source{};
+
+  typename TestFixture::RingBufferT ring{};
+  source.connect(ring);
+
+  ASSERT_EQ(ring.max_buffered_elements(), source.try_supply(ring.max_buffered_elements()));
+
+  const int* src{nullptr};
+  ASSERT_EQ(ring.mtu(), ring.borrow(ring.mtu(), &src));
+
+  ASSERT_EQ(ring.mtu(), source.try_supply(ring.mtu()));
+
+  EXPECT_EQ(0, ring.release(ring.mtu()));
+  EXPECT_TRUE(ring.full());
+}
+
+TYPED_TEST(RingBufferTest, BulkSupplyAndConsumeSpanPages) {
+  typename TestFixture::DataSinkT sink{};
+
+  typename TestFixture::RingBufferT ring{};
+  sink.connect(ring);
+
+  const size_t num_elements{ring.max_buffered_elements()};
+  std::vector<int> src(num_elements);
+  for (size_t i = 0; i < num_elements; ++i) {
+    src[i] = static_cast<int>(i);
+  }
+
+  EXPECT_EQ(num_elements, ring.supply_bulk(num_elements, src.data()));
+  EXPECT_TRUE(ring.full());
+  EXPECT_TRUE(sink.data_available());
+
+  std::vector<int> dest(num_elements);
+  EXPECT_EQ(num_elements, ring.consume_bulk(num_elements, dest.data()));
+  EXPECT_TRUE(ring.empty());
+  EXPECT_EQ(src, dest);
+}
+
+TYPED_TEST(RingBufferTest, BulkSupplyAndConsumeWrapAroundEndOfStorage) {
+  typename TestFixture::RingBufferT ring{};
+
+  // Move the pointers so that the next transfer starts in the middle of the last page.
+  const size_t lead{ring.max_buffered_elements() - ring.mtu() / 2 - 1};
+  std::vector<int> filler(lead);
+  ASSERT_EQ(lead, ring.supply_bulk(lead, filler.data()));
+  ASSERT_EQ(lead, ring.consume_bulk(lead, filler.data()));
+
+  const size_t num_elements{ring.max_buffered_elements()};
+  std::vector<int> src(num_elements);
+  for (size_t i = 0; i < num_elements; ++i) {
+    src[i] = static_cast<int>(i) + 1000;
+  }
+
+  EXPECT_EQ(num_elements, ring.supply_bulk(num_elements, src.data()));
+
+  std::vector<int> dest(num_elements);
+  EXPECT_EQ(num_elements, ring.consume_bulk(num_elements, dest.data()));
+  EXPECT_EQ(src, dest);
+}
+
+TYPED_TEST(RingBufferTest, BulkSupplyStopsWhenFull) {
+  typename TestFixture::RingBufferT ring{};
+
+  ring.supply(1);
+
+  const size_t num_elements{ring.max_buffered_elements()};
+  std::vector<int> src(num_elements);
+  EXPECT_EQ(num_elements - 1, ring.supply_bulk(num_elements, src.data()));
+  EXPECT_TRUE(ring.full());
+}
+
+TYPED_TEST(RingBufferTest, BulkConsumeOfEmptyRingConsumesNothing) {
+  typename TestFixture::RingBufferT ring{};
+
+  int value{};
+  EXPECT_EQ(0, ring.consume_bulk(1, &value));
+}
+
+TYPED_TEST(RingBufferTest, CanTransferDirectlyBetweenBuffers) {
+  static constexpr size_t NUM_ELEMENTS{TypeParam::buffer_size + 1};
+
+  typename TestFixture::RingBufferT ring{};
+
+  Buffer<int, NUM_ELEMENTS> src{};
+  for (size_t i = 0; i < NUM_ELEMENTS; ++i) {
+    src[i] = static_cast<int>(i) + 1;
+  }
+
+  // A Buffer that is larger than a page can be supplied in one call.
+  EXPECT_EQ(NUM_ELEMENTS, ring.supply(src));
+  EXPECT_EQ(NUM_ELEMENTS, ring.elements_available());
+
+  Buffer<int, NUM_ELEMENTS + 1> dest{};
+  EXPECT_EQ(NUM_ELEMENTS, ring.consume_bulk(NUM_ELEMENTS, dest, 1));
+  EXPECT_EQ(0, dest[0]);
+  for (size_t i = 0; i < NUM_ELEMENTS; ++i) {
+    EXPECT_EQ(src[i], dest[i + 1]);
+  }
+}
+
+TYPED_TEST(RingBufferTest, BufferTransferIsLimitedBySpaceInBuffer) {
+  typename TestFixture::RingBufferT ring{};
+
+  std::vector<int> src(ring.max_buffered_elements());
+  ASSERT_EQ(src.size(), ring.supply_bulk(src.size(), src.data()));
+
+  Buffer<int, 4> dest{};
+  EXPECT_EQ(2, ring.consume_bulk(ring.max_buffered_elements(), dest, 2));
+}
+
+TYPED_TEST(RingBufferTest, BufferTransferIsLimitedByElementsInBuffer) {
+  typename TestFixture::RingBufferT ring{};
+
+  Buffer<int, 4> src{};
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<int>(i);
+  }
+  EXPECT_EQ(2, ring.supply_bulk(ring.max_buffered_elements(), src, 2));
+  EXPECT_EQ(2, ring.elements_available());
+  EXPECT_THROW(ring.supply_bulk(1, src, 5), std::out_of_range);
+  EXPECT_EQ(2, ring.elements_available());
+
+  int element{};
+  ASSERT_EQ(1, ring.consume(1, &element));
+  EXPECT_EQ(2, element);
+}
+
+TYPED_TEST(PrioritizeNewRingBufferTest, OverlongBufferSupplyDoesNotDropElements) {
+  typename TestFixture::RingBufferT ring{};
+
+  std::vector<int> elements(ring.max_buffered_elements());
+  ASSERT_EQ(elements.size(), ring.supply_bulk(elements.size(), elements.data()));
+
+  // Only one element remains in src past the offset, so only one old element is dropped.
+  Buffer<int, 2> src{};
+  EXPECT_EQ(1, ring.supply_bulk(ring.max_buffered_elements(), src, 1));
+  EXPECT_EQ(ring.max_buffered_elements(), ring.elements_available());
+}
+
+TYPED_TEST(PrioritizeNewRingBufferTest,
+           BulkSupplyDropsOldestElementsIfPrioritizeOldElementsIsFalse) {
+  typename TestFixture::RingBufferT ring{};
+
+  const size_t num_elements{ring.max_buffered_elements()};
+  std::vector<int> src(num_elements);
+  for (size_t i = 0; i < num_elements; ++i) {
+    src[i] = static_cast<int>(i);
+  }
+  ASSERT_EQ(num_elements, ring.supply_bulk(num_elements, src.data()));
+
+  static constexpr int NEWEST{-1};
+  EXPECT_EQ(1, ring.supply_bulk(1, &NEWEST));
+  EXPECT_TRUE(ring.full());
+
+  std::vector<int> dest(num_elements);
+  ASSERT_EQ(num_elements, ring.consume_bulk(num_elements, dest.data()));
+  EXPECT_EQ(1, dest[0]);
+  EXPECT_EQ(NEWEST, dest[num_elements - 1]);
+}
+
 TYPED_TEST(PrioritizeNewRingBufferTest, SourceCanOverfillRingIfPrioritizeOldElementsIsFalse) {
   typename TestFixture::DataSourceT source{};
   typename TestFixture::DataSinkT sink{};
@@ -438,4 +738,373 @@ TYPED_TEST(PrioritizeNewRingBufferTest,
   }
 }
 
+int function_pointer_data_needed_count{0};
+int function_pointer_data_available_count{0};
+
+template <typename RingT>
+void count_data_needed(RingT& /*ring*/) {
+  ++function_pointer_data_needed_count;
+}
+
+template <typename RingT>
+void count_data_available(RingT& /*ring*/) {
+  ++function_pointer_data_available_count;
+}
+
+struct CountingFunctor final {
+  int* count;
+
+  template <typename RingT>
+  void operator()(RingT& /*ring*/) {
+    ++*count;
+  }
+};
+
+TEST(RingBufferNotificationTest, NoNotificationRingCarriesNoCallbacks) {
+  using RingT = RingBuffer<int, 4, 4, true, NoNotification>;
+  EXPECT_LT(sizeof(RingT), sizeof(RingBuffer<int, 4, 4>));
+  // Nothing but the storage, the read and write pointers, and the state of the zero-copy API. In
+  // particular, no thresholds.
+  EXPECT_EQ(sizeof(Buffer<int, 16>) + 2 * sizeof(std::atomic<size_t>) + 3 * sizeof(size_t),
+            sizeof(RingT));
+
+  RingT ring{};
+  EXPECT_TRUE(ring.supply(1));
+  int value{};
+  EXPECT_TRUE(ring.consume(&value));
+  EXPECT_EQ(1, value);
+}
+
+TEST(RingBufferNotificationTest, CanUseFunctionPointerCallbacks) {
+  using RingT = RingBuffer<int, 4, 4, true, FunctionPointerNotification>;
+  function_pointer_data_needed_count = 0;
+  function_pointer_data_available_count = 0;
+
+  RingT ring{&count_data_needed<RingT>, &count_data_available<RingT>};
+  EXPECT_EQ(1, function_pointer_data_needed_count);
+  EXPECT_EQ(0, function_pointer_data_available_count);
+
+  std::array<int, 4> page{};
+  ASSERT_EQ(4, ring.supply(page.size(), page.data()));
+  EXPECT_EQ(1, function_pointer_data_available_count);
+}
+
+TEST(RingBufferNotificationTest, CanUseFunctorCallbacks) {
+  using PolicyT = FunctorNotification<CountingFunctor, CountingFunctor>;
+  using RingT = RingBuffer<int, 4, 4, true, PolicyT>;
+
+  int data_needed_count{0};
+  int data_available_count{0};
+  RingT ring{PolicyT{CountingFunctor{&data_needed_count}, CountingFunctor{&data_available_count}}};
+  EXPECT_EQ(1, data_needed_count);
+  EXPECT_EQ(0, data_available_count);
+
+  std::array<int, 4> page{};
+  ASSERT_EQ(4, ring.supply(page.size(), page.data()));
+  EXPECT_EQ(1, data_available_count);
+}
+
+TEST(RingBufferNotificationTest, LevelTriggeringFiresOnEveryOperationAboveThreshold) {
+  RingBuffer<int, 1, 16> ring{};
+  ring.set_data_available_threshold(8);
+
+  int data_available_count{0};
+  ring.set_data_available_callback([&data_available_count](auto& /*ring*/) {
+    ++data_available_count;
+  });
+
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(ring.supply(i));
+  }
+  EXPECT_EQ(9, data_available_count);
+}
+
+TEST(RingBufferNotificationTest, EdgeTriggeringFiresOncePerThresholdCrossing) {
+  using RingT = RingBuffer<int, 1, 16, true, StdFunctionNotification, NotificationTrigger::EDGE>;
+  RingT ring{};
+  ring.set_data_available_threshold(8);
+  ring.set_data_needed_threshold(12);
+
+  int data_needed_count{0};
+  int data_available_count{0};
+  ring.set_data_needed_callback([&data_needed_count](RingT& /*ring*/) { ++data_needed_count; });
+  ring.set_data_available_callback(
+      [&data_available_count](RingT& /*ring*/) { ++data_available_count; });
+
+  // Setting the data needed callback signals the source once, since the ring is empty.
+  ASSERT_EQ(1, data_needed_count);
+  data_needed_count = 0;
+
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(ring.supply(i));
+  }
+  EXPECT_EQ(1, data_available_count);
+  EXPECT_EQ(0, data_needed_count);
+
+  int value{};
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(ring.consume(&value));
+  }
+  EXPECT_EQ(1, data_available_count);
+  EXPECT_EQ(1, data_needed_count);
+
+  // Crossing the threshold again fires again.
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(ring.supply(i));
+  }
+  EXPECT_EQ(2, data_available_count);
+}
+
+/**
+ * Clock whose time only moves when a test advances it.
+ */
+struct ManualClock final {
+  using rep = int64_t;
+  using period = std::micro;
+  using duration = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<ManualClock, duration>;
+  static constexpr bool is_steady{true};
+
+  static inline time_point current_time{};
+
+  static time_point now() { return current_time; }
+  static void advance(duration d) { current_time += d; }
+};
+
+template <bool PRIORITIZE_OLD_ELEMENTS>
+using StatisticsRing = RingBuffer<int, 4, 2, PRIORITIZE_OLD_ELEMENTS, NoNotification,
+                                  NotificationTrigger::LEVEL, RecordStatistics<ManualClock>>;
+
+TEST(RingBufferStatisticsTest, NoStatisticsRingCarriesNoCounters) {
+  using WithoutStatistics = RingBuffer<int, 4, 2, true, NoNotification>;
+  EXPECT_EQ(sizeof(WithoutStatistics),
+            (sizeof(RingBuffer<int, 4, 2, true, NoNotification, NotificationTrigger::LEVEL,
+                               NoStatistics>)));
+  EXPECT_LT(sizeof(WithoutStatistics), sizeof(StatisticsRing<true>));
+}
+
+TEST(RingBufferStatisticsTest, CountsElementsRefusedWhenFull) {
+  StatisticsRing<true> ring{};
+  std::array<int, 8> elements{};
+  ASSERT_EQ(8, ring.supply_bulk(elements.size(), elements.data()));
+  EXPECT_EQ(0, ring.statistics().elements_dropped);
+
+  EXPECT_FALSE(ring.supply(1));
+  EXPECT_EQ(0, ring.supply_bulk(3, elements.data()));
+  EXPECT_EQ(4, ring.statistics().elements_dropped);
+}
+
+TEST(RingBufferStatisticsTest, PageBoundaryIsNotCountedAsDrop) {
+  StatisticsRing<true> ring{};
+  std::array<int, 8> elements{};
+  ASSERT_EQ(4, ring.supply(elements.size(), elements.data()));
+  EXPECT_EQ(0, ring.statistics().elements_dropped);
+}
+
+TEST(RingBufferStatisticsTest, CountsElementsOverwritten) {
+  StatisticsRing<false> ring{};
+  std::array<int, 8> elements{};
+  ASSERT_EQ(8, ring.supply_bulk(elements.size(), elements.data()));
+  EXPECT_TRUE(ring.supply(1));
+  EXPECT_EQ(3, ring.supply(3, elements.data()));
+  EXPECT_EQ(4, ring.statistics().elements_dropped);
+
+  int* dest{};
+  ASSERT_EQ(4, ring.reserve(4, &dest));
+  EXPECT_EQ(8, ring.statistics().elements_dropped);
+}
+
+TEST(RingBufferStatisticsTest, TracksHighWaterMarkAndHistogram) {
+  StatisticsRing<true> ring{};
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(ring.supply(i));
+  }
+  int value{};
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(ring.consume(&value));
+  }
+  const RingStatistics statistics{ring.statistics()};
+  EXPECT_EQ(5, statistics.high_water_mark);
+
+  // Ten operations, with occupancies 1, 2, 3, 4, 5, 4, 3, 2, 1, 0. The eight buckets span the
+  // occupancies 0 through 8, so the first bucket holds both 0 and 1.
+  uint32_t total{0};
+  for (uint32_t count : statistics.occupancy_histogram) {
+    total += count;
+  }
+  EXPECT_EQ(10, total);
+  EXPECT_EQ(3, statistics.occupancy_histogram[0]);
+  EXPECT_EQ(2, statistics.occupancy_histogram[1]);
+  EXPECT_EQ(1, statistics.occupancy_histogram[4]);
+  EXPECT_EQ(0, statistics.occupancy_histogram[7]);
+
+  ring.reset_statistics();
+  EXPECT_EQ(0, ring.statistics().high_water_mark);
+}
+
+TEST(RingBufferStatisticsTest, MeasuresTimeFull) {
+  using namespace std::chrono_literals;
+  StatisticsRing<true> ring{};
+  std::array<int, 8> elements{};
+
+  ASSERT_EQ(8, ring.supply_bulk(elements.size(), elements.data()));
+  ManualClock::advance(250us);
+  EXPECT_FALSE(ring.supply(1));
+  ManualClock::advance(250us);
+  ASSERT_EQ(2, ring.consume_bulk(2, elements.data()));
+  ManualClock::advance(1000us);
+  EXPECT_EQ(500, ring.statistics().time_full_us);
+}
+
+RingCounters global_counters{};
+
+TEST(RingBufferStatisticsTest, CanRecordIntoExternalCounters) {
+  using RingT = RingBuffer<int, 4, 2, true, NoNotification, NotificationTrigger::LEVEL,
+                           RecordStatisticsTo<global_counters, ManualClock>>;
+  EXPECT_EQ(sizeof(RingBuffer<int, 4, 2, true, NoNotification>), sizeof(RingT));
+
+  RingT ring{};
+  std::array<int, 10> elements{};
+  ASSERT_EQ(8, ring.supply_bulk(elements.size(), elements.data()));
+  EXPECT_EQ(2, global_counters.elements_dropped.load());
+  EXPECT_EQ(8, global_counters.high_water_mark.load());
+  EXPECT_EQ(2, ring.statistics().elements_dropped);
+}
+
+/**
+ * Element that counts how often it is copied, standing in for types like std::string where a copy
+ * means an allocation.
+ */
+class CopyCountingElement final {
+ private:
+  std::vector<int> values_{};
+
+ public:
+  static inline size_t copy_count{0};
+
+  CopyCountingElement() = default;
+  explicit CopyCountingElement(int value) : values_{value} {}
+
+  CopyCountingElement(const CopyCountingElement& rhs) : values_(rhs.values_) { ++copy_count; }
+  CopyCountingElement(CopyCountingElement&& rhs) noexcept = default;
+
+  CopyCountingElement& operator=(const CopyCountingElement& rhs) {
+    values_ = rhs.values_;
+    ++copy_count;
+    return *this;
+  }
+  CopyCountingElement& operator=(CopyCountingElement&& rhs) noexcept = default;
+
+  int value() const { return values_.empty() ? -1 : values_.front(); }
+};
+
+TEST(RingBufferMoveTest, MovesElementsWithoutCopying) {
+  RingBuffer<CopyCountingElement, 2, 2, true, NoNotification> ring{};
+  CopyCountingElement::copy_count = 0;
+
+  CopyCountingElement element{1};
+  EXPECT_TRUE(ring.supply(std::move(element)));
+  EXPECT_TRUE(ring.emplace(2));
+  std::array<CopyCountingElement, 2> elements{CopyCountingElement{3}, CopyCountingElement{4}};
+  EXPECT_EQ(2, ring.supply_bulk_move(elements.size(), elements.data()));
+
+  std::array<CopyCountingElement, 4> consumed{};
+  EXPECT_EQ(1, ring.consume(1, consumed.data()));
+  EXPECT_EQ(3, ring.consume_bulk(3, consumed.data() + 1));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(i + 1, consumed[i].value());
+  }
+  EXPECT_EQ(0, CopyCountingElement::copy_count);
+}
+
+TEST(RingBufferMoveTest, SupportsMoveOnlyElements) {
+  RingBuffer<std::unique_ptr<int>, 2, 2, true, NoNotification> ring{};
+  std::unique_ptr<int> consumed{};
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(ring.emplace(new int{i}));
+    }
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(ring.consume(&consumed));
+      ASSERT_NE(nullptr, consumed);
+      EXPECT_EQ(i, *consumed);
+    }
+  }
+}
+
+TEST(RingBufferMoveTest, RefusedElementIsNotMoved) {
+  RingBuffer<std::unique_ptr<int>, 1, 1, true, NoNotification> ring{};
+  ASSERT_TRUE(ring.emplace(new int{1}));
+  auto element{std::make_unique<int>(2)};
+  EXPECT_FALSE(ring.supply(std::move(element)));
+  EXPECT_NE(nullptr, element);
+}
+
+TEST(RingBufferMoveTest, SupplyBulkMoveWrapsAround) {
+  RingBuffer<std::unique_ptr<int>, 2, 2, true, NoNotification> ring{};
+  std::array<std::unique_ptr<int>, 4> elements{};
+  ASSERT_TRUE(ring.emplace(new int{0}));
+  ASSERT_TRUE(ring.emplace(new int{0}));
+  ASSERT_EQ(2, ring.consume_bulk(2, elements.data()));
+
+  for (int i = 0; i < 4; ++i) {
+    elements[i] = std::make_unique<int>(i);
+  }
+  ASSERT_EQ(4, ring.supply_bulk_move(elements.size(), elements.data()));
+  std::array<std::unique_ptr<int>, 4> consumed{};
+  ASSERT_EQ(4, ring.consume_bulk(consumed.size(), consumed.data()));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(i, *consumed[i]);
+  }
+}
+
+TEST(RingBufferMoveTest, ReleasesResourcesOfRemovedElements) {
+  RingBuffer<std::shared_ptr<int>, 2, 2, true, NoNotification> ring{};
+  auto shared{std::make_shared<int>(1)};
+
+  ASSERT_TRUE(ring.supply(shared));
+  ASSERT_TRUE(ring.pop());
+  EXPECT_EQ(1, shared.use_count());
+
+  ASSERT_TRUE(ring.supply(shared));
+  const std::shared_ptr<int>* borrowed{};
+  ASSERT_EQ(1, ring.borrow(1, &borrowed));
+  ASSERT_EQ(1, ring.release(1));
+  EXPECT_EQ(1, shared.use_count());
+
+  ASSERT_TRUE(ring.supply(shared));
+  {
+    std::shared_ptr<int> consumed{};
+    ASSERT_TRUE(ring.consume(&consumed));
+    EXPECT_EQ(2, shared.use_count());
+  }
+  EXPECT_EQ(1, shared.use_count());
+
+  ASSERT_TRUE(ring.supply(shared));
+  {
+    Buffer<std::shared_ptr<int>, 1> consumed{};
+    ASSERT_EQ(1, ring.consume(consumed));
+    EXPECT_EQ(2, shared.use_count());
+  }
+  EXPECT_EQ(1, shared.use_count());
+}
+
+TEST(RingBufferMoveTest, ReleaseOfOverwrittenElementsKeepsNewElements) {
+  RingBuffer<std::string, 2, 2, false, NoNotification> ring{};
+  for (const char* element : {"a", "b", "c", "d"}) {
+    ASSERT_TRUE(ring.supply(std::string{element}));
+  }
+  const std::string* borrowed{};
+  ASSERT_EQ(2, ring.borrow(2, &borrowed));
+
+  // Drops the borrowed elements, and reuses their slots.
+  ASSERT_TRUE(ring.supply(std::string{"E"}));
+  ASSERT_TRUE(ring.supply(std::string{"F"}));
+  EXPECT_EQ(0, ring.release(2));
+
+  std::array<std::string, 4> consumed{};
+  ASSERT_EQ(4, ring.consume_bulk(consumed.size(), consumed.data()));
+  EXPECT_EQ((std::array<std::string, 4>{"c", "d", "E", "F"}), consumed);
+}
+
 }  // namespace tvsc::buffer
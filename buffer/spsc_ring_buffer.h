@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "buffer/buffer.h"
+
+namespace tvsc::buffer {
+
+/**
+ * Lock-free ring buffer for exactly one producer and exactly one consumer.
+ *
+ * RingBuffer tolerates misuse by multiple threads; it publishes its pointers with
+ * compare_exchange_strong() so that it can detect a lost race, and its default memory ordering is
+ * sequentially consistent. With only one producer and one consumer, that work is unnecessary. Each
+ * pointer has a single writer, so this class publishes them with plain release stores and reads
+ * them with acquire loads. On Cortex-M, that compiles to ordinary loads and stores with a dmb
+ * barrier on the publishing side; there are no ldrex/strex loops.
+ *
+ * Each side also keeps a private copy of the other side's pointer. The producer only reloads the
+ * shared read pointer when its cached copy says that the ring is full, and the consumer only
+ * reloads the shared write pointer when its cached copy says that the ring is empty. In a streaming
+ * workload, this means that most operations touch only the calling side's own cache line. The two
+ * sides' state is padded to std::hardware_destructive_interference_size so that it never shares a
+ * cache line.
+ *
+ * Unlike RingBuffer, this class has no page structure and no callbacks, and it only supports tail
+ * drop (https://en.wikipedia.org/wiki/Tail_drop). Dropping the oldest element would require the
+ * producer to move the read pointer, giving it a second writer.
+ *
+ * CAPACITY must be a power of two so that positions can be mapped to storage with a mask rather
+ * than a division.
+ */
+template <typename ElementT, size_t CAPACITY>
+class SpscRingBuffer final {
+ private:
+  static_assert(CAPACITY >= 2, "SpscRingBuffer must have a capacity of at least two elements");
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "SpscRingBuffer capacity must be a power of two");
+
+#ifdef __cpp_lib_hardware_interference_size
+// GCC warns that this value can change with -mcpu/-mtune. It only affects the layout of this class
+// within a single build, so that is not a concern here.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+  static constexpr size_t CACHE_LINE_SIZE{std::hardware_destructive_interference_size};
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+  static constexpr size_t CACHE_LINE_SIZE{64};
+#endif
+  static constexpr size_t INDEX_MASK{CAPACITY - 1};
+
+  // Like the pointers in RingBuffer, these pointers are monotonically increasing. They count the
+  // total number of elements written into and read from the ring.
+
+  // Producer side. Only the producer writes these.
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> write_pointer_{0};
+  size_t cached_read_pointer_{0};
+
+  // Consumer side. Only the consumer writes these.
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> read_pointer_{0};
+  size_t cached_write_pointer_{0};
+
+  alignas(CACHE_LINE_SIZE) Buffer<ElementT, CAPACITY> elements_{};
+
+  /**
+   * Number of elements the producer can write, reloading the read pointer only if the cached copy
+   * does not show enough space.
+   */
+  size_t space_for_producer(size_t write_pointer_value, size_t num_elements) {
+    size_t space{CAPACITY - (write_pointer_value - cached_read_pointer_)};
+    if (space < num_elements) {
+      cached_read_pointer_ = read_pointer_.load(std::memory_order_acquire);
+      space = CAPACITY - (write_pointer_value - cached_read_pointer_);
+    }
+    return space;
+  }
+
+  /**
+   * Number of elements the consumer can read, reloading the write pointer only if the cached copy
+   * does not show enough elements.
+   */
+  size_t elements_for_consumer(size_t read_pointer_value, size_t num_elements) {
+    size_t available{cached_write_pointer_ - read_pointer_value};
+    if (available < num_elements) {
+      cached_write_pointer_ = write_pointer_.load(std::memory_order_acquire);
+      available = cached_write_pointer_ - read_pointer_value;
+    }
+    return available;
+  }
+
+  /**
+   * Invoke copy(storage_offset, transfer_offset, count) for the at most two contiguous spans of
+   * storage covering count elements starting at pointer.
+   */
+  template <typename CopyFn>
+  static void for_each_span(size_t pointer, size_t count, CopyFn&& copy) {
+    const size_t storage_offset{pointer & INDEX_MASK};
+    const size_t first_count{std::min(count, CAPACITY - storage_offset)};
+    copy(storage_offset, 0, first_count);
+    if (count > first_count) {
+      copy(0, first_count, count - first_count);
+    }
+  }
+
+ public:
+  SpscRingBuffer() = default;
+
+  SpscRingBuffer(const SpscRingBuffer&) = delete;
+  SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+  constexpr size_t max_buffered_elements() const { return CAPACITY; }
+
+  /**
+   * Supply a single element to the ring. Returns true if the element was accepted; false, if the
+   * ring is full. Must only be called from the producer.
+   */
+  bool supply(const ElementT& src) {
+    const size_t write_pointer_value{write_pointer_.load(std::memory_order_relaxed)};
+    if (space_for_producer(write_pointer_value, 1) == 0) {
+      return false;
+    }
+    elements_.data()[write_pointer_value & INDEX_MASK] = src;
+    write_pointer_.store(write_pointer_value + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool supply(ElementT&& src) {
+    const size_t write_pointer_value{write_pointer_.load(std::memory_order_relaxed)};
+    if (space_for_producer(write_pointer_value, 1) == 0) {
+      return false;
+    }
+    elements_.data()[write_pointer_value & INDEX_MASK] = std::move(src);
+    write_pointer_.store(write_pointer_value + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Supply up to num_elements to the ring, wrapping around the end of the storage as needed. Must
+   * only be called from the producer.
+   *
+   * Returns the number of elements actually copied into the ring.
+   */
+  size_t supply(size_t num_elements, const ElementT* src) {
+    const size_t write_pointer_value{write_pointer_.load(std::memory_order_relaxed)};
+    const size_t elements_supplied{
+        std::min(num_elements, space_for_producer(write_pointer_value, num_elements))};
+    if (elements_supplied > 0) {
+      for_each_span(write_pointer_value, elements_supplied,
+                    [this, src](size_t storage_offset, size_t src_offset, size_t count) {
+                      elements_.write_array(storage_offset, count, src + src_offset);
+                    });
+      write_pointer_.store(write_pointer_value + elements_supplied, std::memory_order_release);
+    }
+    return elements_supplied;
+  }
+
+  /**
+   * Consume a single element from the ring. Returns true if an element was consumed. Must only be
+   * called from the consumer.
+   *
+   * The element is moved out, and its slot is reset, as with Buffer::move_out_array(), so that it
+   * releases any resources that it held.
+   */
+  bool consume(ElementT* dest) {
+    const size_t read_pointer_value{read_pointer_.load(std::memory_order_relaxed)};
+    if (elements_for_consumer(read_pointer_value, 1) == 0) {
+      return false;
+    }
+    ElementT& element{elements_.data()[read_pointer_value & INDEX_MASK]};
+    *dest = std::move(element);
+    if constexpr (!std::is_trivially_destructible_v<ElementT>) {
+      element = ElementT{};
+    }
+    read_pointer_.store(read_pointer_value + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Consume up to num_elements from the ring, wrapping around the end of the storage as needed.
+   * Must only be called from the consumer. Like consume(ElementT*), this moves the elements out.
+   *
+   * Returns the number of elements actually consumed.
+   */
+  size_t consume(size_t num_elements, ElementT* dest) {
+    const size_t read_pointer_value{read_pointer_.load(std::memory_order_relaxed)};
+    const size_t elements_consumed{
+        std::min(num_elements, elements_for_consumer(read_pointer_value, num_elements))};
+    if (elements_consumed > 0) {
+      for_each_span(read_pointer_value, elements_consumed,
+                    [this, dest](size_t storage_offset, size_t dest_offset, size_t count) {
+                      elements_.move_out_array(storage_offset, count, dest + dest_offset);
+                    });
+      read_pointer_.store(read_pointer_value + elements_consumed, std::memory_order_release);
+    }
+    return elements_consumed;
+  }
+
+  /**
+   * Number of elements in the ring. Exact when called from the producer or the consumer while the
+   * other side is idle; otherwise only a snapshot.
+   */
+  size_t elements_available() const {
+    const size_t read_pointer_value{read_pointer_.load(std::memory_order_acquire)};
+    const size_t write_pointer_value{write_pointer_.load(std::memory_order_acquire)};
+    return std::min(write_pointer_value - read_pointer_value, CAPACITY);
+  }
+
+  bool empty() const { return elements_available() == 0; }
+
+  bool full() const { return elements_available() >= max_buffered_elements(); }
+};
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,100 @@
+/**
+ * Compares SpscRingBuffer against RingBuffer for a single producer and a single consumer.
+ *
+ *   bazel run -c opt //buffer:spsc_ring_buffer_benchmark
+ */
+#include <array>
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "buffer/ring_buffer.h"
+#include "buffer/spsc_ring_buffer.h"
+
+namespace tvsc::buffer {
+
+static constexpr size_t CAPACITY{1024};
+static constexpr size_t CHUNK_SIZE{64};
+
+// RingBuffer configured as closely as possible to SpscRingBuffer: tail drop and no callbacks. A
+// single page lets its supply() and consume() transfer chunks that wrap around the storage.
+using CurrentRingBuffer = RingBuffer<uint64_t, CAPACITY, 1, true, NoNotification>;
+using CurrentRingBufferPerElementPages = RingBuffer<uint64_t, 1, CAPACITY, true, NoNotification>;
+
+/**
+ * Producer/consumer throughput of single elements. Thread 0 produces and thread 1 consumes. Each
+ * iteration makes a single, non-blocking attempt, and only the elements that the consumer receives
+ * are counted.
+ */
+template <typename RingT>
+void BM_SingleElementTransfer(benchmark::State& state) {
+  static RingT ring{};
+
+  const bool is_producer{state.thread_index() == 0};
+  uint64_t element{0};
+  int64_t elements_consumed{0};
+  for (auto _ : state) {
+    if (is_producer) {
+      if (ring.supply(element)) {
+        ++element;
+      }
+    } else {
+      if (ring.consume(&element)) {
+        ++elements_consumed;
+      }
+    }
+    benchmark::DoNotOptimize(element);
+  }
+  state.SetItemsProcessed(elements_consumed);
+}
+
+BENCHMARK_TEMPLATE(BM_SingleElementTransfer, CurrentRingBufferPerElementPages)
+    ->Threads(2)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SingleElementTransfer, SpscRingBuffer<uint64_t, CAPACITY>)
+    ->Threads(2)
+    ->UseRealTime();
+
+/**
+ * Producer/consumer throughput of chunks of CHUNK_SIZE elements. As above, only the elements that
+ * the consumer receives are counted.
+ */
+template <typename RingT>
+void BM_ChunkTransfer(benchmark::State& state) {
+  static RingT ring{};
+
+  const bool is_producer{state.thread_index() == 0};
+  std::array<uint64_t, CHUNK_SIZE> chunk{};
+  int64_t elements_consumed{0};
+  for (auto _ : state) {
+    if (is_producer) {
+      ring.supply(chunk.size(), chunk.data());
+    } else {
+      elements_consumed += ring.consume(chunk.size(), chunk.data());
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(elements_consumed);
+}
+
+BENCHMARK_TEMPLATE(BM_ChunkTransfer, CurrentRingBuffer)->Threads(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkTransfer, SpscRingBuffer<uint64_t, CAPACITY>)->Threads(2)->UseRealTime();
+
+/**
+ * Uncontended round trip of a single element, to show the baseline cost of each implementation.
+ */
+template <typename RingT>
+void BM_UncontendedRoundTrip(benchmark::State& state) {
+  static RingT ring{};
+  uint64_t element{0};
+  for (auto _ : state) {
+    ring.supply(element);
+    ring.consume(&element);
+    benchmark::DoNotOptimize(element);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_UncontendedRoundTrip, CurrentRingBufferPerElementPages);
+BENCHMARK_TEMPLATE(BM_UncontendedRoundTrip, SpscRingBuffer<uint64_t, CAPACITY>);
+
+}  // namespace tvsc::buffer
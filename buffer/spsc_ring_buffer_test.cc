@@ -0,0 +1,170 @@
+#include "buffer/spsc_ring_buffer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace tvsc::buffer {
+
+TEST(SpscRingBufferTest, NewRingIsEmpty) {
+  SpscRingBuffer<int, 8> ring{};
+  EXPECT_TRUE(ring.empty());
+  EXPECT_FALSE(ring.full());
+  EXPECT_EQ(0, ring.elements_available());
+  EXPECT_EQ(8, ring.max_buffered_elements());
+}
+
+TEST(SpscRingBufferTest, CanSupplyAndConsumeSingleElement) {
+  SpscRingBuffer<int, 8> ring{};
+  EXPECT_TRUE(ring.supply(42));
+  EXPECT_EQ(1, ring.elements_available());
+
+  int value{};
+  EXPECT_TRUE(ring.consume(&value));
+  EXPECT_EQ(42, value);
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingBufferTest, ConsumeFromEmptyRingFails) {
+  SpscRingBuffer<int, 8> ring{};
+  int value{-1};
+  EXPECT_FALSE(ring.consume(&value));
+  EXPECT_EQ(-1, value);
+}
+
+TEST(SpscRingBufferTest, RejectsElementsWhenFull) {
+  SpscRingBuffer<int, 4> ring{};
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(ring.supply(i));
+  }
+  EXPECT_TRUE(ring.full());
+  EXPECT_FALSE(ring.supply(4));
+
+  int value{};
+  ASSERT_TRUE(ring.consume(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(ring.supply(4));
+}
+
+TEST(SpscRingBufferTest, PreservesOrderAcrossManyLaps) {
+  SpscRingBuffer<int, 4> ring{};
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(ring.supply(i));
+    int value{};
+    ASSERT_TRUE(ring.consume(&value));
+    EXPECT_EQ(i, value);
+  }
+}
+
+TEST(SpscRingBufferTest, BulkOperationsStopAtCapacity) {
+  SpscRingBuffer<int, 8> ring{};
+  std::array<int, 10> src{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_EQ(8, ring.supply(src.size(), src.data()));
+
+  std::array<int, 10> dest{};
+  EXPECT_EQ(8, ring.consume(dest.size(), dest.data()));
+  for (size_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(src[i], dest[i]);
+  }
+}
+
+TEST(SpscRingBufferTest, BulkOperationsWrapAroundStorage) {
+  SpscRingBuffer<int, 8> ring{};
+  std::array<int, 6> src{0, 1, 2, 3, 4, 5};
+  std::array<int, 6> dest{};
+  ASSERT_EQ(6, ring.supply(src.size(), src.data()));
+  ASSERT_EQ(6, ring.consume(dest.size(), dest.data()));
+
+  // The next transfer starts at storage offset 6 and wraps to the beginning.
+  std::array<int, 6> wrapped{10, 11, 12, 13, 14, 15};
+  ASSERT_EQ(6, ring.supply(wrapped.size(), wrapped.data()));
+  ASSERT_EQ(6, ring.consume(dest.size(), dest.data()));
+  EXPECT_EQ(wrapped, dest);
+}
+
+TEST(SpscRingBufferTest, ConsumeMovesElementsOut) {
+  SpscRingBuffer<std::shared_ptr<int>, 4> ring{};
+  auto shared{std::make_shared<int>(1)};
+
+  ASSERT_TRUE(ring.supply(shared));
+  {
+    std::shared_ptr<int> consumed{};
+    ASSERT_TRUE(ring.consume(&consumed));
+    EXPECT_EQ(2, shared.use_count());
+  }
+  EXPECT_EQ(1, shared.use_count());
+
+  // Wrap around the end of the storage.
+  const std::array<std::shared_ptr<int>, 3> supplied{shared, shared, shared};
+  ASSERT_EQ(3, ring.supply(supplied.size(), supplied.data()));
+  {
+    std::array<std::shared_ptr<int>, 3> consumed{};
+    ASSERT_EQ(3, ring.consume(consumed.size(), consumed.data()));
+    EXPECT_EQ(7, shared.use_count());
+  }
+  EXPECT_EQ(4, shared.use_count());
+}
+
+TEST(SpscRingBufferTest, ProducerAndConsumerStateDoNotShareCacheLine) {
+  using RingT = SpscRingBuffer<uint8_t, 2>;
+  // The producer state, the consumer state and the storage each start on their own cache line.
+  EXPECT_GE(alignof(RingT), 32);
+  EXPECT_GE(sizeof(RingT), 3 * alignof(RingT));
+}
+
+/**
+ * A producer and a consumer thread transfer a long sequence through a small ring, mixing single
+ * element and bulk operations. The consumer must see every element exactly once, in order.
+ */
+TEST(SpscRingBufferTest, StressTestPreservesOrder) {
+  static constexpr uint64_t NUM_ELEMENTS{1'000'000};
+  static constexpr size_t CHUNK_SIZE{7};
+
+  SpscRingBuffer<uint64_t, 64> ring{};
+
+  std::thread producer{[&ring]() {
+    uint64_t next{0};
+    std::array<uint64_t, CHUNK_SIZE> chunk{};
+    while (next < NUM_ELEMENTS) {
+      if (next % 2 == 0) {
+        const size_t count{
+            static_cast<size_t>(std::min<uint64_t>(CHUNK_SIZE, NUM_ELEMENTS - next))};
+        for (size_t i = 0; i < count; ++i) {
+          chunk[i] = next + i;
+        }
+        const size_t supplied{ring.supply(count, chunk.data())};
+        next += supplied;
+        if (supplied == 0) {
+          std::this_thread::yield();
+        }
+      } else if (ring.supply(next)) {
+        ++next;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }};
+
+  uint64_t expected{0};
+  std::array<uint64_t, CHUNK_SIZE> chunk{};
+  while (expected < NUM_ELEMENTS) {
+    const size_t consumed{ring.consume(chunk.size(), chunk.data())};
+    for (size_t i = 0; i < consumed; ++i) {
+      ASSERT_EQ(expected, chunk[i]);
+      ++expected;
+    }
+    if (consumed == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  EXPECT_TRUE(ring.empty());
+}
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,198 @@
+/**
+ * Optional occupancy and loss accounting for ring buffers.
+ *
+ * A ring buffer that drops data, either by refusing new elements when it is full (tail drop) or by
+ * overwriting its oldest elements, does so silently. These counters make the loss, and how close a
+ * ring runs to losing data, visible so that rings can be sized from field data. They are selected
+ * at compile time with one of the policies below:
+ *
+ * - NoStatistics: nothing is recorded. The ring carries no counters, and the calls to record
+ *   statistics compile away. This is the default.
+ * - RecordStatistics<ClockT>: the ring owns its counters. Read them with the ring's statistics()
+ *   method, which returns a RingStatistics snapshot. This is the natural choice on the host.
+ * - RecordStatisticsTo<COUNTERS, ClockT>: the ring records into COUNTERS, a RingCounters object
+ *   with static storage duration. On embedded targets, COUNTERS can be placed in the .status.value
+ *   section so that it can be read by the debugger or over SWD:
+ *
+ *     __attribute__((section(".status.value"))) tvsc::buffer::RingCounters can_rx_counters{};
+ *     tvsc::message::RingBuffer<CanBusMessage, 16, true,
+ *         tvsc::buffer::RecordStatisticsTo<can_rx_counters, tvsc::time::EmbeddedClock>> ring{};
+ *
+ * ClockT is used to measure the time that the ring spends full. Use tvsc::time::EmbeddedClock on
+ * the STM32 targets.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace tvsc::buffer {
+
+inline constexpr size_t NUM_OCCUPANCY_BUCKETS{8};
+
+/**
+ * Snapshot of a ring's statistics.
+ */
+struct RingStatistics final {
+  // Elements lost, either refused because the ring was full or overwritten before being consumed.
+  uint32_t elements_dropped{};
+
+  // Largest number of elements ever held by the ring.
+  uint32_t high_water_mark{};
+
+  // Number of operations after which the ring's occupancy fell into each bucket. Bucket i covers
+  // occupancies in [i * (capacity + 1) / NUM_OCCUPANCY_BUCKETS, (i + 1) * (capacity + 1) /
+  // NUM_OCCUPANCY_BUCKETS), so a full ring is counted in the last bucket.
+  std::array<uint32_t, NUM_OCCUPANCY_BUCKETS> occupancy_histogram{};
+
+  // Total time in microseconds that the ring has been full. This wraps about every 71 minutes;
+  // compute differences between readings modulo 2^32.
+  uint32_t time_full_us{};
+};
+
+/**
+ * Live counters behind a RingStatistics snapshot. Each field is a lock-free 32-bit atomic, with the
+ * same size and layout as a uint32_t, so that a producer and a consumer running in different
+ * threads or interrupt handlers can update the counters, and a debugger can read them directly
+ * from memory.
+ */
+struct RingCounters final {
+  std::atomic<uint32_t> elements_dropped{};
+  std::atomic<uint32_t> high_water_mark{};
+  std::array<std::atomic<uint32_t>, NUM_OCCUPANCY_BUCKETS> occupancy_histogram{};
+  std::atomic<uint32_t> time_full_us{};
+
+  // Bookkeeping for time_full_us.
+  std::atomic<uint32_t> is_full{};
+  std::atomic<uint32_t> full_since_us{};
+
+  RingStatistics snapshot() const {
+    RingStatistics result{};
+    result.elements_dropped = elements_dropped.load(std::memory_order_relaxed);
+    result.high_water_mark = high_water_mark.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < NUM_OCCUPANCY_BUCKETS; ++i) {
+      result.occupancy_histogram[i] = occupancy_histogram[i].load(std::memory_order_relaxed);
+    }
+    result.time_full_us = time_full_us.load(std::memory_order_relaxed);
+    return result;
+  }
+
+  void reset() {
+    elements_dropped.store(0, std::memory_order_relaxed);
+    high_water_mark.store(0, std::memory_order_relaxed);
+    for (auto& bucket : occupancy_histogram) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    time_full_us.store(0, std::memory_order_relaxed);
+    is_full.store(0, std::memory_order_relaxed);
+  }
+};
+
+struct NoStatistics final {};
+
+template <typename ClockT = std::chrono::steady_clock>
+struct RecordStatistics final {};
+
+template <RingCounters& COUNTERS, typename ClockT = std::chrono::steady_clock>
+struct RecordStatisticsTo final {};
+
+namespace internal {
+
+template <typename ClockT>
+uint32_t current_time_us() {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  return static_cast<uint32_t>(
+      duration_cast<microseconds>(ClockT::now().time_since_epoch()).count());
+}
+
+template <typename ClockT>
+void record_occupancy(RingCounters& counters, size_t occupancy, size_t capacity) {
+  const uint32_t occupancy_value{static_cast<uint32_t>(occupancy)};
+  uint32_t high_water_mark{counters.high_water_mark.load(std::memory_order_relaxed)};
+  while (occupancy_value > high_water_mark &&
+         !counters.high_water_mark.compare_exchange_weak(high_water_mark, occupancy_value,
+                                                         std::memory_order_relaxed)) {
+  }
+
+  counters.occupancy_histogram[occupancy * NUM_OCCUPANCY_BUCKETS / (capacity + 1)].fetch_add(
+      1, std::memory_order_relaxed);
+
+  // Only the producer can fill the ring, and, except when it overwrites old elements, only the
+  // consumer can make room. So each transition is normally seen by a single side. Under concurrent
+  // operations, the occupancy passed in may already be slightly stale, so the time is approximate.
+  if (occupancy >= capacity) {
+    if (counters.is_full.load(std::memory_order_acquire) == 0) {
+      counters.full_since_us.store(current_time_us<ClockT>(), std::memory_order_relaxed);
+      counters.is_full.store(1, std::memory_order_release);
+    }
+  } else if (counters.is_full.exchange(0, std::memory_order_acq_rel) != 0) {
+    counters.time_full_us.fetch_add(
+        current_time_us<ClockT>() - counters.full_since_us.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  }
+}
+
+/**
+ * Storage and recording for each statistics policy. Ring buffers hold one of these and only ever
+ * call the members below.
+ */
+template <typename PolicyT>
+class StatisticsRecorder;
+
+template <>
+class StatisticsRecorder<NoStatistics> final {
+ public:
+  static constexpr bool ENABLED{false};
+
+  void record_dropped(size_t /*num_elements*/) {}
+  void record_occupancy(size_t /*occupancy*/, size_t /*capacity*/) {}
+};
+
+template <typename ClockT>
+class StatisticsRecorder<RecordStatistics<ClockT>> final {
+ private:
+  RingCounters counters_{};
+
+ public:
+  static constexpr bool ENABLED{true};
+
+  RingCounters& counters() { return counters_; }
+  const RingCounters& counters() const { return counters_; }
+
+  void record_dropped(size_t num_elements) {
+    if (num_elements > 0) {
+      counters_.elements_dropped.fetch_add(num_elements, std::memory_order_relaxed);
+    }
+  }
+
+  void record_occupancy(size_t occupancy, size_t capacity) {
+    internal::record_occupancy<ClockT>(counters_, occupancy, capacity);
+  }
+};
+
+template <RingCounters& COUNTERS, typename ClockT>
+class StatisticsRecorder<RecordStatisticsTo<COUNTERS, ClockT>> final {
+ public:
+  static constexpr bool ENABLED{true};
+
+  RingCounters& counters() { return COUNTERS; }
+  const RingCounters& counters() const { return COUNTERS; }
+
+  void record_dropped(size_t num_elements) {
+    if (num_elements > 0) {
+      COUNTERS.elements_dropped.fetch_add(num_elements, std::memory_order_relaxed);
+    }
+  }
+
+  void record_occupancy(size_t occupancy, size_t capacity) {
+    internal::record_occupancy<ClockT>(COUNTERS, occupancy, capacity);
+  }
+};
+
+}  // namespace internal
+
+}  // namespace tvsc::buffer
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "buffer/buffer_view.h"
+#include "comms/radio/fragment.h"
+#include "message/codec.h"
+#include "message/message.h"
+
+namespace tvsc::comms::radio {
+
+/**
+ * Header of each CAN bus frame packed into a fragment by a CanRadioGateway. It is followed by
+ * length bytes of payload.
+ */
+struct CanFrameHeader final {
+  uint8_t length{};
+  uint32_t identifier{};
+};
+
+/**
+ * Four bits of length, since a classic CAN frame carries at most eight bytes, and the 29 bits of an
+ * extended CAN identifier, packed into five bytes.
+ */
+using CanFrameHeaderCodec =
+    message::Codec<CanFrameHeader, message::Field<&CanFrameHeader::length, 4>, message::Padding<7>,
+                   message::Field<&CanFrameHeader::identifier, 29>>;
+
+/**
+ * Forwards CAN bus traffic over a half-duplex radio, and unpacks forwarded traffic on the other
+ * side.
+ *
+ * Sending each CAN frame in its own fragment wastes most of the fragment, and the radio can only
+ * send one fragment every fragment_transmit_time_us(), so the radio link saturates long before the
+ * bus does. Instead, the gateway packs several frames, each as a CanFrameHeader and its payload,
+ * into one fragment. A fragment is flushed when the next frame would not fit, or when its oldest
+ * frame has waited max_age. max_age bounds the latency added by packing. With a max_age of zero,
+ * frames are sent as soon as the radio is free, and only the frames that arrive while it is busy
+ * share a fragment.
+ *
+ * The gateway holds the fragment being filled and one fragment that is ready to transmit. When both
+ * are full, forward() refuses frames until the radio catches up, as a full Queue would.
+ *
+ * The gateway never blocks. service() should be called whenever a frame has been forwarded, and no
+ * later than the time it returns, to flush aged fragments and to start transmissions when the radio
+ * is idle. ClockT provides the time used to age frames.
+ */
+template <size_t MTU, typename ClockT>
+class CanRadioGateway final {
+ public:
+  using FragmentType = Fragment<MTU>;
+  using MessageType = message::CanBusMessage;
+  using ClockType = ClockT;
+
+  static constexpr size_t FRAME_HEADER_SIZE{CanFrameHeaderCodec::size()};
+  static constexpr size_t MAX_FRAME_SIZE{FRAME_HEADER_SIZE + MessageType::mtu()};
+
+  /**
+   * Number of full-length CAN frames that fit in one fragment.
+   */
+  static constexpr size_t frames_per_fragment() {
+    return FragmentType::max_payload_size() / MAX_FRAME_SIZE;
+  }
+
+ private:
+  static_assert(frames_per_fragment() > 0, "MTU is too small to carry a CAN bus frame");
+  static_assert(MessageType::mtu() < 16, "CanFrameHeader can only encode lengths up to 15 bytes");
+
+  const uint8_t sender_id_;
+  const uint8_t destination_id_;
+  const typename ClockType::duration max_age_;
+
+  FragmentType filling_{};
+  size_t filling_size_{};
+  typename ClockType::time_point oldest_frame_time_{};
+
+  FragmentType ready_{};
+  bool have_ready_{false};
+
+  uint16_t next_sequence_number_{};
+
+  size_t num_frames_forwarded_{};
+  size_t num_frames_refused_{};
+  size_t num_fragments_transmitted_{};
+
+  bool is_filling() const { return filling_size_ > 0; }
+
+  /**
+   * Move the fragment being filled to the ready slot. Returns false if the ready slot is taken.
+   */
+  bool seal() {
+    if (have_ready_) {
+      return false;
+    }
+    filling_.set_sender_id(sender_id_);
+    filling_.set_destination_id(destination_id_);
+    filling_.set_fragment_index(0);
+    filling_.set_sequence_number(next_sequence_number_++);
+    filling_.set_payload_size(filling_size_);
+    ready_ = filling_;
+    have_ready_ = true;
+    filling_size_ = 0;
+    return true;
+  }
+
+  bool is_due(typename ClockType::time_point now) const {
+    return is_filling() && (FragmentType::max_payload_size() - filling_size_ < MAX_FRAME_SIZE ||
+                            now - oldest_frame_time_ >= max_age_);
+  }
+
+ public:
+  CanRadioGateway(uint8_t sender_id, uint8_t destination_id, typename ClockType::duration max_age)
+      : sender_id_(sender_id), destination_id_(destination_id), max_age_(max_age) {}
+
+  /**
+   * Pack a CAN bus frame for transmission. Returns false, and drops the frame, if there is no room
+   * for it until the ready fragment has been transmitted.
+   *
+   * Only the low 29 bits of the identifier are forwarded.
+   */
+  [[nodiscard]] bool forward(const MessageType& msg) {
+    const size_t frame_size{FRAME_HEADER_SIZE + msg.size()};
+    if (FragmentType::max_payload_size() - filling_size_ < frame_size && !seal()) {
+      ++num_frames_refused_;
+      return false;
+    }
+    if (!is_filling()) {
+      oldest_frame_time_ = ClockType::now();
+    }
+
+    uint8_t* destination{filling_.payload_start() + filling_size_};
+    CanFrameHeaderCodec::encode(
+        CanFrameHeader{static_cast<uint8_t>(msg.size()), msg.identifier()}, destination);
+    std::memcpy(destination + FRAME_HEADER_SIZE, msg.payload().data(), msg.size());
+    filling_size_ += frame_size;
+    ++num_frames_forwarded_;
+    return true;
+  }
+
+  /**
+   * Flush the fragment being filled if it is full or its oldest frame has reached max_age, and
+   * transmit the ready fragment if the radio is idle. When there is nothing left to transmit, the
+   * radio is put back in receive mode.
+   *
+   * Returns the time by which service() should next be called.
+   */
+  template <typename RadioT>
+  typename ClockType::time_point service(RadioT& radio) {
+    const auto now{ClockType::now()};
+    if (is_due(now)) {
+      seal();
+    }
+
+    if (!radio.is_transmitting_fragment()) {
+      if (have_ready_) {
+        if (radio.transmit_fragment(ready_)) {
+          have_ready_ = false;
+          ++num_fragments_transmitted_;
+          if (is_due(now)) {
+            seal();
+          }
+        }
+      } else if (!radio.in_rx_mode()) {
+        radio.set_receive_mode();
+      }
+    }
+
+    if (have_ready_) {
+      return now + std::chrono::microseconds{radio.fragment_transmit_time_us()};
+    }
+    if (is_filling()) {
+      return oldest_frame_time_ + max_age_;
+    }
+    return ClockType::time_point::max();
+  }
+
+  /**
+   * Read a fragment from the radio, if one has arrived, and pass each CAN bus frame in it to fn.
+   * Returns the number of frames unpacked.
+   */
+  template <typename RadioT, typename FnT>
+  size_t receive(RadioT& radio, FnT&& fn) {
+    if (radio.is_transmitting_fragment() || !radio.has_fragment_available()) {
+      return 0;
+    }
+    FragmentType fragment{};
+    radio.read_received_fragment(fragment);
+    return unpack(fragment, std::forward<FnT>(fn));
+  }
+
+  /**
+   * Pass each CAN bus frame packed in fragment to fn. Stops at the first malformed frame. Returns
+   * the number of frames unpacked.
+   */
+  template <typename FnT>
+  static size_t unpack(const FragmentType& fragment, FnT&& fn) {
+    const size_t payload_size{fragment.payload_size()};
+    if (payload_size > FragmentType::max_payload_size()) {
+      return 0;
+    }
+
+    const uint8_t* data{fragment.payload_start()};
+    size_t offset{0};
+    size_t count{0};
+    MessageType msg{};
+    while (payload_size - offset >= FRAME_HEADER_SIZE) {
+      CanFrameHeader header{};
+      CanFrameHeaderCodec::decode(data + offset, header);
+      offset += FRAME_HEADER_SIZE;
+      if (header.length > MessageType::mtu() || payload_size - offset < header.length) {
+        break;
+      }
+      msg.identifier() = header.identifier;
+      msg.set_payload(buffer::BufferView<const uint8_t>{data + offset, header.length});
+      offset += header.length;
+      fn(std::as_const(msg));
+      ++count;
+    }
+    return count;
+  }
+
+  size_t num_frames_forwarded() const { return num_frames_forwarded_; }
+  size_t num_frames_refused() const { return num_frames_refused_; }
+  size_t num_fragments_transmitted() const { return num_fragments_transmitted_; }
+};
+
+}  // namespace tvsc::comms::radio
@@ -0,0 +1,326 @@
+#include "comms/radio/can_gateway.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "comms/radio/fragment.h"
+#include "comms/radio/mock_radio.h"
+#include "gtest/gtest.h"
+#include "message/message.h"
+#include "time/mock_clock.h"
+
+namespace tvsc::comms::radio {
+
+using namespace std::chrono_literals;
+
+using ClockType = time::MockClock;
+using RadioType = SmallBufferMockRadio;
+using GatewayType = CanRadioGateway<RadioType::max_mtu(), ClockType>;
+using message::CanBusMessage;
+
+static constexpr uint8_t SATELLITE_ID{1};
+static constexpr uint8_t GROUND_ID{2};
+
+CanBusMessage numbered_frame(uint32_t identifier, uint32_t number, size_t size = 8) {
+  CanBusMessage msg{};
+  msg.identifier() = identifier;
+  const std::array<uint8_t, 8> bytes{static_cast<uint8_t>(number),
+                                     static_cast<uint8_t>(number >> 8),
+                                     static_cast<uint8_t>(number >> 16),
+                                     0xa5,
+                                     0xa5,
+                                     0xa5,
+                                     0xa5,
+                                     0xa5};
+  msg.set_payload(buffer::BufferView<const uint8_t>{bytes.data(), size});
+  return msg;
+}
+
+uint32_t frame_number(const CanBusMessage& msg) {
+  return msg.payload()[0] | (uint32_t{msg.payload()[1]} << 8) |
+         (uint32_t{msg.payload()[2]} << 16);
+}
+
+std::vector<CanBusMessage> unpack_all(const GatewayType::FragmentType& fragment) {
+  std::vector<CanBusMessage> frames{};
+  GatewayType::unpack(fragment, [&frames](const CanBusMessage& msg) { frames.push_back(msg); });
+  return frames;
+}
+
+TEST(CanRadioGatewayTest, PacksFramesUntilFragmentIsFull) {
+  ClockType& clock{ClockType::clock()};
+  RadioType radio{clock};
+  GatewayType gateway{SATELLITE_ID, GROUND_ID, 1s};
+  ASSERT_EQ(4, GatewayType::frames_per_fragment());
+
+  for (uint32_t i = 0; i < GatewayType::frames_per_fragment() - 1; ++i) {
+    ASSERT_TRUE(gateway.forward(numbered_frame(0x100 + i, i)));
+    gateway.service(radio);
+  }
+  EXPECT_FALSE(radio.is_transmitting_fragment());
+
+  ASSERT_TRUE(gateway.forward(numbered_frame(0x1fffffff, 3)));
+  gateway.service(radio);
+  EXPECT_TRUE(radio.is_transmitting_fragment());
+
+  clock.increment_current_time(std::chrono::microseconds{radio.fragment_transmit_time_us()});
+  ASSERT_EQ(1, radio.sent_fragments().size());
+  const auto& fragment{radio.sent_fragments()[0]};
+  EXPECT_EQ(SATELLITE_ID, fragment.sender_id());
+  EXPECT_EQ(GROUND_ID, fragment.destination_id());
+
+  const std::vector<CanBusMessage> frames{unpack_all(fragment)};
+  ASSERT_EQ(4, frames.size());
+  for (uint32_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(numbered_frame(0x100 + i, i), frames[i]);
+  }
+  EXPECT_EQ(numbered_frame(0x1fffffff, 3), frames[3]);
+  EXPECT_EQ(1, gateway.num_fragments_transmitted());
+}
+
+TEST(CanRadioGatewayTest, FlushesWhenOldestFrameReachesMaxAge) {
+  ClockType& clock{ClockType::clock()};
+  RadioType radio{clock};
+  GatewayType gateway{SATELLITE_ID, GROUND_ID, 2ms};
+
+  const auto start{clock.current_time()};
+  ASSERT_TRUE(gateway.forward(numbered_frame(0x10, 0)));
+  EXPECT_EQ(start + 2ms, gateway.service(radio));
+
+  clock.increment_current_time(1ms);
+  ASSERT_TRUE(gateway.forward(numbered_frame(0x11, 1)));
+  EXPECT_EQ(start + 2ms, gateway.service(radio));
+  EXPECT_FALSE(radio.is_transmitting_fragment());
+
+  clock.set_current_time(start + 2ms);
+  gateway.service(radio);
+  EXPECT_TRUE(radio.is_transmitting_fragment());
+
+  clock.increment_current_time(1ms);
+  ASSERT_EQ(1, radio.sent_fragments().size());
+  EXPECT_EQ(2, unpack_all(radio.sent_fragments()[0]).size());
+}
+
+TEST(CanRadioGatewayTest, MaxAgeOfZeroSendsAsSoonAsRadioIsFree) {
+  ClockType& clock{ClockType::clock()};
+  RadioType radio{clock};
+  GatewayType gateway{SATELLITE_ID, GROUND_ID, 0us};
+
+  ASSERT_TRUE(gateway.forward(numbered_frame(0x10, 0)));
+  gateway.service(radio);
+  EXPECT_TRUE(radio.is_transmitting_fragment());
+
+  // The next frame waits in the ready fragment while the radio is busy, and the ones after it
+  // share a fragment.
+  for (uint32_t i = 1; i < 4; ++i) {
+    ASSERT_TRUE(gateway.forward(numbered_frame(0x10, i)));
+    gateway.service(radio);
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    clock.increment_current_time(1ms);
+    gateway.service(radio);
+  }
+
+  const auto& sent{radio.sent_fragments()};
+  ASSERT_EQ(3, sent.size());
+  EXPECT_EQ(1, unpack_all(sent[0]).size());
+  EXPECT_EQ(1, unpack_all(sent[1]).size());
+  EXPECT_EQ(2, unpack_all(sent[2]).size());
+  EXPECT_EQ(sent[0].sequence_number() + 1, sent[1].sequence_number());
+  EXPECT_EQ(sent[1].sequence_number() + 1, sent[2].sequence_number());
+}
+
+TEST(CanRadioGatewayTest, RefusesFramesWhenBothFragmentsAreFull) {
+  GatewayType gateway{SATELLITE_ID, GROUND_ID, 1s};
+  for (uint32_t i = 0; i < 2 * GatewayType::frames_per_fragment(); ++i) {
+    ASSERT_TRUE(gateway.forward(numbered_frame(0x10, i)));
+  }
+  EXPECT_FALSE(gateway.forward(numbered_frame(0x10, 99)));
+  EXPECT_EQ(1, gateway.num_frames_refused());
+  EXPECT_EQ(2 * GatewayType::frames_per_fragment(), gateway.num_frames_forwarded());
+}
+
+TEST(CanRadioGatewayTest, ShortFramesShareFragments) {
+  GatewayType gateway{SATELLITE_ID, GROUND_ID, 1s};
+  // Headers only: eleven of them fit in a 59 byte payload.
+  for (uint32_t i = 0; i < 11; ++i) {
+    ASSERT_TRUE(gateway.forward(numbered_frame(i, i, 0)));
+  }
+  EXPECT_TRUE(gateway.forward(numbered_frame(11, 11, 0)));
+  EXPECT_TRUE(gateway.forward(numbered_frame(12, 12, 2)));
+  EXPECT_EQ(0, gateway.num_frames_refused());
+}
+
+TEST(CanRadioGatewayTest, UnpackStopsAtMalformedFrame) {
+  GatewayType::FragmentType fragment{};
+  uint8_t* data{fragment.payload_start()};
+  CanFrameHeaderCodec::encode(CanFrameHeader{1, 0x42}, data);
+  data[GatewayType::FRAME_HEADER_SIZE] = 7;
+  // A length of nine cannot be a classic CAN frame.
+  CanFrameHeaderCodec::encode(CanFrameHeader{9, 0x43}, data + GatewayType::FRAME_HEADER_SIZE + 1);
+  fragment.set_payload_size(2 * GatewayType::FRAME_HEADER_SIZE + 1 + 9);
+
+  const std::vector<CanBusMessage> frames{unpack_all(fragment)};
+  ASSERT_EQ(1, frames.size());
+  EXPECT_EQ(0x42, frames[0].identifier());
+  EXPECT_EQ(7, frames[0].payload()[0]);
+
+  // A frame that claims more payload than the fragment has is also rejected.
+  fragment.set_payload_size(GatewayType::FRAME_HEADER_SIZE);
+  EXPECT_TRUE(unpack_all(fragment).empty());
+}
+
+TEST(CanRadioGatewayTest, GroundUnpacksWhatSatelliteForwards) {
+  ClockType& clock{ClockType::clock()};
+  RadioType satellite_radio{clock};
+  RadioType ground_radio{clock};
+  GatewayType satellite{SATELLITE_ID, GROUND_ID, 1ms};
+  GatewayType ground{GROUND_ID, SATELLITE_ID, 1ms};
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(satellite.forward(numbered_frame(0x200 + i, i, i + 1)));
+  }
+  clock.increment_current_time(1ms);
+  satellite.service(satellite_radio);
+  clock.increment_current_time(1ms);
+  ASSERT_EQ(1, satellite_radio.sent_fragments().size());
+
+  ground.service(ground_radio);
+  EXPECT_TRUE(ground_radio.in_rx_mode());
+  const auto now_us{static_cast<hal::TimeType>(clock.current_time().time_since_epoch().count())};
+  ground_radio.add_rx_fragment(now_us, satellite_radio.sent_fragments()[0]);
+
+  std::vector<CanBusMessage> frames{};
+  EXPECT_EQ(3, ground.receive(ground_radio,
+                              [&frames](const CanBusMessage& msg) { frames.push_back(msg); }));
+  ASSERT_EQ(3, frames.size());
+  for (uint32_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(numbered_frame(0x200 + i, i, i + 1), frames[i]);
+  }
+}
+
+// Simulation of CAN bus traffic forwarded over the radio, comparing the gateway with sending each
+// frame in its own fragment. A frame arrives every arrival_interval and carries its index, so the
+// time from forward() to the end of the transmission of its fragment can be measured. Everything
+// runs on the MockClock, so the results are deterministic.
+
+/**
+ * Forwarding without packing: each frame gets its own fragment. Like the gateway, it holds one
+ * fragment while the radio is busy.
+ */
+class OneFramePerFragment final {
+ private:
+  GatewayType::FragmentType pending_{};
+  bool have_pending_{false};
+
+ public:
+  [[nodiscard]] bool forward(const CanBusMessage& msg) {
+    if (have_pending_) {
+      return false;
+    }
+    CanFrameHeaderCodec::encode(CanFrameHeader{static_cast<uint8_t>(msg.size()), msg.identifier()},
+                                pending_.payload_start());
+    std::copy_n(msg.payload().data(), msg.size(),
+                pending_.payload_start() + GatewayType::FRAME_HEADER_SIZE);
+    pending_.set_payload_size(GatewayType::FRAME_HEADER_SIZE + msg.size());
+    have_pending_ = true;
+    return true;
+  }
+
+  void service(RadioType& radio) {
+    if (have_pending_ && !radio.is_transmitting_fragment() && radio.transmit_fragment(pending_)) {
+      have_pending_ = false;
+    }
+  }
+};
+
+struct SimulationResults final {
+  size_t num_refused{};
+  size_t num_delivered{};
+  double throughput_per_second{};
+  ClockType::duration median_latency{};
+  ClockType::duration p99_latency{};
+};
+
+static constexpr ClockType::duration SIMULATION_TIME{1s};
+static constexpr ClockType::duration TIME_STEP{10us};
+static constexpr ClockType::duration TRANSMIT_TIME{700us};
+
+template <typename ForwarderT>
+SimulationResults simulate(ForwarderT&& forwarder, ClockType::duration arrival_interval) {
+  ClockType& clock{ClockType::clock()};
+  RadioType radio{clock};
+
+  SimulationResults results{};
+  std::vector<ClockType::time_point> forward_times{};
+  std::vector<ClockType::duration> latencies{};
+  size_t num_fragments_seen{0};
+
+  const auto start{clock.current_time()};
+  const auto end{start + SIMULATION_TIME};
+  auto next_arrival{start};
+  while (clock.current_time() < end) {
+    const auto now{clock.current_time()};
+    if (now >= next_arrival) {
+      const uint32_t index{static_cast<uint32_t>(forward_times.size())};
+      forward_times.push_back(now);
+      if (!forwarder.forward(numbered_frame(0x100, index))) {
+        ++results.num_refused;
+      }
+      next_arrival += arrival_interval;
+    }
+    forwarder.service(radio);
+
+    clock.increment_current_time(TIME_STEP);
+    const auto& sent{radio.sent_fragments()};
+    for (; num_fragments_seen < sent.size(); ++num_fragments_seen) {
+      GatewayType::unpack(sent[num_fragments_seen], [&](const CanBusMessage& msg) {
+        latencies.push_back(clock.current_time() - forward_times[frame_number(msg)]);
+      });
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  results.num_delivered = latencies.size();
+  results.throughput_per_second =
+      results.num_delivered / std::chrono::duration<double>(SIMULATION_TIME).count();
+  if (!latencies.empty()) {
+    results.median_latency = latencies[latencies.size() / 2];
+    results.p99_latency = latencies[latencies.size() * 99 / 100];
+  }
+  return results;
+}
+
+TEST(CanRadioGatewaySimulationTest, OneFramePerFragmentSaturatesRadio) {
+  const SimulationResults results{simulate(OneFramePerFragment{}, 250us)};
+
+  // One frame per transmission, no matter how fast they arrive.
+  EXPECT_LE(results.throughput_per_second, 1s / TRANSMIT_TIME + 1);
+  EXPECT_GT(results.num_refused, results.num_delivered);
+}
+
+TEST(CanRadioGatewaySimulationTest, PackingKeepsUpWithBusyBus) {
+  static constexpr ClockType::duration MAX_AGE{2ms};
+  const SimulationResults results{simulate(GatewayType{SATELLITE_ID, GROUND_ID, MAX_AGE}, 250us)};
+
+  EXPECT_EQ(0, results.num_refused);
+  EXPECT_GE(results.throughput_per_second, 0.99 * (1s / 250us));
+  EXPECT_LE(results.p99_latency, MAX_AGE + TRANSMIT_TIME + TIME_STEP);
+}
+
+TEST(CanRadioGatewaySimulationTest, MaxAgeBoundsAddedLatencyOnQuietBus) {
+  static constexpr ClockType::duration MAX_AGE{2ms};
+  const SimulationResults unpacked{simulate(OneFramePerFragment{}, 10ms)};
+  const SimulationResults packed{simulate(GatewayType{SATELLITE_ID, GROUND_ID, MAX_AGE}, 10ms)};
+
+  EXPECT_EQ(unpacked.num_delivered, packed.num_delivered);
+  EXPECT_LE(unpacked.p99_latency, TRANSMIT_TIME + TIME_STEP);
+  EXPECT_LE(packed.p99_latency, MAX_AGE + TRANSMIT_TIME + TIME_STEP);
+  EXPECT_GE(packed.median_latency, MAX_AGE);
+}
+
+}  // namespace tvsc::comms::radio
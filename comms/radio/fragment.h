@@ -1,10 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
 #include "bits/bits.h"
 #include "buffer/buffer.h"
+#include "buffer/buffer_view.h"
 
 namespace tvsc::comms::radio {
 
@@ -118,6 +120,34 @@ class Fragment final {
   uint8_t* payload_start() { return data.data() + PAYLOAD_DATA_OFFSET; }
   const uint8_t* payload_start() const { return data.data() + PAYLOAD_DATA_OFFSET; }
 
+  /**
+   * Views of the payload_size() bytes of payload. These avoid copying the payload out of the
+   * fragment when parsing it or forwarding it to another layer.
+   */
+  tvsc::buffer::BufferView<uint8_t> payload() {
+    return data.view(PAYLOAD_DATA_OFFSET, payload_size());
+  }
+  tvsc::buffer::BufferView<const uint8_t> payload() const {
+    return data.view(PAYLOAD_DATA_OFFSET, payload_size());
+  }
+
+  /**
+   * Copy the bytes viewed by payload into the fragment and set the payload size, truncating to
+   * max_payload_size(). Returns the number of bytes copied.
+   */
+  size_t set_payload(tvsc::buffer::BufferView<const uint8_t> payload) {
+    const size_t amount_to_copy{std::min(payload.size(), max_payload_size())};
+    data.write(PAYLOAD_DATA_OFFSET, payload.first(amount_to_copy));
+    set_payload_size(amount_to_copy);
+    return amount_to_copy;
+  }
+
+  /**
+   * View of the total_length() bytes of the fragment, header included, as they would be
+   * transmitted.
+   */
+  tvsc::buffer::BufferView<const uint8_t> bytes() const { return data.view(0, total_length()); }
+
   size_t total_length() const {
     return HEADER_SIZE + payload_size_bytes_required() + payload_size();
   }
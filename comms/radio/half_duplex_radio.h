@@ -3,7 +3,6 @@
 #include <cstdint>
 
 #include "comms/radio/fragment.h"
-#include "time/clock.h"
 #include "random/random.h"
 
 namespace tvsc::comms::radio {
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <limits>
 #include <map>
 #include <stdexcept>
@@ -7,15 +10,18 @@
 
 #include "comms/radio/half_duplex_radio.h"
 #include "hal/output/output.h"
-#include "time/clock.h"
+#include "hal/time_type.h"
+#include "time/clockable.h"
 #include "time/mock_clock.h"
 
 namespace tvsc::comms::radio {
 
 template <size_t MTU>
-class MockRadio final : public HalfDuplexRadio<MTU>, tvsc::time::Clockable {
+class MockRadio final : public HalfDuplexRadio<MTU>,
+                        tvsc::time::Clockable<tvsc::time::MockClock> {
  public:
-  using TimeType = tvsc::time::TimeType;
+  using TimeType = tvsc::hal::TimeType;
+  using ClockType = tvsc::time::MockClock;
 
  private:
   // Amount of time in microseconds required to transmit a fragment, including ramping up and down
@@ -38,8 +44,7 @@ class MockRadio final : public HalfDuplexRadio<MTU>, tvsc::time::Clockable {
 
   // Collection of fragments that will be "received" when read_received_fragment() is called. These
   // fragments are indexed by a timestamp of when the fragment should be received. This timestamp is
-  // in microseconds according to the Clock::current_time_micros() method, or the MockClock override
-  // of the same method.
+  // in microseconds since the MockClock epoch.
   mutable std::map<TimeType, Fragment<MTU>> rx_fragments_{};
 
   // Collection of fragments that have been sent via call to transmit_fragment().
@@ -79,7 +84,7 @@ class MockRadio final : public HalfDuplexRadio<MTU>, tvsc::time::Clockable {
         auto current_fragment = rx_fragments_.begin();
         size_t received_fragments{0};
         for (auto current = rx_fragments_.begin();
-             current->first < current_time_us && current != rx_fragments_.end(); ++current) {
+             current != rx_fragments_.end() && current->first < current_time_us; ++current) {
           current_fragment = current;
           ++received_fragments;
         }
@@ -113,11 +118,36 @@ class MockRadio final : public HalfDuplexRadio<MTU>, tvsc::time::Clockable {
     }
   }
 
-  void update(TimeType current_time_us) noexcept override {
+  static TimeType to_micros(ClockType::time_point t) {
+    return static_cast<TimeType>(std::llround(t.time_since_epoch().count()));
+  }
+
+  TimeType current_time_micros() const { return to_micros(clock_->current_time()); }
+
+  void update(TimeType current_time_us) {
     process_reception(current_time_us);
     process_ongoing_transmission(current_time_us);
   }
 
+  /**
+   * Stop the clock when an ongoing transmission completes, so that the radio returns to standby at
+   * the right time even if the clock is advanced past it in a single step.
+   */
+  ClockType::time_point update_time(ClockType::time_point requested_time) noexcept override {
+    if (have_fragment_for_tx_ && current_mode_ == Mode::TX) {
+      const ClockType::time_point completion_time{
+          std::chrono::microseconds{last_switch_to_tx_mode_us_ + FRAGMENT_TRANSMIT_TIME_US}};
+      if (completion_time > clock_->current_time()) {
+        return std::min(requested_time, completion_time);
+      }
+    }
+    return requested_time;
+  }
+
+  void run(ClockType::time_point current_time) noexcept override {
+    update(to_micros(current_time));
+  }
+
   /**
    * Configure the radio to transmit data.
    *
@@ -126,18 +156,18 @@ class MockRadio final : public HalfDuplexRadio<MTU>, tvsc::time::Clockable {
   void set_tx_mode() {
     current_mode_ = Mode::TX;
 
-    const TimeType current_time_us{clock_->current_time_micros()};
+    const TimeType current_time_us{current_time_micros()};
     last_switch_to_tx_mode_us_ = current_time_us;
     update(current_time_us);
   }
 
  public:
-  MockRadio(tvsc::time::MockClock& clock) : Clockable(clock) {}
+  MockRadio(ClockType& clock) : Clockable(clock) {}
 
   /**
    * Add a fragment to be received. Use this method to configure the mock radio state.
    */
-  void add_rx_fragment(tvsc::time::TimeType rx_timestamp_us, const Fragment<MTU>& fragment) {
+  void add_rx_fragment(TimeType rx_timestamp_us, const Fragment<MTU>& fragment) {
     rx_fragments_.insert({rx_timestamp_us, fragment});
   }
 
@@ -176,17 +206,17 @@ class MockRadio final : public HalfDuplexRadio<MTU>, tvsc::time::Clockable {
 
   void set_standby_mode() override {
     current_mode_ = Mode::STANDBY;
-    update(clock_->current_time_micros());
+    update(current_time_micros());
   }
 
   void set_receive_mode() override {
     current_mode_ = Mode::RX;
-    update(clock_->current_time_micros());
+    update(current_time_micros());
   }
 
   bool has_fragment_available() const override {
     if (!rx_fragments_.empty()) {
-      const TimeType current_time_us{clock_->current_time_micros()};
+      const TimeType current_time_us{current_time_micros()};
       const auto& begin{rx_fragments_.begin()};
       return begin->first <= current_time_us;
     }
@@ -195,11 +225,11 @@ class MockRadio final : public HalfDuplexRadio<MTU>, tvsc::time::Clockable {
 
   void read_received_fragment(Fragment<MTU>& fragment) override {
     if (!rx_fragments_.empty()) {
-      const TimeType current_time_us{clock_->current_time_micros()};
+      const TimeType current_time_us{current_time_micros()};
       auto chosen_entry = rx_fragments_.begin();
       size_t fragments_received{0};
       for (auto current = rx_fragments_.begin();
-           current->first <= current_time_us && current != rx_fragments_.end(); ++current) {
+           current != rx_fragments_.end() && current->first <= current_time_us; ++current) {
         chosen_entry = current;
         ++fragments_received;
       }
@@ -1,14 +1,25 @@
 #include "comms/radio/mock_radio.h"
 
+#include <chrono>
+
 #include "comms/radio/fragment.h"
 #include "gtest/gtest.h"
+#include "hal/time_type.h"
 #include "time/mock_clock.h"
 
 namespace tvsc::comms::radio {
 
+void set_current_time_micros(time::MockClock& clock, hal::TimeType time_us) {
+  clock.set_current_time(time::MockClock::time_point{std::chrono::microseconds{time_us}});
+}
+
+hal::TimeType current_time_micros(time::MockClock& clock) {
+  return static_cast<hal::TimeType>(clock.current_time().time_since_epoch().count());
+}
+
 TEST(MockRadioTest, FragmentsAvailableAtDesignatedTime) {
   using RadioType = SmallBufferMockRadio;
-  hal::time::MockClock& clock{hal::time::MockClock::clock()};
+  time::MockClock& clock{time::MockClock::clock()};
   RadioType radio{clock};
 
   Fragment<RadioType::max_mtu()> fragment{};
@@ -19,14 +30,14 @@ TEST(MockRadioTest, FragmentsAvailableAtDesignatedTime) {
 
   EXPECT_FALSE(radio.has_fragment_available());
 
-  clock.set_current_time_micros(1);
+  set_current_time_micros(clock, 1);
 
   EXPECT_TRUE(radio.has_fragment_available());
 }
 
 TEST(MockRadioTest, DISABLED_CanReceiveFragment) {
   using RadioType = SmallBufferMockRadio;
-  hal::time::MockClock& clock{hal::time::MockClock::clock()};
+  time::MockClock& clock{time::MockClock::clock()};
   RadioType radio{clock};
 
   Fragment<RadioType::max_mtu()> fragment{};
@@ -36,7 +47,7 @@ TEST(MockRadioTest, DISABLED_CanReceiveFragment) {
   radio.set_receive_mode();
   ASSERT_FALSE(radio.has_fragment_available());
 
-  clock.set_current_time_micros(1);
+  set_current_time_micros(clock, 1);
   ASSERT_TRUE(radio.has_fragment_available());
 
   Fragment<RadioType::max_mtu()> received_fragment{};
@@ -47,7 +58,7 @@ TEST(MockRadioTest, DISABLED_CanReceiveFragment) {
 
 TEST(MockRadioTest, CanReceiveFragmentMultipleFragments) {
   using RadioType = SmallBufferMockRadio;
-  hal::time::MockClock& clock{hal::time::MockClock::clock()};
+  time::MockClock& clock{time::MockClock::clock()};
   RadioType radio{clock};
 
   Fragment<RadioType::max_mtu()> fragment{};
@@ -58,7 +69,7 @@ TEST(MockRadioTest, CanReceiveFragmentMultipleFragments) {
   radio.add_rx_fragment(2, fragment);
 
   radio.set_receive_mode();
-  clock.set_current_time_micros(1);
+  set_current_time_micros(clock, 1);
 
   EXPECT_TRUE(radio.has_fragment_available());
 
@@ -67,7 +78,7 @@ TEST(MockRadioTest, CanReceiveFragmentMultipleFragments) {
 
   EXPECT_EQ(1, received_fragment.sender_id());
 
-  clock.set_current_time_micros(2);
+  set_current_time_micros(clock, 2);
 
   EXPECT_TRUE(radio.has_fragment_available());
 
@@ -75,7 +86,7 @@ TEST(MockRadioTest, CanReceiveFragmentMultipleFragments) {
 
   EXPECT_EQ(2, received_fragment.sender_id());
 
-  clock.set_current_time_micros(3);
+  set_current_time_micros(clock, 3);
 
   // No more fragments.
   EXPECT_FALSE(radio.has_fragment_available());
@@ -83,7 +94,7 @@ TEST(MockRadioTest, CanReceiveFragmentMultipleFragments) {
 
 TEST(MockRadioTest, LeavingReceiveModeBeforeFragmentReceiptDropsFragment) {
   using RadioType = SmallBufferMockRadio;
-  hal::time::MockClock& clock{hal::time::MockClock::clock()};
+  time::MockClock& clock{time::MockClock::clock()};
   RadioType radio{clock};
 
   Fragment<RadioType::max_mtu()> fragment{};
@@ -94,7 +105,7 @@ TEST(MockRadioTest, LeavingReceiveModeBeforeFragmentReceiptDropsFragment) {
   radio.add_rx_fragment(2, fragment);
 
   radio.set_receive_mode();
-  clock.set_current_time_micros(1);
+  set_current_time_micros(clock, 1);
 
   ASSERT_TRUE(radio.has_fragment_available());
 
@@ -104,7 +115,7 @@ TEST(MockRadioTest, LeavingReceiveModeBeforeFragmentReceiptDropsFragment) {
   ASSERT_EQ(1, received_fragment.sender_id());
 
   radio.set_standby_mode();
-  clock.set_current_time_micros(3);
+  set_current_time_micros(clock, 3);
 
   EXPECT_FALSE(radio.has_fragment_available());
   EXPECT_EQ(1, radio.count_dropped_fragments());
@@ -113,7 +124,7 @@ TEST(MockRadioTest, LeavingReceiveModeBeforeFragmentReceiptDropsFragment) {
 TEST(MockRadioTest,
      LeavingReceiveModeBeforeFragmentReceiptButReturningToReceiveModeStillDropsFragment) {
   using RadioType = SmallBufferMockRadio;
-  hal::time::MockClock& clock{hal::time::MockClock::clock()};
+  time::MockClock& clock{time::MockClock::clock()};
   RadioType radio{clock};
 
   Fragment<RadioType::max_mtu()> fragment{};
@@ -124,7 +135,7 @@ TEST(MockRadioTest,
   radio.add_rx_fragment(2, fragment);
 
   radio.set_receive_mode();
-  clock.set_current_time_micros(1);
+  set_current_time_micros(clock, 1);
 
   ASSERT_TRUE(radio.has_fragment_available());
 
@@ -135,7 +146,7 @@ TEST(MockRadioTest,
 
   radio.set_standby_mode();
 
-  clock.set_current_time_micros(3);
+  set_current_time_micros(clock, 3);
   radio.set_receive_mode();
 
   EXPECT_FALSE(radio.has_fragment_available());
@@ -144,15 +155,15 @@ TEST(MockRadioTest,
 
 TEST(MockRadioTest, CanTransmitFragment) {
   using RadioType = SmallBufferMockRadio;
-  hal::time::MockClock& clock{hal::time::MockClock::clock()};
+  time::MockClock& clock{time::MockClock::clock()};
   RadioType radio{clock};
 
   Fragment<RadioType::max_mtu()> fragment{};
   fragment.set_sender_id(1);
 
-  clock.set_current_time_micros(1);
+  set_current_time_micros(clock, 1);
   EXPECT_TRUE(radio.transmit_fragment(fragment));
-  clock.set_current_time_micros(clock.current_time_micros() + radio.fragment_transmit_time_us());
+  set_current_time_micros(clock, current_time_micros(clock) + radio.fragment_transmit_time_us());
 
   EXPECT_EQ(1, radio.sent_fragments().size());
   for (const Fragment<RadioType::max_mtu()>& sent_fragment : radio.sent_fragments()) {
@@ -162,13 +173,13 @@ TEST(MockRadioTest, CanTransmitFragment) {
 
 TEST(MockRadioTest, SwitchesToStandbyModeAfterTransmittingFragment) {
   using RadioType = SmallBufferMockRadio;
-  hal::time::MockClock& clock{hal::time::MockClock::clock()};
+  time::MockClock& clock{time::MockClock::clock()};
   RadioType radio{clock};
 
   Fragment<RadioType::max_mtu()> fragment{};
   fragment.set_sender_id(1);
 
-  clock.set_current_time_micros(1);
+  set_current_time_micros(clock, 1);
   ASSERT_TRUE(radio.transmit_fragment(fragment));
   EXPECT_TRUE(radio.in_tx_mode());
 
@@ -180,23 +191,23 @@ TEST(MockRadioTest, SwitchesToStandbyModeAfterTransmittingFragment) {
 
 TEST(MockRadioTest, TransmittingFragmentWhileTransmittingOtherFragmentCorrupts) {
   using RadioType = SmallBufferMockRadio;
-  hal::time::MockClock& clock{hal::time::MockClock::clock()};
+  time::MockClock& clock{time::MockClock::clock()};
   RadioType radio{clock};
 
   Fragment<RadioType::max_mtu()> fragment{};
   fragment.set_sender_id(1);
 
-  clock.set_current_time_micros(1);
+  set_current_time_micros(clock, 1);
   ASSERT_TRUE(radio.transmit_fragment(fragment));
 
   // Start the second transmission too early.
-  clock.set_current_time_micros(clock.current_time_micros() + radio.fragment_transmit_time_us() -
+  set_current_time_micros(clock, current_time_micros(clock) + radio.fragment_transmit_time_us() -
                                 1);
   fragment.set_sender_id(2);
   ASSERT_TRUE(radio.transmit_fragment(fragment));
 
   // Allow the second transmission to finish.
-  clock.set_current_time_micros(clock.current_time_micros() + radio.fragment_transmit_time_us());
+  set_current_time_micros(clock, current_time_micros(clock) + radio.fragment_transmit_time_us());
 
   EXPECT_EQ(1, radio.sent_fragments().size());
   EXPECT_EQ(1, radio.count_corrupted_fragments());
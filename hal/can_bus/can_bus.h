@@ -1,9 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <string>
 
+#include "buffer/buffer_view.h"
 #include "hal/peripheral.h"
 #include "message/message.h"
 
@@ -18,11 +20,10 @@ class CanBus;
 
 /**
  * Interface to manage sending and receiving messages over an I2C bus.
+ *
+ * Frame data is passed as a tvsc::buffer::BufferView so that it can be received directly into, and
+ * transmitted directly from, the payload of a message without intermediate copies.
  */
-
-// TODO(james): Change the std::array<uint8_t, 8> to a real buffer type, likely a reworked
-// tvsc::buffer::Buffer.
-
 class CanBusPeripheral : public SingletonPeripheral<CanBusPeripheral, CanBus> {
  private:
   virtual void enable() = 0;
@@ -30,15 +31,24 @@ class CanBusPeripheral : public SingletonPeripheral<CanBusPeripheral, CanBus> {
 
   virtual uint32_t available_message_count(RxFifo fifo) = 0;
 
-  virtual bool receive(RxFifo fifo, uint32_t& identifier, std::array<uint8_t, 8>& data) = 0;
+  /**
+   * Receive a frame into the elements viewed by data, which must have space for MAX_FRAME_SIZE
+   * bytes. On success, data is narrowed to the bytes actually received.
+   */
+  virtual bool receive(RxFifo fifo, uint32_t& identifier, buffer::BufferView<uint8_t>& data) = 0;
 
-  virtual bool transmit(uint32_t identifier, const std::array<uint8_t, 8>& data) = 0;
+  /**
+   * Transmit the bytes viewed by data, at most MAX_FRAME_SIZE, as a single frame.
+   */
+  virtual bool transmit(uint32_t identifier, buffer::BufferView<const uint8_t> data) = 0;
 
   virtual uint32_t error_code() const = 0;
 
   friend class CanBus;
 
  public:
+  static constexpr size_t MAX_FRAME_SIZE{8};
+
   virtual ~CanBusPeripheral() = default;
 
   virtual void handle_interrupt() = 0;
@@ -57,23 +67,37 @@ class CanBus final : public Functional<CanBusPeripheral, CanBus> {
     return peripheral_->available_message_count(fifo);
   }
 
-  bool receive_raw(RxFifo fifo, uint32_t& identifier, std::array<uint8_t, 8>& data) {
+  bool receive_raw(RxFifo fifo, uint32_t& identifier, buffer::BufferView<uint8_t>& data) {
     return peripheral_->receive(fifo, identifier, data);
   }
 
+  bool receive_raw(RxFifo fifo, uint32_t& identifier, std::array<uint8_t, 8>& data) {
+    buffer::BufferView<uint8_t> view{data};
+    return peripheral_->receive(fifo, identifier, view);
+  }
+
+  /**
+   * Receive a frame directly into the payload of message. The message's size is set to the number
+   * of bytes in the frame.
+   */
   bool receive(RxFifo fifo, message::CanBusMessage& message) {
-    if (peripheral_->receive(fifo, message.identifier(), message.payload())) {
-      message.set_size(message::CanBusMessage::mtu());
+    buffer::BufferView<uint8_t> payload{message.payload()};
+    if (peripheral_->receive(fifo, message.identifier(), payload)) {
+      message.set_size(payload.size());
       return true;
     } else {
       return false;
     }
   }
 
-  bool transmit_raw(uint32_t identifier, const std::array<uint8_t, 8>& data) {
+  bool transmit_raw(uint32_t identifier, buffer::BufferView<const uint8_t> data) {
     return peripheral_->transmit(identifier, data);
   }
 
+  bool transmit_raw(uint32_t identifier, const std::array<uint8_t, 8>& data) {
+    return peripheral_->transmit(identifier, buffer::BufferView<const uint8_t>{data});
+  }
+
   bool transmit(uint32_t identifier, const std::string& str) {
     std::array<uint8_t, 8> data{};
     const std::size_t copy_length{std::min(data.size(), str.size())};
@@ -82,7 +106,7 @@ class CanBus final : public Functional<CanBusPeripheral, CanBus> {
   }
 
   bool transmit(const message::CanBusMessage& message) {
-    return peripheral_->transmit(message.identifier(), message.payload());
+    return peripheral_->transmit(message.identifier(), message.payload_view());
   }
 
   uint32_t error_code() const { return peripheral_->error_code(); }
@@ -1,5 +1,8 @@
 #include "hal/can_bus/stm32l4xx_can_bus.h"
 
+#include <algorithm>
+#include <cstddef>
+
 #include "base/enums.h"
 #include "hal/error.h"
 #include "hal/gpio/gpio.h"
@@ -129,7 +132,11 @@ uint32_t CanBusStm32l4xx::available_message_count(RxFifo fifo) {
   return HAL_CAN_GetRxFifoFillLevel(&can_bus_, CAN_RX_FIFO0 + cast_to_underlying_type(fifo));
 }
 
-bool CanBusStm32l4xx::receive(RxFifo fifo, uint32_t& identifier, std::array<uint8_t, 8>& data) {
+bool CanBusStm32l4xx::receive(RxFifo fifo, uint32_t& identifier,
+                              buffer::BufferView<uint8_t>& data) {
+  // The HAL copies the frame before we know its length, so the view must fit the largest frame.
+  require(data.size() >= MAX_FRAME_SIZE);
+
   HAL_StatusTypeDef status;
   CAN_RxHeaderTypeDef header{};
   status = HAL_CAN_GetRxMessage(&can_bus_, CAN_RX_FIFO0 + cast_to_underlying_type(fifo), &header,
@@ -138,13 +145,17 @@ bool CanBusStm32l4xx::receive(RxFifo fifo, uint32_t& identifier, std::array<uint
   require(header.IDE == CAN_ID_STD);
   identifier = header.StdId;
 
-  // TODO(james): Change the std::array<uint8_t, 8> to a real buffer type and uncomment this line to
-  // get the actual size of the received data.
-  // data.set_size(header.DLC);
-  return status == HAL_OK;
+  if (status == HAL_OK) {
+    data = data.first(std::min<size_t>(header.DLC, MAX_FRAME_SIZE));
+    return true;
+  } else {
+    return false;
+  }
 }
 
-bool CanBusStm32l4xx::transmit(uint32_t identifier, const std::array<uint8_t, 8>& data) {
+bool CanBusStm32l4xx::transmit(uint32_t identifier, buffer::BufferView<const uint8_t> data) {
+  require(data.size() <= MAX_FRAME_SIZE);
+
   CAN_TxHeaderTypeDef tx_header = {};
 
   tx_header.StdId = identifier & 0x7ff;    // Standard 11-bit identifier
@@ -28,9 +28,9 @@ class CanBusStm32l4xx final : public CanBusPeripheral {
 
   uint32_t available_message_count(RxFifo fifo) override;
 
-  bool receive(RxFifo fifo, uint32_t& identifier, std::array<uint8_t, 8>& data) override;
+  bool receive(RxFifo fifo, uint32_t& identifier, buffer::BufferView<uint8_t>& data) override;
 
-  bool transmit(uint32_t identifier, const std::array<uint8_t, 8>& data) override;
+  bool transmit(uint32_t identifier, buffer::BufferView<const uint8_t> data) override;
 
   uint32_t error_code() const override;
 
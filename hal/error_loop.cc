@@ -7,6 +7,7 @@
 #endif
 #endif
 
+#include "hal/flight_recorder.h"
 #include "hal/irq.h"
 
 namespace tvsc::hal {
@@ -34,6 +35,10 @@ __attribute__((section(".status.fault"))) ErrorLocation error_location{};
   // it.
   disable_irq();
 
+  // The flight recorder survives the coming reset, so this event is kept along with the history
+  // that led up to it.
+  record_event(FAILURE_EVENT, line_number);
+
   error_location.line_number = line_number;
 
   // Note that we specifically do NOT use strncpy() here or some variant. We want to save that
@@ -0,0 +1,27 @@
+#include "hal/flight_recorder.h"
+
+#include <cstdint>
+
+extern "C" {
+// No initializer, and FlightRecorderType is trivially default constructible, so nothing at startup
+// writes to this object. See the .noinit section in the linker scripts.
+__attribute__((section(".noinit.flight_recorder"))) tvsc::hal::FlightRecorderType flight_recorder;
+}
+
+namespace tvsc::hal {
+
+void initialize_flight_recorder() noexcept {
+#if !defined(GENERAL_PURPOSE_COMPUTER)
+  // Enable the DWT cycle counter used for timestamps: set TRCENA in DEMCR, then CYCCNTENA in
+  // DWT_CTRL.
+  volatile uint32_t& demcr{*reinterpret_cast<volatile uint32_t*>(0xE000EDFC)};
+  volatile uint32_t& dwt_ctrl{*reinterpret_cast<volatile uint32_t*>(0xE0001000)};
+  demcr = demcr | (1U << 24);
+  dwt_ctrl = dwt_ctrl | 1U;
+#endif
+
+  flight_recorder.initialize();
+  record_event(BOOT_EVENT, flight_recorder.boot_count());
+}
+
+}  // namespace tvsc::hal
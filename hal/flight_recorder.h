@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(GENERAL_PURPOSE_COMPUTER)
+#include <chrono>
+#endif
+
+#include "buffer/flight_recorder.h"
+
+namespace tvsc::hal {
+
+/**
+ * System-wide flight recorder.
+ *
+ * The recorder lives in the .noinit section, which the linker scripts place at the start of RAM
+ * (0x20000000 on the STM32L4 boards) and which the startup code neither zeroes nor initializes.
+ * Its events therefore survive a warm reset, such as a watchdog reset or the reset that follows a
+ * failure(), and the firmware that boots next keeps appending to them. They can be read with a
+ * debugger, or from another board over SWD with serial_wire::read_flight_recorder().
+ *
+ * Call initialize_flight_recorder() early in main(), before recording any events. Events can then
+ * be recorded from any context, including interrupt handlers, with record_event().
+ */
+inline constexpr size_t FLIGHT_RECORDER_NUM_EVENTS{256};
+using FlightRecorderType = buffer::FlightRecorder<FLIGHT_RECORDER_NUM_EVENTS>;
+
+// Event ids at and above FIRST_SYSTEM_EVENT are reserved for events recorded by the system itself.
+inline constexpr uint32_t FIRST_SYSTEM_EVENT{0xffff'ff00};
+// Recorded by initialize_flight_recorder(). The value is the recorder's boot count.
+inline constexpr uint32_t BOOT_EVENT{FIRST_SYSTEM_EVENT};
+// Recorded by failure(). The value is the line number of the failure.
+inline constexpr uint32_t FAILURE_EVENT{FIRST_SYSTEM_EVENT + 1};
+
+/**
+ * Timestamp for recorded events. On the boards, this is the DWT cycle counter, which takes a
+ * single load to read. It counts at the core clock frequency, so it wraps roughly once a minute;
+ * the timestamps are meant for ordering events and measuring short intervals.
+ */
+inline uint32_t flight_recorder_timestamp() noexcept {
+#if defined(GENERAL_PURPOSE_COMPUTER)
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+#else
+  // DWT_CYCCNT.
+  return *reinterpret_cast<volatile uint32_t*>(0xE0001004);
+#endif
+}
+
+/**
+ * Prepare the flight recorder, keeping any events retained across a warm reset, and record a
+ * BOOT_EVENT.
+ */
+void initialize_flight_recorder() noexcept;
+
+}  // namespace tvsc::hal
+
+extern "C" {
+extern tvsc::hal::FlightRecorderType flight_recorder;
+}
+
+namespace tvsc::hal {
+
+/**
+ * Record an event in the flight recorder. Safe to call from interrupt handlers.
+ */
+inline void record_event(uint32_t id, uint32_t value) noexcept {
+  flight_recorder.append(id, value, flight_recorder_timestamp());
+}
+
+}  // namespace tvsc::hal
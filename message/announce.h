@@ -3,17 +3,27 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "message/codec.h"
 #include "message/message.h"
 
 namespace tvsc::message {
 
+/**
+ * Payload of an ANNOUNCE message.
+ */
+struct Announcement final {
+  uint8_t mcu_id{};
+  tvsc::hal::board_identification::BoardId board_id{};
+};
+
+using AnnouncementCodec =
+    Codec<Announcement, Field<&Announcement::mcu_id>, Field<&Announcement::board_id>>;
+
 template <size_t PAYLOAD_SIZE>
 void create_announce_message(Message<PAYLOAD_SIZE>& result, uint8_t mcu_id,
                              tvsc::hal::board_identification::BoardId board_id) {
   result.set_type(Type::ANNOUNCE);
-  result.clear_payload();
-  result.append_payload(sizeof(mcu_id), reinterpret_cast<const uint8_t*>(&mcu_id));
-  result.append_payload(sizeof(board_id), reinterpret_cast<const uint8_t*>(&board_id));
+  AnnouncementCodec::encode(Announcement{mcu_id, board_id}, result);
 }
 
 }  // namespace tvsc::message
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace tvsc::message {
+
+enum class SubscriberPolicy : uint8_t {
+  // The publisher waits for this subscriber: publish() fails rather than overwrite a message that
+  // the subscriber has not read yet.
+  BACKPRESSURE,
+  // The publisher never waits for this subscriber. If it falls more than a ring behind, the
+  // messages that were overwritten are skipped and counted as lagged.
+  SKIP_WHEN_LAGGING,
+};
+
+/**
+ * Single-producer ring that broadcasts each message to several subscribers.
+ *
+ * Each consumer of a message stream, such as a logger, a processor and a radio gateway, usually has
+ * its own Queue, and each message is copied into every one of them. A BroadcastRing stores each
+ * message once. Every subscriber has its own read cursor over the shared ring and reads the
+ * messages in place, in the style of the LMAX Disruptor.
+ *
+ * Each subscriber chooses what happens when it falls behind. The publisher will not overwrite a
+ * message that a BACKPRESSURE subscriber has not read: publish() fails instead, as a full Queue
+ * would. SKIP_WHEN_LAGGING subscribers never hold the publisher back; when the publisher laps one
+ * of them, the messages it missed are skipped and counted in num_lagged().
+ *
+ * publish() must only be called from a single producer. Each Subscription must only be used from a
+ * single consumer, but different subscriptions can be used concurrently with each other and with
+ * the producer. Cursors and the write pointer are published with release stores and read with
+ * acquire loads, as in buffer::SpscRingBuffer, and the publisher caches the slowest BACKPRESSURE
+ * cursor so that it only scans the subscribers when the ring looks full.
+ *
+ * CAPACITY must be a power of two so that positions can be mapped to storage with a mask.
+ */
+template <typename MessageT, size_t CAPACITY, size_t MAX_SUBSCRIBERS>
+class BroadcastRing final {
+ public:
+  using MessageType = MessageT;
+
+ private:
+  static_assert(CAPACITY >= 2, "BroadcastRing must have a capacity of at least two messages");
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "BroadcastRing capacity must be a power of two");
+  static_assert(MAX_SUBSCRIBERS > 0, "BroadcastRing must allow at least one subscriber");
+
+#ifdef __cpp_lib_hardware_interference_size
+// See buffer/spsc_ring_buffer.h.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+  static constexpr size_t CACHE_LINE_SIZE{std::hardware_destructive_interference_size};
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+  static constexpr size_t CACHE_LINE_SIZE{64};
+#endif
+  static constexpr size_t INDEX_MASK{CAPACITY - 1};
+  static constexpr size_t NO_CURSOR{std::numeric_limits<size_t>::max()};
+
+  struct alignas(CACHE_LINE_SIZE) SubscriberState final {
+    // Position of the next message this subscriber will read, or NO_CURSOR if the slot is free.
+    // Written by the subscriber, and by the producer when the slot is claimed.
+    std::atomic<size_t> cursor{NO_CURSOR};
+    SubscriberPolicy policy{};
+    // Only written by the subscriber.
+    size_t num_lagged{};
+  };
+
+  struct Slot final {
+    // Position of the message in the slot plus one. Zero while the slot is being written. Lets a
+    // SKIP_WHEN_LAGGING subscriber detect that the message it read was overwritten.
+    std::atomic<size_t> tag{0};
+    MessageType message{};
+  };
+
+  // Producer side. Positions are monotonically increasing counts of messages published.
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> write_pointer_{0};
+  size_t cached_min_cursor_{0};
+
+  std::array<SubscriberState, MAX_SUBSCRIBERS> subscribers_{};
+  alignas(CACHE_LINE_SIZE) std::array<Slot, CAPACITY> slots_{};
+
+  /**
+   * Position of the slowest BACKPRESSURE subscriber, or write_pointer_value if there is none.
+   */
+  size_t min_backpressure_cursor(size_t write_pointer_value) const {
+    size_t min_cursor{write_pointer_value};
+    for (const auto& subscriber : subscribers_) {
+      const size_t cursor{subscriber.cursor.load(std::memory_order_acquire)};
+      if (cursor != NO_CURSOR && subscriber.policy == SubscriberPolicy::BACKPRESSURE &&
+          write_pointer_value - cursor > write_pointer_value - min_cursor) {
+        min_cursor = cursor;
+      }
+    }
+    return min_cursor;
+  }
+
+  template <typename T>
+  bool publish_message(T&& msg) {
+    const size_t write_pointer_value{write_pointer_.load(std::memory_order_relaxed)};
+    if (write_pointer_value - cached_min_cursor_ >= CAPACITY) {
+      cached_min_cursor_ = min_backpressure_cursor(write_pointer_value);
+      if (write_pointer_value - cached_min_cursor_ >= CAPACITY) {
+        return false;
+      }
+    }
+    Slot& slot{slots_[write_pointer_value & INDEX_MASK]};
+    slot.tag.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.message = std::forward<T>(msg);
+    slot.tag.store(write_pointer_value + 1, std::memory_order_release);
+    write_pointer_.store(write_pointer_value + 1, std::memory_order_release);
+    return true;
+  }
+
+ public:
+  /**
+   * One subscriber's view of the ring. Obtained from subscribe(); the subscription ends when it is
+   * destroyed or unsubscribe() is called. A default-constructed Subscription is not subscribed.
+   */
+  class Subscription final {
+   private:
+    BroadcastRing* ring_{nullptr};
+    size_t index_{};
+
+    friend class BroadcastRing;
+
+    Subscription(BroadcastRing& ring, size_t index) : ring_(&ring), index_(index) {}
+
+    SubscriberState& state() const { return ring_->subscribers_[index_]; }
+
+    /**
+     * Cursor for the next read, after skipping any messages that have been overwritten. Also
+     * returns the current write pointer.
+     */
+    size_t catch_up(size_t& write_pointer_value) {
+      SubscriberState& subscriber{state()};
+      size_t cursor{subscriber.cursor.load(std::memory_order_relaxed)};
+      write_pointer_value = ring_->write_pointer_.load(std::memory_order_acquire);
+      if (subscriber.policy == SubscriberPolicy::SKIP_WHEN_LAGGING &&
+          write_pointer_value - cursor > CAPACITY) {
+        const size_t oldest{write_pointer_value - CAPACITY};
+        subscriber.num_lagged += oldest - cursor;
+        cursor = oldest;
+      }
+      return cursor;
+    }
+
+   public:
+    Subscription() = default;
+
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    Subscription(Subscription&& rhs) noexcept
+        : ring_(std::exchange(rhs.ring_, nullptr)), index_(rhs.index_) {}
+
+    Subscription& operator=(Subscription&& rhs) noexcept {
+      if (this != &rhs) {
+        unsubscribe();
+        ring_ = std::exchange(rhs.ring_, nullptr);
+        index_ = rhs.index_;
+      }
+      return *this;
+    }
+
+    ~Subscription() { unsubscribe(); }
+
+    bool is_subscribed() const { return ring_ != nullptr; }
+
+    void unsubscribe() {
+      if (ring_ != nullptr) {
+        state().cursor.store(NO_CURSOR, std::memory_order_release);
+        ring_ = nullptr;
+      }
+    }
+
+    SubscriberPolicy policy() const { return state().policy; }
+
+    /**
+     * Number of messages waiting to be read, including any that have been overwritten and will be
+     * skipped.
+     */
+    size_t available() const {
+      return ring_->write_pointer_.load(std::memory_order_acquire) -
+             state().cursor.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Number of messages skipped because the publisher overwrote them before they were read. Always
+     * zero for BACKPRESSURE subscribers.
+     */
+    size_t num_lagged() const { return state().num_lagged; }
+
+    /**
+     * Invoke fn with each waiting message, up to max_messages, in place in the ring. Returns the
+     * number of messages passed to fn.
+     *
+     * For a BACKPRESSURE subscriber, the message cannot change while fn runs. For a
+     * SKIP_WHEN_LAGGING subscriber, the publisher could overwrite it if it runs concurrently with
+     * fn and laps the subscriber. That cannot happen when the publisher and subscribers are tasks
+     * on the same cooperative scheduler. Otherwise, use read(), which copies the message and
+     * detects an overwrite.
+     */
+    template <typename FnT>
+    size_t poll(FnT&& fn, size_t max_messages = std::numeric_limits<size_t>::max()) {
+      size_t write_pointer_value{};
+      size_t cursor{catch_up(write_pointer_value)};
+      const size_t count{std::min(write_pointer_value - cursor, max_messages)};
+      for (size_t i = 0; i < count; ++i) {
+        fn(std::as_const(ring_->slots_[(cursor + i) & INDEX_MASK].message));
+      }
+      state().cursor.store(cursor + count, std::memory_order_release);
+      return count;
+    }
+
+    /**
+     * Copy the next message into msg. Returns false if there is no message waiting. If the message
+     * is overwritten while it is being copied, it is counted as lagged and the next one is read
+     * instead.
+     */
+    bool read(MessageType& msg) {
+      while (true) {
+        size_t write_pointer_value{};
+        const size_t cursor{catch_up(write_pointer_value)};
+        if (cursor == write_pointer_value) {
+          state().cursor.store(cursor, std::memory_order_release);
+          return false;
+        }
+        const Slot& slot{ring_->slots_[cursor & INDEX_MASK]};
+        if (slot.tag.load(std::memory_order_acquire) == cursor + 1) {
+          msg = slot.message;
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (slot.tag.load(std::memory_order_relaxed) == cursor + 1) {
+            state().cursor.store(cursor + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        // Only possible for SKIP_WHEN_LAGGING subscribers: the publisher has lapped us.
+        ++state().num_lagged;
+        state().cursor.store(cursor + 1, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  BroadcastRing() = default;
+
+  BroadcastRing(const BroadcastRing&) = delete;
+  BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+  static constexpr size_t capacity() { return CAPACITY; }
+  static constexpr size_t max_subscribers() { return MAX_SUBSCRIBERS; }
+
+  /**
+   * Subscribe to the messages published from now on. Returns a Subscription that is not subscribed
+   * if MAX_SUBSCRIBERS subscriptions are already active. Must be called from the producer, or
+   * before the producer starts.
+   */
+  [[nodiscard]] Subscription subscribe(SubscriberPolicy policy) {
+    const size_t write_pointer_value{write_pointer_.load(std::memory_order_relaxed)};
+    for (size_t i = 0; i < subscribers_.size(); ++i) {
+      SubscriberState& subscriber{subscribers_[i]};
+      if (subscriber.cursor.load(std::memory_order_acquire) == NO_CURSOR) {
+        subscriber.policy = policy;
+        subscriber.num_lagged = 0;
+        subscriber.cursor.store(write_pointer_value, std::memory_order_release);
+        return Subscription{*this, i};
+      }
+    }
+    return {};
+  }
+
+  /**
+   * Publish a message to every subscriber. Returns false, and drops the message, if a BACKPRESSURE
+   * subscriber has not yet read the message that it would overwrite.
+   */
+  [[nodiscard]] bool publish(const MessageType& msg) { return publish_message(msg); }
+  [[nodiscard]] bool publish(MessageType&& msg) { return publish_message(std::move(msg)); }
+
+  /**
+   * Total number of messages published.
+   */
+  size_t num_published() const { return write_pointer_.load(std::memory_order_relaxed); }
+};
+
+}  // namespace tvsc::message
@@ -0,0 +1,170 @@
+#include "message/broadcast_ring.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "message/message.h"
+
+namespace tvsc::message {
+
+using RingType = BroadcastRing<CanBusMessage, 4, 3>;
+
+CanBusMessage numbered_message(uint8_t number) {
+  CanBusMessage msg{Type::TELEMETRY};
+  msg.append_payload(1, &number);
+  return msg;
+}
+
+std::vector<uint8_t> poll_numbers(RingType::Subscription& subscription) {
+  std::vector<uint8_t> numbers{};
+  subscription.poll([&numbers](const CanBusMessage& msg) { numbers.push_back(msg.payload()[0]); });
+  return numbers;
+}
+
+TEST(BroadcastRingTest, EverySubscriberSeesTheSameMessageInPlace) {
+  RingType ring{};
+  auto logger{ring.subscribe(SubscriberPolicy::BACKPRESSURE)};
+  auto gateway{ring.subscribe(SubscriberPolicy::SKIP_WHEN_LAGGING)};
+  ASSERT_TRUE(logger.is_subscribed());
+  ASSERT_TRUE(gateway.is_subscribed());
+
+  ASSERT_TRUE(ring.publish(numbered_message(7)));
+
+  const CanBusMessage* seen_by_logger{};
+  const CanBusMessage* seen_by_gateway{};
+  EXPECT_EQ(1, logger.poll([&](const CanBusMessage& msg) { seen_by_logger = &msg; }));
+  EXPECT_EQ(1, gateway.poll([&](const CanBusMessage& msg) { seen_by_gateway = &msg; }));
+  EXPECT_EQ(seen_by_logger, seen_by_gateway);
+  EXPECT_EQ(7, seen_by_logger->payload()[0]);
+
+  EXPECT_EQ(0, logger.available());
+  EXPECT_EQ(0, logger.poll([](const CanBusMessage&) {}));
+}
+
+TEST(BroadcastRingTest, SubscribersOnlySeeLaterMessages) {
+  RingType ring{};
+  auto early{ring.subscribe(SubscriberPolicy::BACKPRESSURE)};
+  ASSERT_TRUE(ring.publish(numbered_message(1)));
+  auto late{ring.subscribe(SubscriberPolicy::BACKPRESSURE)};
+  ASSERT_TRUE(ring.publish(numbered_message(2)));
+
+  EXPECT_EQ((std::vector<uint8_t>{1, 2}), poll_numbers(early));
+  EXPECT_EQ((std::vector<uint8_t>{2}), poll_numbers(late));
+}
+
+TEST(BroadcastRingTest, BackpressureSubscriberHoldsBackPublisher) {
+  RingType ring{};
+  auto subscription{ring.subscribe(SubscriberPolicy::BACKPRESSURE)};
+  for (uint8_t i = 0; i < ring.capacity(); ++i) {
+    ASSERT_TRUE(ring.publish(numbered_message(i)));
+  }
+  EXPECT_FALSE(ring.publish(numbered_message(99)));
+
+  EXPECT_EQ(1, subscription.poll([](const CanBusMessage&) {}, 1));
+  EXPECT_TRUE(ring.publish(numbered_message(4)));
+  EXPECT_EQ((std::vector<uint8_t>{1, 2, 3, 4}), poll_numbers(subscription));
+  EXPECT_EQ(0, subscription.num_lagged());
+}
+
+TEST(BroadcastRingTest, LaggingSubscriberIsSkippedAndCounted) {
+  RingType ring{};
+  auto subscription{ring.subscribe(SubscriberPolicy::SKIP_WHEN_LAGGING)};
+  for (uint8_t i = 0; i < 10; ++i) {
+    ASSERT_TRUE(ring.publish(numbered_message(i)));
+  }
+
+  EXPECT_EQ((std::vector<uint8_t>{6, 7, 8, 9}), poll_numbers(subscription));
+  EXPECT_EQ(6, subscription.num_lagged());
+}
+
+TEST(BroadcastRingTest, OnlyBackpressureSubscribersHoldBackPublisher) {
+  RingType ring{};
+  auto processor{ring.subscribe(SubscriberPolicy::BACKPRESSURE)};
+  auto logger{ring.subscribe(SubscriberPolicy::SKIP_WHEN_LAGGING)};
+
+  for (uint8_t i = 0; i < 10; ++i) {
+    ASSERT_TRUE(ring.publish(numbered_message(i)));
+    EXPECT_EQ(1, processor.poll([](const CanBusMessage&) {}));
+  }
+
+  EXPECT_EQ((std::vector<uint8_t>{6, 7, 8, 9}), poll_numbers(logger));
+  EXPECT_EQ(6, logger.num_lagged());
+  EXPECT_EQ(0, processor.num_lagged());
+}
+
+TEST(BroadcastRingTest, ReadCopiesNextMessage) {
+  RingType ring{};
+  auto subscription{ring.subscribe(SubscriberPolicy::SKIP_WHEN_LAGGING)};
+  CanBusMessage msg{};
+  EXPECT_FALSE(subscription.read(msg));
+
+  for (uint8_t i = 0; i < 6; ++i) {
+    ASSERT_TRUE(ring.publish(numbered_message(i)));
+  }
+  ASSERT_TRUE(subscription.read(msg));
+  EXPECT_EQ(numbered_message(2), msg);
+  EXPECT_EQ(2, subscription.num_lagged());
+  EXPECT_EQ(3, subscription.available());
+}
+
+TEST(BroadcastRingTest, UnsubscribeFreesSubscriberSlot) {
+  RingType ring{};
+  std::vector<RingType::Subscription> subscriptions{};
+  for (size_t i = 0; i < ring.max_subscribers(); ++i) {
+    subscriptions.push_back(ring.subscribe(SubscriberPolicy::BACKPRESSURE));
+    ASSERT_TRUE(subscriptions.back().is_subscribed());
+  }
+  EXPECT_FALSE(ring.subscribe(SubscriberPolicy::BACKPRESSURE).is_subscribed());
+
+  // An unsubscribed BACKPRESSURE subscriber no longer holds back the publisher.
+  for (uint8_t i = 0; i < ring.capacity(); ++i) {
+    ASSERT_TRUE(ring.publish(numbered_message(i)));
+  }
+  for (auto& subscription : subscriptions) {
+    subscription.unsubscribe();
+  }
+  EXPECT_TRUE(ring.publish(numbered_message(4)));
+  EXPECT_TRUE(ring.subscribe(SubscriberPolicy::BACKPRESSURE).is_subscribed());
+}
+
+TEST(BroadcastRingTest, ConcurrentSubscribersSeeEveryMessageInOrder) {
+  static constexpr uint64_t NUM_MESSAGES{100'000};
+  static BroadcastRing<uint64_t, 64, 2> ring{};
+  auto first{ring.subscribe(SubscriberPolicy::BACKPRESSURE)};
+  auto second{ring.subscribe(SubscriberPolicy::BACKPRESSURE)};
+
+  auto consume{[](BroadcastRing<uint64_t, 64, 2>::Subscription& subscription) {
+    uint64_t expected{0};
+    bool in_order{true};
+    while (expected < NUM_MESSAGES) {
+      const size_t num_received{subscription.poll([&](uint64_t value) {
+        in_order = in_order && value == expected;
+        ++expected;
+      })};
+      if (num_received == 0) {
+        std::this_thread::yield();
+      }
+    }
+    return in_order;
+  }};
+
+  bool first_in_order{};
+  bool second_in_order{};
+  std::thread first_consumer{[&]() { first_in_order = consume(first); }};
+  std::thread second_consumer{[&]() { second_in_order = consume(second); }};
+  for (uint64_t i = 0; i < NUM_MESSAGES; ++i) {
+    while (!ring.publish(i)) {
+      std::this_thread::yield();
+    }
+  }
+  first_consumer.join();
+  second_consumer.join();
+
+  EXPECT_TRUE(first_in_order);
+  EXPECT_TRUE(second_in_order);
+  EXPECT_EQ(NUM_MESSAGES, ring.num_published());
+}
+
+}  // namespace tvsc::message
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "message/message.h"
+
+namespace tvsc::message {
+
+/**
+ * Bitmask of message Types, for choosing the Types that a CoalescingRingBuffer coalesces.
+ */
+template <Type... TYPES>
+inline constexpr uint32_t TYPE_MASK{(0 | ... | (uint32_t{1} << static_cast<uint32_t>(TYPES)))};
+
+/**
+ * Fixed capacity ring of messages that keeps only the latest pending message of each coalesced
+ * Type.
+ *
+ * Periodic messages, such as TELEMETRY samples, make a RingBuffer fill with stale values of the
+ * same quantity. Here, pushing a message of a Type in COALESCED_TYPES while another message of
+ * that Type is pending replaces the pending message in place, so a consumer always sees the latest
+ * value, and a flood of such messages takes a single slot. This is a last-value cache.
+ *
+ * The identifier of a message is its Type, so coalescing treats every message of a Type as the
+ * same quantity. That is only safe for Types where a newer message supersedes an older one. Two
+ * COMMAND messages for different subsystems, or two EMERGENCY messages, are both needed, so by
+ * default, only TELEMETRY is coalesced. All other messages, including those with identifiers that
+ * are not a Type, are kept in FIFO order, and push() refuses them when the ring is full.
+ *
+ * A replaced message keeps its place in FIFO order. A bitmask of pending coalesced Types and the
+ * position of each one's pending message make push(), peek() and pop() take constant time. The API
+ * matches RingBuffer so that the two can be used interchangeably by Queue. ElementT can be a
+ * message or a handle to one, like MessagePool::Handle.
+ */
+template <typename ElementT, size_t CAPACITY, uint32_t COALESCED_TYPES = TYPE_MASK<Type::TELEMETRY>>
+class CoalescingRingBuffer final {
+ public:
+  using ElementType = ElementT;
+
+ private:
+  static_assert(CAPACITY > 0, "CoalescingRingBuffer must hold at least one message");
+  static_assert(NUM_TYPES <= 32, "CoalescingRingBuffer supports at most 32 Types");
+
+  size_t begin_{};
+  size_t end_{};
+  std::array<ElementType, CAPACITY> elements_{};
+  // Bit i is set when a message with identifier i is pending and Type i is coalesced.
+  uint32_t pending_{};
+  // Position, counted like begin_ and end_, of the pending message of each coalesced Type.
+  std::array<size_t, NUM_TYPES> pending_positions_{};
+  size_t num_coalesced_{};
+
+  static constexpr bool is_coalesced(uint32_t identifier) {
+    return identifier < NUM_TYPES && (COALESCED_TYPES & (uint32_t{1} << identifier)) != 0;
+  }
+
+  template <typename T>
+  bool push_element(T&& msg) {
+    const uint32_t identifier{message_of(msg).identifier()};
+    if (is_pending(identifier)) {
+      elements_[pending_positions_[identifier] % elements_.size()] = std::forward<T>(msg);
+      ++num_coalesced_;
+      return true;
+    }
+    if (end_ - begin_ == elements_.size()) {
+      return false;
+    }
+    if (is_coalesced(identifier)) {
+      pending_ |= uint32_t{1} << identifier;
+      pending_positions_[identifier] = end_;
+    }
+    elements_[end_ % elements_.size()] = std::forward<T>(msg);
+    ++end_;
+    return true;
+  }
+
+ public:
+  bool is_empty() const { return end_ == begin_; }
+  size_t size() const { return end_ - begin_; }
+  constexpr size_t capacity() const { return elements_.size(); }
+
+  /**
+   * Whether a message of the given coalesced Type is waiting to be popped. Always false for Types
+   * that are not coalesced.
+   */
+  bool is_pending(uint32_t identifier) const {
+    return is_coalesced(identifier) && (pending_ & (uint32_t{1} << identifier)) != 0;
+  }
+
+  /**
+   * Number of pushed messages that replaced a pending message of the same Type.
+   */
+  size_t num_coalesced() const { return num_coalesced_; }
+
+  /**
+   * Always succeeds for a coalesced Type with a pending message, replacing that message. Otherwise,
+   * refuses the message if the ring is full.
+   */
+  [[nodiscard]] bool push(const ElementType& msg) { return push_element(msg); }
+  [[nodiscard]] bool push(ElementType&& msg) { return push_element(std::move(msg)); }
+
+  const auto& peek(size_t index = 0) const {
+    return elements_[(begin_ + index) % elements_.size()];
+  }
+
+  void pop() {
+    if (is_empty()) {
+      return;
+    }
+    ElementType& element{elements_[begin_ % elements_.size()]};
+    const uint32_t identifier{message_of(element).identifier()};
+    if (is_pending(identifier)) {
+      // A coalesced Type has at most one message in the ring, so this is its pending message.
+      pending_ &= ~(uint32_t{1} << identifier);
+    }
+    if constexpr (!std::is_trivially_destructible_v<ElementType>) {
+      // As in RingBuffer, release any resources held by the element now.
+      element = ElementType{};
+    }
+    ++begin_;
+  }
+};
+
+}  // namespace tvsc::message
@@ -0,0 +1,394 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "buffer/buffer_view.h"
+#include "message/message.h"
+
+namespace tvsc::message {
+
+enum class Endian : uint8_t {
+  // Most significant byte first. This is the order of the bit stream that fields are packed into,
+  // so it is the only order available to fields that are not whole, byte-aligned bytes.
+  BIG,
+  // Least significant byte first. Only available to fields of whole bytes starting on a byte
+  // boundary.
+  LITTLE,
+};
+
+namespace internal {
+
+template <typename T>
+struct MemberPointerTraits;
+
+template <typename StructT, typename MemberT>
+struct MemberPointerTraits<MemberT StructT::*> final {
+  using StructType = StructT;
+  using MemberType = MemberT;
+};
+
+template <typename T>
+concept Encodable = std::is_integral_v<T> || std::is_enum_v<T> || std::is_floating_point_v<T>;
+
+template <typename T>
+struct UnsignedRepresentation final {
+  using type = std::make_unsigned_t<T>;
+};
+
+template <typename T>
+  requires std::is_enum_v<T>
+struct UnsignedRepresentation<T> final {
+  using type = std::make_unsigned_t<std::underlying_type_t<T>>;
+};
+
+template <>
+struct UnsignedRepresentation<bool> final {
+  using type = uint8_t;
+};
+
+template <>
+struct UnsignedRepresentation<float> final {
+  using type = uint32_t;
+};
+
+template <>
+struct UnsignedRepresentation<double> final {
+  using type = uint64_t;
+};
+
+template <typename T>
+using UnsignedRepresentationType = typename UnsignedRepresentation<T>::type;
+
+/**
+ * Write the low BITS bits of value into the bit stream at BIT_OFFSET, most significant bit first.
+ * Bits of data outside of the field are preserved. Each step writes the part of the field in one
+ * byte and recurses on the rest, so that every shift and mask is a compile-time constant; a whole,
+ * byte-aligned byte is a single store.
+ */
+template <size_t BIT_OFFSET, size_t BITS>
+constexpr void write_bits(uint8_t* data, uint64_t value) {
+  if constexpr (BITS > 0) {
+    constexpr size_t BIT_IN_BYTE{BIT_OFFSET % 8};
+    constexpr size_t COUNT{std::min(8 - BIT_IN_BYTE, BITS)};
+    constexpr size_t SHIFT{8 - BIT_IN_BYTE - COUNT};
+    constexpr uint8_t MASK{static_cast<uint8_t>(((1U << COUNT) - 1) << SHIFT)};
+    const uint8_t bits{static_cast<uint8_t>((value >> (BITS - COUNT)) << SHIFT)};
+    if constexpr (COUNT == 8) {
+      data[BIT_OFFSET / 8] = bits;
+    } else {
+      data[BIT_OFFSET / 8] = static_cast<uint8_t>((data[BIT_OFFSET / 8] & ~MASK) | (bits & MASK));
+    }
+    write_bits<BIT_OFFSET + COUNT, BITS - COUNT>(data, value);
+  }
+}
+
+template <size_t BIT_OFFSET, size_t BITS>
+constexpr uint64_t read_bits(const uint8_t* data, uint64_t value = 0) {
+  if constexpr (BITS > 0) {
+    constexpr size_t BIT_IN_BYTE{BIT_OFFSET % 8};
+    constexpr size_t COUNT{std::min(8 - BIT_IN_BYTE, BITS)};
+    constexpr size_t SHIFT{8 - BIT_IN_BYTE - COUNT};
+    value = (value << COUNT) | ((data[BIT_OFFSET / 8] >> SHIFT) & ((1U << COUNT) - 1));
+    return read_bits<BIT_OFFSET + COUNT, BITS - COUNT>(data, value);
+  } else {
+    return value;
+  }
+}
+
+template <size_t BYTE_OFFSET, size_t... INDICES>
+constexpr void write_little_endian(uint8_t* data, uint64_t value, std::index_sequence<INDICES...>) {
+  ((data[BYTE_OFFSET + INDICES] = static_cast<uint8_t>(value >> (8 * INDICES))), ...);
+}
+
+template <size_t BYTE_OFFSET, size_t... INDICES>
+constexpr uint64_t read_little_endian(const uint8_t* data, std::index_sequence<INDICES...>) {
+  return ((uint64_t{data[BYTE_OFFSET + INDICES]} << (8 * INDICES)) | ... | 0);
+}
+
+}  // namespace internal
+
+/**
+ * A member of a structure and how it is laid out in an encoded payload: its width in bits and
+ * its byte order. Integers, enums and bools may be narrower than their type, as long as their
+ * values fit in BITS; signed values are sign-extended when decoded. Floating point fields must use
+ * their full width.
+ *
+ * Fields do not carry their offset. A Codec packs its fields one after another in the order they
+ * are listed.
+ */
+template <auto MEMBER, size_t BITS = 8 * sizeof(typename internal::MemberPointerTraits<
+                                               decltype(MEMBER)>::MemberType),
+          Endian ENDIAN = Endian::BIG>
+struct Field final {
+  using StructType = typename internal::MemberPointerTraits<decltype(MEMBER)>::StructType;
+  using MemberType = typename internal::MemberPointerTraits<decltype(MEMBER)>::MemberType;
+  using RepresentationType = internal::UnsignedRepresentationType<MemberType>;
+
+  static constexpr size_t bits() { return BITS; }
+  static constexpr Endian endian() { return ENDIAN; }
+
+  static_assert(internal::Encodable<MemberType>,
+                "Fields must be integers, enums, bools or floating point values");
+  static_assert(BITS > 0, "Fields must have at least one bit");
+  static_assert(BITS <= 8 * sizeof(RepresentationType),
+                "Field is wider than the member that it encodes");
+  static_assert(!std::is_floating_point_v<MemberType> || BITS == 8 * sizeof(MemberType),
+                "Floating point fields cannot be narrowed");
+  static_assert(ENDIAN == Endian::BIG || BITS % 8 == 0,
+                "Little endian fields must be a whole number of bytes");
+
+  template <size_t BIT_OFFSET>
+  static constexpr void encode(const StructType& value, uint8_t* data) {
+    static_assert(ENDIAN == Endian::BIG || BIT_OFFSET % 8 == 0,
+                  "Little endian fields must start on a byte boundary");
+    const uint64_t bits{static_cast<uint64_t>(to_representation(value.*MEMBER))};
+    if constexpr (ENDIAN == Endian::BIG) {
+      internal::write_bits<BIT_OFFSET, BITS>(data, bits);
+    } else {
+      internal::write_little_endian<BIT_OFFSET / 8>(data, bits,
+                                                    std::make_index_sequence<BITS / 8>{});
+    }
+  }
+
+  /**
+   * Decode the field into value. Returns false if the encoded bits are not a valid value of the
+   * member: a bool that is neither zero nor one.
+   */
+  template <size_t BIT_OFFSET>
+  static constexpr bool decode(const uint8_t* data, StructType& value) {
+    uint64_t bits{};
+    if constexpr (ENDIAN == Endian::BIG) {
+      bits = internal::read_bits<BIT_OFFSET, BITS>(data);
+    } else {
+      bits = internal::read_little_endian<BIT_OFFSET / 8>(data,
+                                                          std::make_index_sequence<BITS / 8>{});
+    }
+
+    if constexpr (std::is_same_v<MemberType, bool>) {
+      if (bits > 1) {
+        return false;
+      }
+      value.*MEMBER = bits != 0;
+    } else if constexpr (std::is_floating_point_v<MemberType>) {
+      value.*MEMBER = std::bit_cast<MemberType>(static_cast<RepresentationType>(bits));
+    } else {
+      if constexpr (is_signed_member() && BITS < 64) {
+        // Sign-extend from the top bit of the field.
+        const uint64_t sign_bit{uint64_t{1} << (BITS - 1)};
+        bits = (bits ^ sign_bit) - sign_bit;
+      }
+      value.*MEMBER = static_cast<MemberType>(bits);
+    }
+    return true;
+  }
+
+ private:
+  static constexpr bool is_signed_member() {
+    if constexpr (std::is_enum_v<MemberType>) {
+      return std::is_signed_v<std::underlying_type_t<MemberType>>;
+    } else {
+      return std::is_signed_v<MemberType>;
+    }
+  }
+
+  static constexpr RepresentationType to_representation(MemberType member) {
+    if constexpr (std::is_floating_point_v<MemberType>) {
+      return std::bit_cast<RepresentationType>(member);
+    } else {
+      RepresentationType bits{static_cast<RepresentationType>(member)};
+      if constexpr (BITS < 8 * sizeof(RepresentationType)) {
+        bits &= static_cast<RepresentationType>((RepresentationType{1} << BITS) - 1);
+      }
+      return bits;
+    }
+  }
+};
+
+/**
+ * BITS bits that are not used by any member. They are encoded as zeros and ignored when decoding,
+ * and they can be used to align later fields or to reserve space for later versions of a layout.
+ */
+template <size_t BITS>
+struct Padding final {
+  static_assert(BITS > 0, "Padding must have at least one bit");
+
+  static constexpr size_t bits() { return BITS; }
+
+  template <size_t BIT_OFFSET, typename StructT>
+  static constexpr void encode(const StructT& value, uint8_t* data) {
+    if constexpr (BITS <= 64) {
+      internal::write_bits<BIT_OFFSET, BITS>(data, 0);
+    } else {
+      internal::write_bits<BIT_OFFSET, 64>(data, 0);
+      Padding<BITS - 64>::template encode<BIT_OFFSET + 64>(value, data);
+    }
+  }
+
+  template <size_t BIT_OFFSET, typename StructT>
+  static constexpr bool decode(const uint8_t* /*data*/, StructT& /*value*/) {
+    return true;
+  }
+};
+
+/**
+ * Compile-time layout of a structure in a message payload, and the functions to encode and decode
+ * it.
+ *
+ * The fields are packed into a bit stream in the order they are listed, with no implicit padding.
+ * The layout is computed at compile time, so encode() and decode() reduce to shifts, masks and
+ * stores at constant offsets. They do not allocate, and they write directly into the payload of a
+ * Message or a Fragment. Encoding into a Message or Fragment that is too small for the layout is a
+ * compile error.
+ *
+ * Example:
+ *
+ *   struct Status final {
+ *     Subsystem subsystem;
+ *     bool enabled;
+ *     uint8_t mode;
+ *     int16_t temperature;
+ *   };
+ *
+ *   using StatusCodec = Codec<Status, Field<&Status::subsystem>, Field<&Status::enabled, 1>,
+ *                             Field<&Status::mode, 3>, Padding<4>, Field<&Status::temperature>>;
+ *
+ * encodes a Status in 4 bytes: the subsystem, a byte holding the enabled flag in its most
+ * significant bit and the mode in the three bits below it, then the temperature, big endian.
+ */
+template <typename StructT, typename... FieldTs>
+class Codec final {
+ public:
+  using StructType = StructT;
+
+ private:
+  static_assert(sizeof...(FieldTs) > 0, "Codec must have at least one field");
+
+  static constexpr std::array<size_t, sizeof...(FieldTs)> BIT_OFFSETS{[]() {
+    std::array<size_t, sizeof...(FieldTs)> offsets{};
+    const std::array<size_t, sizeof...(FieldTs)> widths{FieldTs::bits()...};
+    size_t offset{0};
+    for (size_t i = 0; i < widths.size(); ++i) {
+      offsets[i] = offset;
+      offset += widths[i];
+    }
+    return offsets;
+  }()};
+
+  static constexpr size_t SIZE_BITS{(FieldTs::bits() + ...)};
+  static constexpr size_t SIZE{(SIZE_BITS + 7) / 8};
+
+  template <size_t... INDICES>
+  static constexpr void encode_fields(const StructType& value, uint8_t* data,
+                                      std::index_sequence<INDICES...>) {
+    (FieldTs::template encode<BIT_OFFSETS[INDICES]>(value, data), ...);
+  }
+
+  template <size_t... INDICES>
+  static constexpr bool decode_fields(const uint8_t* data, StructType& value,
+                                      std::index_sequence<INDICES...>) {
+    return (FieldTs::template decode<BIT_OFFSETS[INDICES]>(data, value) & ...);
+  }
+
+ public:
+  /**
+   * Number of bytes in the encoded payload. Unused bits in the last byte are encoded as zeros.
+   */
+  static constexpr size_t size() { return SIZE; }
+  static constexpr size_t size_bits() { return SIZE_BITS; }
+
+  /**
+   * Encode value into the first size() bytes of data. The data must hold at least size() bytes.
+   */
+  static constexpr void encode(const StructType& value, uint8_t* data) {
+    if constexpr (SIZE_BITS % 8 != 0) {
+      data[SIZE - 1] = 0;
+    }
+    encode_fields(value, data, std::index_sequence_for<FieldTs...>{});
+  }
+
+  /**
+   * Decode value from the first size() bytes of data. The data must hold at least size() bytes.
+   * Returns false if a field holds an invalid value, in which case value is partially decoded.
+   */
+  static constexpr bool decode(const uint8_t* data, StructType& value) {
+    return decode_fields(data, value, std::index_sequence_for<FieldTs...>{});
+  }
+
+  /**
+   * Encode value into the bytes viewed by destination. Returns false, without writing anything, if
+   * the view is smaller than size().
+   */
+  static bool encode(const StructType& value, buffer::BufferView<uint8_t> destination) {
+    if (destination.size() < SIZE) {
+      return false;
+    }
+    encode(value, destination.data());
+    return true;
+  }
+
+  /**
+   * Decode value from the bytes viewed by source. Returns false if the view is smaller than size()
+   * or if a field holds an invalid value.
+   */
+  static bool decode(buffer::BufferView<const uint8_t> source, StructType& value) {
+    return source.size() >= SIZE && decode(source.data(), value);
+  }
+
+  /**
+   * Replace the payload of msg with the encoded value. The identifier is not changed.
+   */
+  template <size_t MTU>
+  static void encode(const StructType& value, Message<MTU>& msg) {
+    static_assert(SIZE <= MTU, "Encoded layout does not fit in the message MTU");
+    // Keep the unused part of the payload zeroed so that Message::operator== only depends on the
+    // contents. Only the bytes of a longer previous payload need to be cleared.
+    if (msg.size() > SIZE) {
+      std::memset(msg.payload().data() + SIZE, 0, msg.size() - SIZE);
+    }
+    encode(value, msg.payload().data());
+    msg.set_size(SIZE);
+  }
+
+  template <size_t MTU>
+  static bool decode(const Message<MTU>& msg, StructType& value) {
+    return decode(msg.payload_view(), value);
+  }
+
+  /**
+   * Replace the payload of a radio Fragment with the encoded value. The header is not changed.
+   *
+   * This is written against the interface of comms::radio::Fragment, rather than the class itself,
+   * to avoid a dependency from messages on the radio code.
+   */
+  template <typename FragmentT>
+    requires requires(FragmentT& fragment) {
+      { FragmentT::max_payload_size() } -> std::convertible_to<size_t>;
+      { fragment.payload_start() } -> std::same_as<uint8_t*>;
+      fragment.set_payload_size(size_t{});
+    }
+  static void encode(const StructType& value, FragmentT& fragment) {
+    static_assert(SIZE <= FragmentT::max_payload_size(),
+                  "Encoded layout does not fit in the fragment MTU");
+    encode(value, fragment.payload_start());
+    fragment.set_payload_size(SIZE);
+  }
+
+  template <typename FragmentT>
+    requires requires(const FragmentT& fragment) {
+      { fragment.payload() } -> std::convertible_to<buffer::BufferView<const uint8_t>>;
+      { fragment.payload_start() } -> std::same_as<const uint8_t*>;
+    }
+  static bool decode(const FragmentT& fragment, StructType& value) {
+    return decode(buffer::BufferView<const uint8_t>{fragment.payload()}, value);
+  }
+};
+
+}  // namespace tvsc::message
@@ -0,0 +1,164 @@
+/**
+ * Compares encoding and decoding structures with a Codec to serializing the same structures with
+ * protobuf. Both write into and read from a fixed buffer, so neither benchmark measures allocation
+ * of the output.
+ *
+ *   bazel run -c opt //message:codec_benchmark
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "message/codec.h"
+#include "message/codec_benchmark.pb.h"
+#include "message/leds.h"
+#include "message/message.h"
+
+namespace tvsc::message {
+
+struct Status final {
+  Subsystem subsystem{};
+  bool enabled{};
+  uint8_t mode{};
+  int16_t temperature{};
+};
+
+using StatusCodec = Codec<Status, Field<&Status::subsystem>, Field<&Status::enabled, 1>,
+                          Field<&Status::mode, 3>, Padding<4>, Field<&Status::temperature>>;
+
+struct Reading final {
+  uint16_t sensor_id{};
+  int8_t offset{};
+  uint32_t counter{};
+  float value{};
+};
+
+using ReadingCodec =
+    Codec<Reading, Field<&Reading::sensor_id, 12>, Field<&Reading::offset, 4>,
+          Field<&Reading::counter, 32, Endian::LITTLE>, Field<&Reading::value>>;
+
+static constexpr size_t MTU{64};
+
+void BM_CodecEncodeLedCommand(benchmark::State& state) {
+  Message<MTU> msg{Type::COMMAND};
+  LedCommand command{};
+  for (auto _ : state) {
+    command.turn_on = !command.turn_on;
+    benchmark::DoNotOptimize(command);
+    LedCommandCodec::encode(command, msg);
+    benchmark::DoNotOptimize(msg);
+  }
+  state.counters["bytes"] = static_cast<double>(msg.size());
+}
+BENCHMARK(BM_CodecEncodeLedCommand);
+
+void BM_ProtobufEncodeLedCommand(benchmark::State& state) {
+  std::array<uint8_t, MTU> buffer{};
+  LedCommandProto command{};
+  command.set_subsystem(static_cast<uint32_t>(Subsystem::LED));
+  size_t size{};
+  for (auto _ : state) {
+    command.set_turn_on(!command.turn_on());
+    benchmark::DoNotOptimize(command);
+    size = command.ByteSizeLong();
+    command.SerializeToArray(buffer.data(), static_cast<int>(size));
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.counters["bytes"] = static_cast<double>(size);
+}
+BENCHMARK(BM_ProtobufEncodeLedCommand);
+
+void BM_CodecEncodeStatus(benchmark::State& state) {
+  Message<MTU> msg{Type::TELEMETRY};
+  Status status{Subsystem::MAGNETORQUER, true, 5, -40};
+  for (auto _ : state) {
+    ++status.temperature;
+    benchmark::DoNotOptimize(status);
+    StatusCodec::encode(status, msg);
+    benchmark::DoNotOptimize(msg);
+  }
+  state.counters["bytes"] = static_cast<double>(msg.size());
+}
+BENCHMARK(BM_CodecEncodeStatus);
+
+void BM_ProtobufEncodeStatus(benchmark::State& state) {
+  std::array<uint8_t, MTU> buffer{};
+  StatusProto status{};
+  status.set_subsystem(static_cast<uint32_t>(Subsystem::MAGNETORQUER));
+  status.set_enabled(true);
+  status.set_mode(5);
+  status.set_temperature(-40);
+  size_t size{};
+  for (auto _ : state) {
+    status.set_temperature(status.temperature() + 1);
+    benchmark::DoNotOptimize(status);
+    size = status.ByteSizeLong();
+    status.SerializeToArray(buffer.data(), static_cast<int>(size));
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.counters["bytes"] = static_cast<double>(size);
+}
+BENCHMARK(BM_ProtobufEncodeStatus);
+
+void BM_CodecEncodeReading(benchmark::State& state) {
+  Message<MTU> msg{Type::TELEMETRY};
+  Reading reading{0x123, -3, 0, 21.5f};
+  for (auto _ : state) {
+    ++reading.counter;
+    benchmark::DoNotOptimize(reading);
+    ReadingCodec::encode(reading, msg);
+    benchmark::DoNotOptimize(msg);
+  }
+  state.counters["bytes"] = static_cast<double>(msg.size());
+}
+BENCHMARK(BM_CodecEncodeReading);
+
+void BM_ProtobufEncodeReading(benchmark::State& state) {
+  std::array<uint8_t, MTU> buffer{};
+  ReadingProto reading{};
+  reading.set_sensor_id(0x123);
+  reading.set_offset(-3);
+  reading.set_value(21.5f);
+  size_t size{};
+  for (auto _ : state) {
+    reading.set_counter(reading.counter() + 1);
+    benchmark::DoNotOptimize(reading);
+    size = reading.ByteSizeLong();
+    reading.SerializeToArray(buffer.data(), static_cast<int>(size));
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.counters["bytes"] = static_cast<double>(size);
+}
+BENCHMARK(BM_ProtobufEncodeReading);
+
+void BM_CodecDecodeReading(benchmark::State& state) {
+  Message<MTU> msg{Type::TELEMETRY};
+  ReadingCodec::encode(Reading{0x123, -3, 1000000, 21.5f}, msg);
+  Reading reading{};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(ReadingCodec::decode(msg, reading));
+    benchmark::DoNotOptimize(reading);
+  }
+}
+BENCHMARK(BM_CodecDecodeReading);
+
+void BM_ProtobufDecodeReading(benchmark::State& state) {
+  std::array<uint8_t, MTU> buffer{};
+  ReadingProto reading{};
+  reading.set_sensor_id(0x123);
+  reading.set_offset(-3);
+  reading.set_counter(1000000);
+  reading.set_value(21.5f);
+  const int size{static_cast<int>(reading.ByteSizeLong())};
+  reading.SerializeToArray(buffer.data(), size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(buffer);
+    benchmark::DoNotOptimize(reading.ParseFromArray(buffer.data(), size));
+    benchmark::DoNotOptimize(reading);
+  }
+}
+BENCHMARK(BM_ProtobufDecodeReading);
+
+}  // namespace tvsc::message
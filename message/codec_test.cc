@@ -0,0 +1,172 @@
+#include "message/codec.h"
+
+#include <array>
+#include <cstdint>
+
+#include "comms/radio/fragment.h"
+#include "gtest/gtest.h"
+#include "message/leds.h"
+#include "message/message.h"
+
+namespace tvsc::message {
+
+struct Status final {
+  Subsystem subsystem{};
+  bool enabled{};
+  uint8_t mode{};
+  int16_t temperature{};
+
+  bool operator==(const Status& rhs) const = default;
+};
+
+using StatusCodec = Codec<Status, Field<&Status::subsystem>, Field<&Status::enabled, 1>,
+                          Field<&Status::mode, 3>, Padding<4>, Field<&Status::temperature>>;
+
+struct Reading final {
+  uint16_t sensor_id{};
+  int8_t offset{};
+  uint32_t counter{};
+  float value{};
+
+  bool operator==(const Reading& rhs) const = default;
+};
+
+using ReadingCodec =
+    Codec<Reading, Field<&Reading::sensor_id, 12>, Field<&Reading::offset, 4>,
+          Field<&Reading::counter, 32, Endian::LITTLE>, Field<&Reading::value>>;
+
+TEST(CodecTest, SizeIsComputedFromFieldWidths) {
+  static_assert(StatusCodec::size() == 4);
+  static_assert(StatusCodec::size_bits() == 32);
+  static_assert(ReadingCodec::size() == 10);
+  static_assert(LedCommandCodec::size() == 2);
+}
+
+TEST(CodecTest, EncodesBigEndianByDefault) {
+  std::array<uint8_t, StatusCodec::size()> bytes{};
+  StatusCodec::encode(Status{Subsystem::MAGNETORQUER, false, 0, 0x1234}, bytes.data());
+  EXPECT_EQ(0x02, bytes[0]);
+  EXPECT_EQ(0x12, bytes[2]);
+  EXPECT_EQ(0x34, bytes[3]);
+}
+
+TEST(CodecTest, PacksBitFieldsMostSignificantBitFirst) {
+  std::array<uint8_t, StatusCodec::size()> bytes{0xff, 0xff, 0xff, 0xff};
+  const Status status{Subsystem::LED, true, 5, -2};
+  StatusCodec::encode(status, bytes.data());
+  // enabled, then mode 0b101, then four bits of padding.
+  EXPECT_EQ((std::array<uint8_t, 4>{0x01, 0b1101'0000, 0xff, 0xfe}), bytes);
+
+  Status decoded{};
+  EXPECT_TRUE(StatusCodec::decode(bytes.data(), decoded));
+  EXPECT_EQ(status, decoded);
+}
+
+TEST(CodecTest, CanEncodeLittleEndianFields) {
+  std::array<uint8_t, ReadingCodec::size()> bytes{};
+  ReadingCodec::encode(Reading{0xabc, -3, 0x01020304, 1.f}, bytes.data());
+  EXPECT_EQ(0xab, bytes[0]);
+  EXPECT_EQ(0xcd, bytes[1]);
+  EXPECT_EQ(0x04, bytes[2]);
+  EXPECT_EQ(0x03, bytes[3]);
+  EXPECT_EQ(0x02, bytes[4]);
+  EXPECT_EQ(0x01, bytes[5]);
+  // 1.f is 0x3f800000.
+  EXPECT_EQ(0x3f, bytes[6]);
+  EXPECT_EQ(0x80, bytes[7]);
+  EXPECT_EQ(0x00, bytes[9]);
+}
+
+TEST(CodecTest, RoundTripsNarrowSignedAndFloatingPointFields) {
+  const Reading reading{0xfff, -8, 0xffffffff, -273.15f};
+  std::array<uint8_t, ReadingCodec::size()> bytes{};
+  ReadingCodec::encode(reading, bytes.data());
+
+  Reading decoded{};
+  EXPECT_TRUE(ReadingCodec::decode(bytes.data(), decoded));
+  EXPECT_EQ(reading, decoded);
+}
+
+TEST(CodecTest, CanEncodeAndDecodeAtCompileTime) {
+  constexpr auto bytes{[]() {
+    std::array<uint8_t, StatusCodec::size()> result{};
+    StatusCodec::encode(Status{Subsystem::LED, true, 3, -1}, result.data());
+    return result;
+  }()};
+  static_assert(bytes[1] == 0b1011'0000);
+
+  constexpr Status decoded{[&bytes]() {
+    Status result{};
+    StatusCodec::decode(bytes.data(), result);
+    return result;
+  }()};
+  static_assert(decoded.temperature == -1);
+  static_assert(decoded.mode == 3);
+}
+
+TEST(CodecTest, EncodeReplacesMessagePayload) {
+  const std::array<uint8_t, 8> long_payload{9, 9, 9, 9, 9, 9, 9, 9};
+  CanBusMessage message{Type::COMMAND};
+  message.set_payload(long_payload);
+
+  StatusCodec::encode(Status{Subsystem::LED, false, 0, 7}, message);
+
+  CanBusMessage expected{Type::COMMAND};
+  const std::array<uint8_t, 4> bytes{0x01, 0x00, 0x00, 0x07};
+  expected.set_payload(bytes);
+  EXPECT_EQ(expected, message);
+}
+
+TEST(CodecTest, LedCommandsKeepTheirWireFormat) {
+  CanBusMessage expected{Type::COMMAND};
+  const std::array<uint8_t, 2> on_bytes{0x01, 0x01};
+  expected.set_payload(on_bytes);
+  EXPECT_EQ(expected, led_on_command<CanBusMessage::mtu()>());
+
+  const std::array<uint8_t, 2> off_bytes{0x01, 0x00};
+  expected.set_payload(off_bytes);
+  EXPECT_EQ(expected, led_off_command<CanBusMessage::mtu()>());
+}
+
+TEST(CodecTest, DecodeRejectsShortPayloadsAndInvalidBools) {
+  CanBusMessage message{Type::COMMAND};
+  const std::array<uint8_t, 1> short_bytes{0x01};
+  message.set_payload(short_bytes);
+  LedCommand command{};
+  EXPECT_FALSE(LedCommandCodec::decode(message, command));
+
+  const std::array<uint8_t, 2> invalid_bytes{0x01, 0x02};
+  message.set_payload(invalid_bytes);
+  EXPECT_FALSE(LedCommandCodec::decode(message, command));
+
+  EXPECT_TRUE(LedCommandCodec::decode(led_on_command<CanBusMessage::mtu()>(), command));
+  EXPECT_EQ(Subsystem::LED, command.subsystem);
+  EXPECT_TRUE(command.turn_on);
+}
+
+TEST(CodecTest, EncodeIntoViewChecksSize) {
+  std::array<uint8_t, StatusCodec::size() - 1> too_small{};
+  EXPECT_FALSE(StatusCodec::encode(Status{}, buffer::BufferView<uint8_t>{too_small}));
+
+  std::array<uint8_t, StatusCodec::size() + 1> large_enough{};
+  EXPECT_TRUE(StatusCodec::encode(Status{Subsystem::LED, true, 1, 2},
+                                  buffer::BufferView<uint8_t>{large_enough}));
+  Status decoded{};
+  EXPECT_TRUE(StatusCodec::decode(buffer::BufferView<const uint8_t>{large_enough}, decoded));
+  EXPECT_EQ(2, decoded.temperature);
+}
+
+TEST(CodecTest, CanEncodeDirectlyIntoFragment) {
+  comms::radio::Fragment<64> fragment{};
+  fragment.set_sender_id(3);
+  const Reading reading{42, 1, 1000, 3.5f};
+  ReadingCodec::encode(reading, fragment);
+
+  EXPECT_EQ(3, fragment.sender_id());
+  EXPECT_EQ(ReadingCodec::size(), fragment.payload_size());
+  Reading decoded{};
+  EXPECT_TRUE(ReadingCodec::decode(fragment, decoded));
+  EXPECT_EQ(reading, decoded);
+}
+
+}  // namespace tvsc::message
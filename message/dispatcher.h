@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "message/message.h"
+#include "message/processor.h"
+
+namespace tvsc::message {
+
+/**
+ * Table that routes each message to the processors registered for its Type and Subsystem.
+ *
+ * Queue::process_next_message() offers each message to every attached processor in turn, one
+ * virtual call each, until one of them handles it. A Dispatcher instead decodes the Type from the
+ * message identifier and, for COMMAND messages, the Subsystem from the first byte of the payload.
+ * It then looks up the processors for that pair in a fixed table, so routing takes constant time,
+ * regardless of the number of processors, and processors only see the messages routed to them.
+ *
+ * Processors can be attached for a Type alone or for a Type and Subsystem. Processors attached for
+ * a Type and Subsystem replace those attached for the Type alone for messages to that Subsystem.
+ * Messages with identifiers beyond the last Type are not routed.
+ *
+ * MessageT can be a message or a handle to one, like MessagePool::Handle.
+ *
+ * By default, each route has a single processor. Fan-out is opt-in: with PROCESSORS_PER_ROUTE
+ * greater than one, each message is offered to every processor on its route, whether or not an
+ * earlier processor handled it.
+ *
+ * Attaching processors is constexpr, so a table whose processors have static storage duration can
+ * be built at compile time:
+ *
+ *   constinit Dispatcher<CanBusMessage> dispatcher{[]() {
+ *     Dispatcher<CanBusMessage> result{};
+ *     (void)result.attach_processor(Type::COMMAND, Subsystem::LED, led_control);
+ *     return result;
+ *   }()};
+ */
+template <typename MessageT, size_t PROCESSORS_PER_ROUTE = 1>
+class Dispatcher final {
+ public:
+  using MessageType = MessageT;
+  using ProcessorType = Processor<MessageType>;
+
+ private:
+  static_assert(PROCESSORS_PER_ROUTE > 0, "Dispatcher must allow at least one processor per route");
+
+  using Route = std::array<ProcessorType*, PROCESSORS_PER_ROUTE>;
+
+  // Subsystem zero is unused, so column zero holds the processors attached for a Type alone.
+  static constexpr size_t ANY_SUBSYSTEM{0};
+
+  std::array<std::array<Route, NUM_SUBSYSTEMS>, NUM_TYPES> routes_{};
+
+  static size_t subsystem_index(const MessageType& element) {
+    const auto& msg{message_of(element)};
+    if (msg.retrieve_type() == Type::COMMAND && msg.size() > 0 &&
+        msg.payload()[0] < NUM_SUBSYSTEMS) {
+      return msg.payload()[0];
+    }
+    return ANY_SUBSYSTEM;
+  }
+
+  static constexpr bool add_to_route(Route& route, ProcessorType& p) {
+    for (auto& processor : route) {
+      if (processor == nullptr) {
+        processor = &p;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ public:
+  /**
+   * Route messages of the given type to p. Returns false if the route is full.
+   */
+  [[nodiscard]] constexpr bool attach_processor(Type type, ProcessorType& p) {
+    return add_to_route(routes_[static_cast<size_t>(type)][ANY_SUBSYSTEM], p);
+  }
+
+  /**
+   * Route messages of the given type to the given subsystem to p. Returns false if the route is
+   * full.
+   */
+  [[nodiscard]] constexpr bool attach_processor(Type type, Subsystem subsystem, ProcessorType& p) {
+    return add_to_route(routes_[static_cast<size_t>(type)][static_cast<size_t>(subsystem)], p);
+  }
+
+  /**
+   * Offer msg to the processors on its route. Returns true if any of them handled it.
+   */
+  bool dispatch(const MessageType& msg) const {
+    const uint32_t identifier{message_of(msg).identifier()};
+    if (identifier >= NUM_TYPES) {
+      return false;
+    }
+    const auto& routes_for_type{routes_[identifier]};
+    const Route* route{&routes_for_type[subsystem_index(msg)]};
+    if ((*route)[0] == nullptr) {
+      route = &routes_for_type[ANY_SUBSYSTEM];
+    }
+
+    bool handled{false};
+    for (auto processor : *route) {
+      if (processor == nullptr) {
+        // We are out of processors.
+        break;
+      }
+      handled = processor->process(msg) || handled;
+    }
+    return handled;
+  }
+};
+
+template <size_t PROCESSORS_PER_ROUTE = 1>
+using CanBusMessageDispatcher = Dispatcher<CanBusMessage, PROCESSORS_PER_ROUTE>;
+
+}  // namespace tvsc::message
@@ -0,0 +1,138 @@
+#include "message/dispatcher.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "message/leds.h"
+#include "message/message.h"
+#include "message/processor.h"
+#include "message/queue.h"
+
+namespace tvsc::message {
+
+using DefaultMessageType = Message<8>;
+
+class CountingProcessor final : public Processor<DefaultMessageType> {
+ private:
+  bool handles_{};
+  size_t num_calls_{0};
+
+ public:
+  constexpr CountingProcessor(bool handles = true) : handles_(handles) {}
+
+  bool process(const DefaultMessageType& /*msg*/) override {
+    ++num_calls_;
+    return handles_;
+  }
+
+  size_t num_calls() const { return num_calls_; }
+};
+
+DefaultMessageType make_command(Subsystem subsystem) {
+  DefaultMessageType msg{Type::COMMAND};
+  const uint8_t subsystem_value{static_cast<uint8_t>(subsystem)};
+  msg.append_payload(1, &subsystem_value);
+  return msg;
+}
+
+TEST(DispatcherTest, UnroutedMessagesAreNotHandled) {
+  Dispatcher<DefaultMessageType> dispatcher{};
+  EXPECT_FALSE(dispatcher.dispatch(DefaultMessageType{Type::PING}));
+}
+
+TEST(DispatcherTest, RoutesByType) {
+  Dispatcher<DefaultMessageType> dispatcher{};
+  CountingProcessor ping{};
+  CountingProcessor telemetry{};
+  ASSERT_TRUE(dispatcher.attach_processor(Type::PING, ping));
+  ASSERT_TRUE(dispatcher.attach_processor(Type::TELEMETRY, telemetry));
+
+  EXPECT_TRUE(dispatcher.dispatch(DefaultMessageType{Type::PING}));
+  EXPECT_TRUE(dispatcher.dispatch(DefaultMessageType{Type::PING}));
+  EXPECT_TRUE(dispatcher.dispatch(DefaultMessageType{Type::TELEMETRY}));
+  EXPECT_FALSE(dispatcher.dispatch(DefaultMessageType{Type::ANNOUNCE}));
+
+  EXPECT_EQ(2, ping.num_calls());
+  EXPECT_EQ(1, telemetry.num_calls());
+}
+
+TEST(DispatcherTest, RoutesCommandsBySubsystem) {
+  Dispatcher<DefaultMessageType> dispatcher{};
+  CountingProcessor leds{};
+  CountingProcessor other_commands{};
+  ASSERT_TRUE(dispatcher.attach_processor(Type::COMMAND, Subsystem::LED, leds));
+  ASSERT_TRUE(dispatcher.attach_processor(Type::COMMAND, other_commands));
+
+  EXPECT_TRUE(dispatcher.dispatch(led_on_command<8>()));
+  EXPECT_TRUE(dispatcher.dispatch(make_command(Subsystem::MAGNETORQUER)));
+  // A command without a subsystem goes to the processors for all commands.
+  EXPECT_TRUE(dispatcher.dispatch(DefaultMessageType{Type::COMMAND}));
+
+  EXPECT_EQ(1, leds.num_calls());
+  EXPECT_EQ(2, other_commands.num_calls());
+}
+
+TEST(DispatcherTest, DoesNotRouteUnknownIdentifiers) {
+  Dispatcher<DefaultMessageType> dispatcher{};
+  CountingProcessor telemetry{};
+  ASSERT_TRUE(dispatcher.attach_processor(Type::TELEMETRY, telemetry));
+
+  DefaultMessageType unknown{};
+  unknown.identifier() = 0x100 + static_cast<uint32_t>(Type::TELEMETRY);
+  EXPECT_FALSE(dispatcher.dispatch(unknown));
+  EXPECT_EQ(0, telemetry.num_calls());
+}
+
+TEST(DispatcherTest, RejectsSecondProcessorWithoutFanOut) {
+  Dispatcher<DefaultMessageType> dispatcher{};
+  CountingProcessor first{};
+  CountingProcessor second{};
+  EXPECT_TRUE(dispatcher.attach_processor(Type::PING, first));
+  EXPECT_FALSE(dispatcher.attach_processor(Type::PING, second));
+}
+
+TEST(DispatcherTest, FanOutOffersMessageToEveryProcessorOnRoute) {
+  Dispatcher<DefaultMessageType, 3> dispatcher{};
+  CountingProcessor sniffer{/* handles */ false};
+  CountingProcessor handler{};
+  CountingProcessor logger{/* handles */ false};
+  ASSERT_TRUE(dispatcher.attach_processor(Type::ANNOUNCE, sniffer));
+  ASSERT_TRUE(dispatcher.attach_processor(Type::ANNOUNCE, handler));
+  ASSERT_TRUE(dispatcher.attach_processor(Type::ANNOUNCE, logger));
+
+  EXPECT_TRUE(dispatcher.dispatch(DefaultMessageType{Type::ANNOUNCE}));
+  EXPECT_EQ(1, sniffer.num_calls());
+  EXPECT_EQ(1, handler.num_calls());
+  EXPECT_EQ(1, logger.num_calls());
+}
+
+CountingProcessor static_led_processor{};
+
+constinit Dispatcher<DefaultMessageType> static_dispatcher{[]() {
+  Dispatcher<DefaultMessageType> result{};
+  (void)result.attach_processor(Type::COMMAND, Subsystem::LED, static_led_processor);
+  return result;
+}()};
+
+TEST(DispatcherTest, CanBeBuiltAtCompileTime) {
+  EXPECT_TRUE(static_dispatcher.dispatch(led_off_command<8>()));
+  EXPECT_EQ(1, static_led_processor.num_calls());
+}
+
+TEST(DispatcherTest, QueueCanProcessMessagesThroughDispatcher) {
+  Queue<DefaultMessageType, 4, 1> queue{};
+  Dispatcher<DefaultMessageType> dispatcher{};
+  CountingProcessor leds{};
+  ASSERT_TRUE(dispatcher.attach_processor(Type::COMMAND, Subsystem::LED, leds));
+
+  ASSERT_TRUE(queue.enqueue(led_on_command<8>()));
+  ASSERT_TRUE(queue.enqueue(DefaultMessageType{Type::PING}));
+  queue.process_next_message(dispatcher);
+  queue.process_next_message(dispatcher);
+
+  EXPECT_FALSE(queue.has_message());
+  EXPECT_EQ(1, leds.num_calls());
+}
+
+}  // namespace tvsc::message
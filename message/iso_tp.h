@@ -0,0 +1,487 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "buffer/buffer_view.h"
+#include "message/message.h"
+
+namespace tvsc::message {
+
+/**
+ * Segmentation and reassembly of payloads larger than a single CAN bus frame, following ISO 15765-2
+ * (ISO-TP) with classic 8 byte frames.
+ *
+ * A payload of up to 7 bytes is sent as a single frame. A larger payload, of up to 4095 bytes, is
+ * sent as a first frame that carries the total length and the first 6 bytes, followed by
+ * consecutive frames of up to 7 bytes each, numbered modulo 16. After the first frame, and after
+ * every block of block_size consecutive frames, the sender waits for a flow control frame from the
+ * receiver. The flow control frame tells the sender to continue, to wait, or to abort, and sets the
+ * block size and the minimum separation time between consecutive frames for the next block. A
+ * block size of zero means the sender should send all remaining frames without waiting again.
+ *
+ * The first byte of every frame is the protocol control information: the frame type in the high
+ * nibble, and the length, sequence number or flow status in the low nibble. All frames keep the
+ * identifier of the message they carry, so a Dispatcher can still route reassembled payloads by
+ * Type.
+ */
+enum class IsoTpFrameType : uint8_t {
+  SINGLE = 0,
+  FIRST = 1,
+  CONSECUTIVE = 2,
+  FLOW_CONTROL = 3,
+};
+
+enum class IsoTpFlowStatus : uint8_t {
+  CONTINUE_TO_SEND = 0,
+  WAIT = 1,
+  OVERFLOW = 2,
+};
+
+/**
+ * Flow control parameters that a receiver advertises to the sender.
+ */
+struct IsoTpSettings final {
+  // Number of consecutive frames the sender may send before it waits for the next flow control
+  // frame. Zero means that the sender never waits again.
+  uint8_t block_size{0};
+  // Minimum time between consecutive frames.
+  std::chrono::microseconds separation_time{0};
+};
+
+namespace iso_tp {
+
+inline constexpr size_t FRAME_SIZE{CanBusMessage::mtu()};
+inline constexpr size_t SINGLE_FRAME_DATA_SIZE{FRAME_SIZE - 1};
+inline constexpr size_t FIRST_FRAME_DATA_SIZE{FRAME_SIZE - 2};
+inline constexpr size_t CONSECUTIVE_FRAME_DATA_SIZE{FRAME_SIZE - 1};
+inline constexpr size_t MAX_PAYLOAD_SIZE{0xfff};
+
+constexpr uint8_t protocol_control_information(IsoTpFrameType type, uint8_t low_nibble) {
+  return static_cast<uint8_t>((static_cast<uint8_t>(type) << 4) | (low_nibble & 0x0f));
+}
+
+inline IsoTpFrameType frame_type(const CanBusMessage& frame) {
+  return static_cast<IsoTpFrameType>(frame.payload()[0] >> 4);
+}
+
+/**
+ * Encode a separation time as the STmin byte of a flow control frame. Times from 100us to 900us
+ * are encoded in steps of 100us, and longer times in milliseconds, up to 127ms. Times are rounded
+ * up so that the sender never sends faster than requested.
+ */
+constexpr uint8_t encode_separation_time(std::chrono::microseconds separation_time) {
+  const auto us{separation_time.count()};
+  if (us <= 0) {
+    return 0;
+  }
+  if (us <= 900) {
+    return static_cast<uint8_t>(0xf0 + (us + 99) / 100);
+  }
+  return static_cast<uint8_t>(std::min<int64_t>((us + 999) / 1000, 0x7f));
+}
+
+/**
+ * Decode the STmin byte of a flow control frame. Reserved values are treated as the maximum
+ * separation time, 127ms, as the standard requires.
+ */
+constexpr std::chrono::microseconds decode_separation_time(uint8_t encoded) {
+  if (encoded <= 0x7f) {
+    return std::chrono::milliseconds{encoded};
+  }
+  if (encoded >= 0xf1 && encoded <= 0xf9) {
+    return std::chrono::microseconds{100 * (encoded - 0xf0)};
+  }
+  return std::chrono::milliseconds{0x7f};
+}
+
+inline void make_flow_control_frame(uint32_t identifier, IsoTpFlowStatus status,
+                                    const IsoTpSettings& settings, CanBusMessage& frame) {
+  const std::array<uint8_t, 3> data{
+      protocol_control_information(IsoTpFrameType::FLOW_CONTROL, static_cast<uint8_t>(status)),
+      settings.block_size,
+      encode_separation_time(settings.separation_time),
+  };
+  frame.identifier() = identifier;
+  frame.set_payload(data);
+}
+
+}  // namespace iso_tp
+
+/**
+ * Sends one payload at a time as a sequence of frames.
+ *
+ * The sender does not copy the payload; the caller must keep it alive until the transfer is
+ * complete or aborted. The caller drives the transfer: it calls next_frame() whenever it could
+ * transmit a frame, and passes any flow control frames it receives to handle_flow_control().
+ * next_frame() returns false while the sender is waiting for flow control or for the separation
+ * time to elapse; next_frame_time() says when to try again.
+ */
+template <typename ClockT>
+class IsoTpSender final {
+ public:
+  using ClockType = ClockT;
+
+  // How long to wait for a flow control frame before aborting the transfer (N_Bs in ISO 15765-2).
+  static constexpr std::chrono::milliseconds FLOW_CONTROL_TIMEOUT{1000};
+
+  enum class State : uint8_t {
+    IDLE,
+    SENDING,
+    WAITING_FOR_FLOW_CONTROL,
+    ABORTED,
+  };
+
+ private:
+  buffer::BufferView<const uint8_t> payload_{};
+  uint32_t identifier_{};
+  size_t offset_{};
+  uint8_t sequence_number_{};
+  uint8_t block_size_{};
+  uint8_t frames_left_in_block_{};
+  std::chrono::microseconds separation_time_{};
+  typename ClockType::time_point next_frame_time_{};
+  typename ClockType::time_point flow_control_deadline_{};
+  State state_{State::IDLE};
+
+  void wait_for_flow_control() {
+    state_ = State::WAITING_FOR_FLOW_CONTROL;
+    flow_control_deadline_ = ClockType::now() + FLOW_CONTROL_TIMEOUT;
+  }
+
+ public:
+  State state() const { return state_; }
+
+  /**
+   * Whether a transfer is in progress. A new transfer can be started once this is false.
+   */
+  bool is_busy() const {
+    return state_ == State::SENDING || state_ == State::WAITING_FOR_FLOW_CONTROL;
+  }
+
+  /**
+   * Start sending payload in frames with the given identifier. Returns false if a transfer is
+   * already in progress or the payload is empty or too large.
+   */
+  [[nodiscard]] bool start(uint32_t identifier, buffer::BufferView<const uint8_t> payload) {
+    if (is_busy() || payload.empty() || payload.size() > iso_tp::MAX_PAYLOAD_SIZE) {
+      return false;
+    }
+    payload_ = payload;
+    identifier_ = identifier;
+    offset_ = 0;
+    sequence_number_ = 0;
+    next_frame_time_ = ClockType::now();
+    state_ = State::SENDING;
+    return true;
+  }
+
+  /**
+   * Time at which the next frame can be sent, if the sender is not waiting for flow control.
+   */
+  typename ClockType::time_point next_frame_time() const { return next_frame_time_; }
+
+  /**
+   * Write the next frame of the transfer into frame. Returns false if there is no frame to send
+   * now. Aborts the transfer if the flow control timeout has expired.
+   */
+  [[nodiscard]] bool next_frame(CanBusMessage& frame) {
+    const auto now{ClockType::now()};
+    if (state_ == State::WAITING_FOR_FLOW_CONTROL && now > flow_control_deadline_) {
+      state_ = State::ABORTED;
+    }
+    if (state_ != State::SENDING || now < next_frame_time_) {
+      return false;
+    }
+
+    frame.identifier() = identifier_;
+    frame.clear_payload();
+    if (offset_ == 0) {
+      if (payload_.size() <= iso_tp::SINGLE_FRAME_DATA_SIZE) {
+        const uint8_t pci{iso_tp::protocol_control_information(
+            IsoTpFrameType::SINGLE, static_cast<uint8_t>(payload_.size()))};
+        frame.append_payload(1, &pci);
+        frame.append_payload(payload_);
+        state_ = State::IDLE;
+        return true;
+      }
+      const std::array<uint8_t, 2> header{
+          iso_tp::protocol_control_information(IsoTpFrameType::FIRST,
+                                               static_cast<uint8_t>(payload_.size() >> 8)),
+          static_cast<uint8_t>(payload_.size()),
+      };
+      frame.append_payload(header);
+      offset_ = frame.append_payload(payload_.first(iso_tp::FIRST_FRAME_DATA_SIZE));
+      sequence_number_ = 1;
+      wait_for_flow_control();
+      return true;
+    }
+
+    const uint8_t pci{
+        iso_tp::protocol_control_information(IsoTpFrameType::CONSECUTIVE, sequence_number_)};
+    frame.append_payload(1, &pci);
+    const size_t amount{
+        std::min(iso_tp::CONSECUTIVE_FRAME_DATA_SIZE, payload_.size() - offset_)};
+    offset_ += frame.append_payload(payload_.subview(offset_, amount));
+    sequence_number_ = (sequence_number_ + 1) & 0x0f;
+    next_frame_time_ = now + separation_time_;
+
+    if (offset_ == payload_.size()) {
+      state_ = State::IDLE;
+    } else if (block_size_ != 0 && --frames_left_in_block_ == 0) {
+      wait_for_flow_control();
+    }
+    return true;
+  }
+
+  /**
+   * Apply a flow control frame from the receiver. Returns false, and ignores the frame, if it is
+   * not a flow control frame for this transfer.
+   */
+  bool handle_flow_control(const CanBusMessage& frame) {
+    if (state_ != State::WAITING_FOR_FLOW_CONTROL || frame.identifier() != identifier_ ||
+        frame.size() < 3 || iso_tp::frame_type(frame) != IsoTpFrameType::FLOW_CONTROL) {
+      return false;
+    }
+    switch (static_cast<IsoTpFlowStatus>(frame.payload()[0] & 0x0f)) {
+      case IsoTpFlowStatus::CONTINUE_TO_SEND:
+        block_size_ = frame.payload()[1];
+        frames_left_in_block_ = block_size_;
+        separation_time_ = iso_tp::decode_separation_time(frame.payload()[2]);
+        next_frame_time_ = ClockType::now();
+        state_ = State::SENDING;
+        break;
+      case IsoTpFlowStatus::WAIT:
+        wait_for_flow_control();
+        break;
+      default:
+        state_ = State::ABORTED;
+        break;
+    }
+    return true;
+  }
+
+  void abort() { state_ = State::ABORTED; }
+};
+
+/**
+ * Reassembles payloads from frames into a fixed pool of NUM_BUFFERS buffers of MAX_PAYLOAD_SIZE
+ * bytes each.
+ *
+ * Each frame's data is copied once, straight into the buffer that holds the reassembled payload.
+ * Once a payload is complete, completed_payload() is a view of it in that buffer; it stays valid,
+ * and the buffer stays out of the pool, until it is passed to release(). Other payloads can be
+ * reassembled in the meantime, as long as there are free buffers. A first frame announcing a
+ * payload that is too large, or arriving when no buffer is free, is answered with an overflow flow
+ * control frame.
+ *
+ * One payload is reassembled at a time, from frames with a single identifier. A new first or single
+ * frame abandons a payload in progress, which is also how a transfer whose sender has stopped is
+ * eventually discarded.
+ */
+template <size_t MAX_PAYLOAD_SIZE, size_t NUM_BUFFERS = 2>
+class IsoTpReceiver final {
+ public:
+  enum class Result : uint8_t {
+    // The frame was not a data frame for this receiver. Flow control frames are for senders.
+    IGNORED,
+    // The frame was added to the payload in progress.
+    CONSUMED,
+    // The frame was handled, and the flow control frame written to the caller's frame must be sent.
+    SEND_FLOW_CONTROL,
+    // The frame completed a payload. See completed_payload().
+    COMPLETE,
+    // The frame was out of sequence or malformed, and the payload in progress was abandoned.
+    ERROR,
+  };
+
+ private:
+  static_assert(MAX_PAYLOAD_SIZE > 0 && MAX_PAYLOAD_SIZE <= iso_tp::MAX_PAYLOAD_SIZE,
+                "IsoTpReceiver buffers must hold between 1 and 4095 bytes");
+  static_assert(NUM_BUFFERS > 0 && NUM_BUFFERS <= 32,
+                "IsoTpReceiver must have between 1 and 32 buffers");
+
+  static constexpr size_t NO_BUFFER{NUM_BUFFERS};
+
+  std::array<std::array<uint8_t, MAX_PAYLOAD_SIZE>, NUM_BUFFERS> buffers_{};
+  // Bit i is set while buffers_[i] is being reassembled or holds a completed payload.
+  uint32_t in_use_{};
+
+  IsoTpSettings settings_{};
+
+  size_t receiving_buffer_{NO_BUFFER};
+  uint32_t identifier_{};
+  size_t expected_size_{};
+  size_t received_size_{};
+  uint8_t expected_sequence_number_{};
+  uint8_t frames_left_in_block_{};
+
+  size_t completed_buffer_{NO_BUFFER};
+  size_t completed_size_{};
+  uint32_t completed_identifier_{};
+
+  size_t acquire_buffer() {
+    for (size_t i = 0; i < NUM_BUFFERS; ++i) {
+      if ((in_use_ & (uint32_t{1} << i)) == 0) {
+        in_use_ |= uint32_t{1} << i;
+        return i;
+      }
+    }
+    return NO_BUFFER;
+  }
+
+  void release_buffer(size_t index) { in_use_ &= ~(uint32_t{1} << index); }
+
+  void abandon() {
+    if (receiving_buffer_ != NO_BUFFER) {
+      release_buffer(receiving_buffer_);
+      receiving_buffer_ = NO_BUFFER;
+    }
+  }
+
+  Result complete() {
+    completed_buffer_ = receiving_buffer_;
+    completed_size_ = received_size_;
+    completed_identifier_ = identifier_;
+    receiving_buffer_ = NO_BUFFER;
+    return Result::COMPLETE;
+  }
+
+  Result receive_single_frame(const CanBusMessage& frame) {
+    const size_t size{static_cast<size_t>(frame.payload()[0] & 0x0f)};
+    if (size == 0 || size > iso_tp::SINGLE_FRAME_DATA_SIZE || size + 1 > frame.size() ||
+        size > MAX_PAYLOAD_SIZE) {
+      return Result::ERROR;
+    }
+    receiving_buffer_ = acquire_buffer();
+    if (receiving_buffer_ == NO_BUFFER) {
+      return Result::ERROR;
+    }
+    std::memcpy(buffers_[receiving_buffer_].data(), frame.payload().data() + 1, size);
+    identifier_ = frame.identifier();
+    received_size_ = size;
+    return complete();
+  }
+
+  Result receive_first_frame(const CanBusMessage& frame, CanBusMessage& flow_control) {
+    if (frame.size() < iso_tp::FRAME_SIZE) {
+      return Result::ERROR;
+    }
+    const size_t size{(static_cast<size_t>(frame.payload()[0] & 0x0f) << 8) | frame.payload()[1]};
+    if (size <= iso_tp::SINGLE_FRAME_DATA_SIZE) {
+      return Result::ERROR;
+    }
+    if (size <= MAX_PAYLOAD_SIZE) {
+      receiving_buffer_ = acquire_buffer();
+    }
+    if (receiving_buffer_ == NO_BUFFER) {
+      iso_tp::make_flow_control_frame(frame.identifier(), IsoTpFlowStatus::OVERFLOW, settings_,
+                                      flow_control);
+      return Result::SEND_FLOW_CONTROL;
+    }
+
+    identifier_ = frame.identifier();
+    expected_size_ = size;
+    std::memcpy(buffers_[receiving_buffer_].data(), frame.payload().data() + 2,
+                iso_tp::FIRST_FRAME_DATA_SIZE);
+    received_size_ = iso_tp::FIRST_FRAME_DATA_SIZE;
+    expected_sequence_number_ = 1;
+    frames_left_in_block_ = settings_.block_size;
+    iso_tp::make_flow_control_frame(identifier_, IsoTpFlowStatus::CONTINUE_TO_SEND, settings_,
+                                    flow_control);
+    return Result::SEND_FLOW_CONTROL;
+  }
+
+  Result receive_consecutive_frame(const CanBusMessage& frame, CanBusMessage& flow_control) {
+    if (receiving_buffer_ == NO_BUFFER || frame.identifier() != identifier_) {
+      return Result::IGNORED;
+    }
+    const size_t amount{
+        std::min(iso_tp::CONSECUTIVE_FRAME_DATA_SIZE, expected_size_ - received_size_)};
+    if ((frame.payload()[0] & 0x0f) != expected_sequence_number_ || frame.size() < amount + 1) {
+      abandon();
+      return Result::ERROR;
+    }
+    std::memcpy(buffers_[receiving_buffer_].data() + received_size_, frame.payload().data() + 1,
+                amount);
+    received_size_ += amount;
+    expected_sequence_number_ = (expected_sequence_number_ + 1) & 0x0f;
+
+    if (received_size_ == expected_size_) {
+      return complete();
+    }
+    if (settings_.block_size != 0 && --frames_left_in_block_ == 0) {
+      frames_left_in_block_ = settings_.block_size;
+      iso_tp::make_flow_control_frame(identifier_, IsoTpFlowStatus::CONTINUE_TO_SEND, settings_,
+                                      flow_control);
+      return Result::SEND_FLOW_CONTROL;
+    }
+    return Result::CONSUMED;
+  }
+
+ public:
+  IsoTpReceiver() = default;
+  explicit IsoTpReceiver(const IsoTpSettings& settings) : settings_(settings) {}
+
+  const IsoTpSettings& settings() const { return settings_; }
+  void set_settings(const IsoTpSettings& settings) { settings_ = settings; }
+
+  size_t num_free_buffers() const { return NUM_BUFFERS - std::popcount(in_use_); }
+
+  /**
+   * Handle a received frame. If the result is SEND_FLOW_CONTROL, flow_control holds a frame that
+   * must be sent back to the sender.
+   */
+  Result receive(const CanBusMessage& frame, CanBusMessage& flow_control) {
+    if (frame.size() == 0) {
+      return Result::IGNORED;
+    }
+    switch (iso_tp::frame_type(frame)) {
+      case IsoTpFrameType::SINGLE:
+        abandon();
+        return receive_single_frame(frame);
+      case IsoTpFrameType::FIRST:
+        abandon();
+        return receive_first_frame(frame, flow_control);
+      case IsoTpFrameType::CONSECUTIVE:
+        return receive_consecutive_frame(frame, flow_control);
+      default:
+        return Result::IGNORED;
+    }
+  }
+
+  /**
+   * View of the payload most recently completed by receive(). Empty if there is none.
+   */
+  buffer::BufferView<const uint8_t> completed_payload() const {
+    if (completed_buffer_ == NO_BUFFER) {
+      return {};
+    }
+    return {buffers_[completed_buffer_].data(), completed_size_};
+  }
+
+  uint32_t completed_identifier() const { return completed_identifier_; }
+
+  /**
+   * Return the buffer holding payload, a view previously returned by completed_payload(), to the
+   * pool.
+   */
+  void release(buffer::BufferView<const uint8_t> payload) {
+    for (size_t i = 0; i < NUM_BUFFERS; ++i) {
+      if (payload.data() == buffers_[i].data() && i != receiving_buffer_) {
+        release_buffer(i);
+        if (i == completed_buffer_) {
+          completed_buffer_ = NO_BUFFER;
+        }
+        return;
+      }
+    }
+  }
+};
+
+}  // namespace tvsc::message
@@ -0,0 +1,247 @@
+#include "message/iso_tp.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "message/message.h"
+#include "time/mock_clock.h"
+
+namespace tvsc::message {
+
+using namespace std::chrono_literals;
+
+using ClockType = tvsc::time::MockClock;
+using SenderType = IsoTpSender<ClockType>;
+
+static constexpr uint32_t IDENTIFIER{static_cast<uint32_t>(Type::TELEMETRY)};
+
+std::vector<uint8_t> make_payload(size_t size) {
+  std::vector<uint8_t> payload(size);
+  for (size_t i = 0; i < size; ++i) {
+    payload[i] = static_cast<uint8_t>(i * 7 + 3);
+  }
+  return payload;
+}
+
+/**
+ * Run a transfer from sender to receiver to completion, passing flow control frames back. Returns
+ * the number of data frames sent.
+ */
+template <typename ReceiverT>
+size_t transfer(SenderType& sender, ReceiverT& receiver,
+                typename ReceiverT::Result& last_result) {
+  size_t num_frames{0};
+  CanBusMessage frame{};
+  CanBusMessage flow_control{};
+  while (sender.is_busy()) {
+    if (!sender.next_frame(frame)) {
+      if (sender.state() == SenderType::State::SENDING) {
+        ClockType::clock().sleep(sender.next_frame_time());
+        continue;
+      }
+      break;
+    }
+    ++num_frames;
+    last_result = receiver.receive(frame, flow_control);
+    if (last_result == ReceiverT::Result::SEND_FLOW_CONTROL) {
+      EXPECT_TRUE(sender.handle_flow_control(flow_control));
+    }
+  }
+  return num_frames;
+}
+
+TEST(IsoTpTest, SeparationTimeRoundTrips) {
+  EXPECT_EQ(0, iso_tp::encode_separation_time(0us));
+  EXPECT_EQ(0xf1, iso_tp::encode_separation_time(100us));
+  EXPECT_EQ(0xf9, iso_tp::encode_separation_time(900us));
+  EXPECT_EQ(0x05, iso_tp::encode_separation_time(5ms));
+  EXPECT_EQ(0x7f, iso_tp::encode_separation_time(1s));
+
+  EXPECT_EQ(300us, iso_tp::decode_separation_time(0xf3));
+  EXPECT_EQ(20ms, iso_tp::decode_separation_time(20));
+  // Reserved values mean the longest separation time.
+  EXPECT_EQ(127ms, iso_tp::decode_separation_time(0xfa));
+}
+
+TEST(IsoTpTest, SmallPayloadIsSentAsSingleFrame) {
+  SenderType sender{};
+  IsoTpReceiver<64> receiver{};
+  const auto payload{make_payload(7)};
+  ASSERT_TRUE(sender.start(IDENTIFIER, payload));
+
+  CanBusMessage frame{};
+  ASSERT_TRUE(sender.next_frame(frame));
+  EXPECT_FALSE(sender.is_busy());
+  EXPECT_EQ(8, frame.size());
+  EXPECT_EQ(0x07, frame.payload()[0]);
+  EXPECT_EQ(IDENTIFIER, frame.identifier());
+
+  CanBusMessage flow_control{};
+  ASSERT_EQ(IsoTpReceiver<64>::Result::COMPLETE, receiver.receive(frame, flow_control));
+  const auto received{receiver.completed_payload()};
+  ASSERT_EQ(payload.size(), received.size());
+  EXPECT_TRUE(std::equal(payload.begin(), payload.end(), received.begin()));
+  EXPECT_EQ(IDENTIFIER, receiver.completed_identifier());
+}
+
+TEST(IsoTpTest, LargePayloadIsSegmentedAndReassembled) {
+  // Long enough for the sequence number to wrap several times.
+  static constexpr size_t SIZE{1000};
+  using ReceiverType = IsoTpReceiver<SIZE>;
+  SenderType sender{};
+  ReceiverType receiver{};
+  const auto payload{make_payload(SIZE)};
+  ASSERT_TRUE(sender.start(IDENTIFIER, payload));
+
+  ReceiverType::Result result{};
+  const size_t num_frames{transfer(sender, receiver, result)};
+  EXPECT_EQ(ReceiverType::Result::COMPLETE, result);
+  EXPECT_EQ(SenderType::State::IDLE, sender.state());
+  // One first frame with 6 bytes, then 7 bytes per consecutive frame.
+  EXPECT_EQ(1 + (SIZE - 6 + 6) / 7, num_frames);
+
+  const auto received{receiver.completed_payload()};
+  ASSERT_EQ(SIZE, received.size());
+  EXPECT_TRUE(std::equal(payload.begin(), payload.end(), received.begin()));
+}
+
+TEST(IsoTpTest, SenderWaitsForFlowControlAfterEachBlock) {
+  using ReceiverType = IsoTpReceiver<100>;
+  SenderType sender{};
+  ReceiverType receiver{IsoTpSettings{.block_size = 2}};
+  const auto payload{make_payload(6 + 5 * 7)};
+  ASSERT_TRUE(sender.start(IDENTIFIER, payload));
+
+  CanBusMessage frame{};
+  CanBusMessage flow_control{};
+  std::vector<ReceiverType::Result> results{};
+  while (sender.is_busy()) {
+    if (!sender.next_frame(frame)) {
+      EXPECT_EQ(SenderType::State::WAITING_FOR_FLOW_CONTROL, sender.state());
+      break;
+    }
+    results.push_back(receiver.receive(frame, flow_control));
+    if (results.back() == ReceiverType::Result::SEND_FLOW_CONTROL) {
+      // The sender sends nothing until it gets the flow control frame.
+      EXPECT_FALSE(sender.next_frame(frame));
+      EXPECT_TRUE(sender.handle_flow_control(flow_control));
+    }
+  }
+
+  using enum ReceiverType::Result;
+  const std::vector<ReceiverType::Result> expected{
+      SEND_FLOW_CONTROL,            // First frame.
+      CONSUMED, SEND_FLOW_CONTROL,  // First block.
+      CONSUMED, SEND_FLOW_CONTROL,  // Second block.
+      COMPLETE,                     // Last frame, in a partial block.
+  };
+  EXPECT_EQ(expected, results);
+}
+
+TEST(IsoTpTest, SenderRespectsSeparationTime) {
+  using ReceiverType = IsoTpReceiver<100>;
+  SenderType sender{};
+  ReceiverType receiver{IsoTpSettings{.separation_time = 2ms}};
+  const auto payload{make_payload(6 + 3 * 7)};
+  ASSERT_TRUE(sender.start(IDENTIFIER, payload));
+
+  CanBusMessage frame{};
+  CanBusMessage flow_control{};
+  ASSERT_TRUE(sender.next_frame(frame));
+  ASSERT_EQ(ReceiverType::Result::SEND_FLOW_CONTROL, receiver.receive(frame, flow_control));
+  ASSERT_TRUE(sender.handle_flow_control(flow_control));
+
+  ASSERT_TRUE(sender.next_frame(frame));
+  EXPECT_FALSE(sender.next_frame(frame));
+  EXPECT_EQ(ClockType::now() + 2ms, sender.next_frame_time());
+  ClockType::clock().increment_current_time(1ms);
+  EXPECT_FALSE(sender.next_frame(frame));
+  ClockType::clock().increment_current_time(1ms);
+  EXPECT_TRUE(sender.next_frame(frame));
+}
+
+TEST(IsoTpTest, SenderAbortsWithoutFlowControl) {
+  SenderType sender{};
+  const auto payload{make_payload(20)};
+  ASSERT_TRUE(sender.start(IDENTIFIER, payload));
+  CanBusMessage frame{};
+  ASSERT_TRUE(sender.next_frame(frame));
+
+  ClockType::clock().increment_current_time(SenderType::FLOW_CONTROL_TIMEOUT + 1ms);
+  EXPECT_FALSE(sender.next_frame(frame));
+  EXPECT_EQ(SenderType::State::ABORTED, sender.state());
+  EXPECT_FALSE(sender.is_busy());
+}
+
+TEST(IsoTpTest, ReceiverRejectsPayloadTooLargeForItsBuffers) {
+  using ReceiverType = IsoTpReceiver<16>;
+  SenderType sender{};
+  ReceiverType receiver{};
+  const auto payload{make_payload(17)};
+  ASSERT_TRUE(sender.start(IDENTIFIER, payload));
+
+  ReceiverType::Result result{};
+  EXPECT_EQ(1, transfer(sender, receiver, result));
+  EXPECT_EQ(SenderType::State::ABORTED, sender.state());
+  EXPECT_TRUE(receiver.completed_payload().empty());
+}
+
+TEST(IsoTpTest, ReceiverAbandonsPayloadOnSequenceError) {
+  using ReceiverType = IsoTpReceiver<100>;
+  SenderType sender{};
+  ReceiverType receiver{};
+  const auto payload{make_payload(30)};
+  ASSERT_TRUE(sender.start(IDENTIFIER, payload));
+
+  CanBusMessage frame{};
+  CanBusMessage flow_control{};
+  ASSERT_TRUE(sender.next_frame(frame));
+  ASSERT_EQ(ReceiverType::Result::SEND_FLOW_CONTROL, receiver.receive(frame, flow_control));
+  ASSERT_TRUE(sender.handle_flow_control(flow_control));
+  EXPECT_EQ(1, receiver.num_free_buffers());
+
+  // Lose a consecutive frame.
+  ASSERT_TRUE(sender.next_frame(frame));
+  ASSERT_TRUE(sender.next_frame(frame));
+  EXPECT_EQ(ReceiverType::Result::ERROR, receiver.receive(frame, flow_control));
+  EXPECT_EQ(2, receiver.num_free_buffers());
+  // The rest of the transfer is ignored.
+  ASSERT_TRUE(sender.next_frame(frame));
+  EXPECT_EQ(ReceiverType::Result::IGNORED, receiver.receive(frame, flow_control));
+}
+
+TEST(IsoTpTest, CompletedPayloadsHoldBuffersUntilReleased) {
+  using ReceiverType = IsoTpReceiver<8, 2>;
+  ReceiverType receiver{};
+  CanBusMessage flow_control{};
+  CanBusMessage frame{};
+  const std::array<uint8_t, 3> single_frame{0x02, 0xaa, 0xbb};
+  frame.set_payload(single_frame);
+
+  ASSERT_EQ(ReceiverType::Result::COMPLETE, receiver.receive(frame, flow_control));
+  const auto first{receiver.completed_payload()};
+  ASSERT_EQ(ReceiverType::Result::COMPLETE, receiver.receive(frame, flow_control));
+  const auto second{receiver.completed_payload()};
+  EXPECT_NE(first.data(), second.data());
+  EXPECT_EQ(0, receiver.num_free_buffers());
+
+  // No buffer for a third payload until one is released.
+  EXPECT_EQ(ReceiverType::Result::ERROR, receiver.receive(frame, flow_control));
+  receiver.release(first);
+  EXPECT_EQ(1, receiver.num_free_buffers());
+  ASSERT_EQ(ReceiverType::Result::COMPLETE, receiver.receive(frame, flow_control));
+  EXPECT_EQ(first.data(), receiver.completed_payload().data());
+}
+
+TEST(IsoTpTest, ReceiverIgnoresFlowControlFrames) {
+  IsoTpReceiver<16> receiver{};
+  CanBusMessage frame{};
+  CanBusMessage flow_control{};
+  iso_tp::make_flow_control_frame(IDENTIFIER, IsoTpFlowStatus::CONTINUE_TO_SEND, {}, frame);
+  EXPECT_EQ(IsoTpReceiver<16>::Result::IGNORED, receiver.receive(frame, flow_control));
+}
+
+}  // namespace tvsc::message
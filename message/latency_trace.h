@@ -0,0 +1,281 @@
+/**
+ * Optional tracing of the latency of messages flowing through a Queue.
+ *
+ * Each traced message carries two timestamps: when it was received, for example from the CAN bus
+ * peripheral, and when it was enqueued. The queue takes two more when the message is dequeued and
+ * when its processing completes. The intervals between them are recorded in a histogram for each
+ * message Type, so that the time between a frame arriving and its Processor finishing can be
+ * broken down into:
+ *
+ * - RECEIVE_TO_ENQUEUE: time spent in the driver before the message reached the queue.
+ * - QUEUED: time spent waiting in the queue.
+ * - PROCESSING: time spent in the processors or the dispatcher.
+ * - TOTAL: time from receive to the end of processing.
+ *
+ * Tracing is selected at compile time with one of the policies below:
+ *
+ * - NoTracing: nothing is recorded. Queued messages carry no timestamps, the clock is never read,
+ *   and the calls to trace compile away. This is the default.
+ * - TraceLatency<ClockT>: the queue owns its histograms. Read them with the queue's
+ *   latency_report() method.
+ * - TraceLatencyTo<COUNTERS, ClockT>: the queue records into COUNTERS, a LatencyCounters object
+ *   with static storage duration. As with buffer::RecordStatisticsTo, COUNTERS can be placed in the
+ *   .status.value section on embedded targets so that it can be read by the debugger, and several
+ *   queues can share it.
+ *
+ * Timestamps are read from ClockT, and kept as 32-bit counts of microseconds, so that the same
+ * histograms and report are produced on the board, with tvsc::time::EmbeddedClock, and in
+ * simulation, with a tvsc::time::ScaledClock such as MockClock. Intervals are computed modulo 2^32,
+ * so the wrap of the timestamps every 71 minutes does not matter.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "message/message.h"
+
+namespace tvsc::message {
+
+/**
+ * Timestamp of a traced message, in microseconds on the tracing clock. Zero when tracing is
+ * compiled out.
+ */
+using TraceTimestamp = uint32_t;
+
+enum class LatencyStage : uint8_t {
+  RECEIVE_TO_ENQUEUE,
+  QUEUED,
+  PROCESSING,
+  TOTAL,
+};
+
+inline constexpr size_t NUM_LATENCY_STAGES{static_cast<size_t>(LatencyStage::TOTAL) + 1};
+
+// Bucket 0 counts latencies of 0us. Bucket i, for i > 0, counts latencies in [2^(i-1), 2^i) us. The
+// last bucket also counts everything longer, from about 262ms.
+inline constexpr size_t NUM_LATENCY_BUCKETS{20};
+
+/**
+ * Snapshot of the latencies recorded for one Type and stage.
+ */
+struct LatencyHistogram final {
+  std::array<uint32_t, NUM_LATENCY_BUCKETS> buckets{};
+  uint32_t count{};
+  uint32_t max_us{};
+
+  /**
+   * Upper bound, in microseconds, of the bucket that holds the given fraction of the recorded
+   * latencies. For example, percentile_us(0.99) is an upper bound for the p99 latency.
+   */
+  uint32_t percentile_us(double fraction) const {
+    const uint64_t rank{static_cast<uint64_t>(fraction * count + 0.5)};
+    uint64_t seen{0};
+    for (size_t i = 0; i < NUM_LATENCY_BUCKETS; ++i) {
+      seen += buckets[i];
+      if (seen >= rank && seen > 0) {
+        if (i == 0) {
+          return 0;
+        }
+        return std::min(max_us, (uint32_t{1} << i) - 1);
+      }
+    }
+    return max_us;
+  }
+};
+
+/**
+ * Snapshot of a queue's latency histograms, indexed by Type and then by LatencyStage.
+ */
+struct LatencyReport final {
+  std::array<std::array<LatencyHistogram, NUM_LATENCY_STAGES>, NUM_TYPES> histograms{};
+
+  const LatencyHistogram& histogram(Type type, LatencyStage stage) const {
+    return histograms[static_cast<size_t>(type)][static_cast<size_t>(stage)];
+  }
+};
+
+/**
+ * Live histograms behind a LatencyReport. As with buffer::RingCounters, each field is a lock-free
+ * 32-bit atomic, so that several queues can share the histograms, and so that a debugger can read
+ * them directly from memory while they are updated. This does not make a Queue safe to use from an
+ * interrupt handler; the message::RingBuffer that holds its messages is not.
+ */
+struct LatencyCounters final {
+  struct Histogram final {
+    std::array<std::atomic<uint32_t>, NUM_LATENCY_BUCKETS> buckets{};
+    std::atomic<uint32_t> count{};
+    std::atomic<uint32_t> max_us{};
+  };
+
+  std::array<std::array<Histogram, NUM_LATENCY_STAGES>, NUM_TYPES> histograms{};
+
+  /**
+   * Record a latency for messages with the given identifier. Identifiers past the last Type are
+   * counted with the last Type.
+   */
+  void record(uint32_t identifier, LatencyStage stage, uint32_t latency_us) {
+    Histogram& histogram{histograms[std::min<size_t>(identifier, NUM_TYPES - 1)]
+                                   [static_cast<size_t>(stage)]};
+    const size_t bucket{std::min<size_t>(std::bit_width(latency_us), NUM_LATENCY_BUCKETS - 1)};
+    histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    uint32_t max_us{histogram.max_us.load(std::memory_order_relaxed)};
+    while (latency_us > max_us && !histogram.max_us.compare_exchange_weak(
+                                      max_us, latency_us, std::memory_order_relaxed)) {
+    }
+  }
+
+  LatencyReport snapshot() const {
+    LatencyReport result{};
+    for (size_t type = 0; type < NUM_TYPES; ++type) {
+      for (size_t stage = 0; stage < NUM_LATENCY_STAGES; ++stage) {
+        const Histogram& source{histograms[type][stage]};
+        LatencyHistogram& destination{result.histograms[type][stage]};
+        for (size_t i = 0; i < NUM_LATENCY_BUCKETS; ++i) {
+          destination.buckets[i] = source.buckets[i].load(std::memory_order_relaxed);
+        }
+        destination.count = source.count.load(std::memory_order_relaxed);
+        destination.max_us = source.max_us.load(std::memory_order_relaxed);
+      }
+    }
+    return result;
+  }
+
+  void reset() {
+    for (auto& stages : histograms) {
+      for (auto& histogram : stages) {
+        for (auto& bucket : histogram.buckets) {
+          bucket.store(0, std::memory_order_relaxed);
+        }
+        histogram.count.store(0, std::memory_order_relaxed);
+        histogram.max_us.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+};
+
+/**
+ * Human readable report of the non-empty histograms, one line per Type and stage, with the count,
+ * the bucket upper bounds of the p50 and p99 latencies, and the maximum latency.
+ */
+inline std::string to_string(const LatencyReport& report) {
+  static constexpr std::array<const char*, NUM_TYPES> TYPE_NAMES{"EMERGENCY", "PING", "COMMAND",
+                                                                 "ANNOUNCE", "TELEMETRY"};
+  static constexpr std::array<const char*, NUM_LATENCY_STAGES> STAGE_NAMES{
+      "receive_to_enqueue", "queued", "processing", "total"};
+  using std::to_string;
+  std::string result{};
+  for (size_t type = 0; type < NUM_TYPES; ++type) {
+    for (size_t stage = 0; stage < NUM_LATENCY_STAGES; ++stage) {
+      const LatencyHistogram& histogram{report.histograms[type][stage]};
+      if (histogram.count == 0) {
+        continue;
+      }
+      result.append(TYPE_NAMES[type])
+          .append(" ")
+          .append(STAGE_NAMES[stage])
+          .append(": count: ")
+          .append(to_string(histogram.count))
+          .append(", p50 <= ")
+          .append(to_string(histogram.percentile_us(0.5)))
+          .append(" us, p99 <= ")
+          .append(to_string(histogram.percentile_us(0.99)))
+          .append(" us, max: ")
+          .append(to_string(histogram.max_us))
+          .append(" us\n");
+    }
+  }
+  return result;
+}
+
+struct NoTracing final {};
+
+template <typename ClockT = std::chrono::steady_clock>
+struct TraceLatency final {};
+
+template <LatencyCounters& COUNTERS, typename ClockT = std::chrono::steady_clock>
+struct TraceLatencyTo final {};
+
+/**
+ * A queued element together with its trace timestamps. Dereferences to the message, so that
+ * message_of() and the ring buffers see through it.
+ */
+template <typename ElementT>
+struct TracedElement final {
+  ElementT element{};
+  TraceTimestamp received_at{};
+  TraceTimestamp enqueued_at{};
+
+  const auto& operator*() const { return message_of(element); }
+};
+
+namespace internal {
+
+template <typename ClockT>
+TraceTimestamp trace_timestamp() {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  return static_cast<TraceTimestamp>(
+      duration_cast<microseconds>(ClockT::now().time_since_epoch()).count());
+}
+
+/**
+ * Storage and recording for each tracing policy. Queue holds one of these and only ever calls the
+ * members below.
+ */
+template <typename PolicyT>
+class LatencyTracer;
+
+template <>
+class LatencyTracer<NoTracing> final {
+ public:
+  static constexpr bool ENABLED{false};
+
+  static constexpr TraceTimestamp now() { return 0; }
+  void record(uint32_t /*identifier*/, LatencyStage /*stage*/, uint32_t /*latency_us*/) {}
+};
+
+template <typename ClockT>
+class LatencyTracer<TraceLatency<ClockT>> final {
+ private:
+  LatencyCounters counters_{};
+
+ public:
+  static constexpr bool ENABLED{true};
+
+  static TraceTimestamp now() { return trace_timestamp<ClockT>(); }
+
+  LatencyCounters& counters() { return counters_; }
+  const LatencyCounters& counters() const { return counters_; }
+
+  void record(uint32_t identifier, LatencyStage stage, uint32_t latency_us) {
+    counters_.record(identifier, stage, latency_us);
+  }
+};
+
+template <LatencyCounters& COUNTERS, typename ClockT>
+class LatencyTracer<TraceLatencyTo<COUNTERS, ClockT>> final {
+ public:
+  static constexpr bool ENABLED{true};
+
+  static TraceTimestamp now() { return trace_timestamp<ClockT>(); }
+
+  LatencyCounters& counters() { return COUNTERS; }
+  const LatencyCounters& counters() const { return COUNTERS; }
+
+  void record(uint32_t identifier, LatencyStage stage, uint32_t latency_us) {
+    COUNTERS.record(identifier, stage, latency_us);
+  }
+};
+
+}  // namespace internal
+
+}  // namespace tvsc::message
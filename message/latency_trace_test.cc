@@ -0,0 +1,140 @@
+#include "message/latency_trace.h"
+
+#include <chrono>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "message/dispatcher.h"
+#include "message/message.h"
+#include "message/processor.h"
+#include "message/queue.h"
+#include "time/mock_clock.h"
+
+namespace tvsc::message {
+
+using namespace std::chrono_literals;
+
+using ClockType = tvsc::time::MockClock;
+using TracedQueueType = Queue<CanBusMessage, 4, 1, QueueOrdering::FIFO, buffer::NoNotification,
+                              TraceLatency<ClockType>>;
+
+/**
+ * Processor that takes a fixed amount of simulated time to process each message.
+ */
+class SlowProcessor final : public Processor<CanBusMessage> {
+ private:
+  ClockType::duration processing_time_;
+
+ public:
+  explicit SlowProcessor(ClockType::duration processing_time)
+      : processing_time_(processing_time) {}
+
+  bool process(const CanBusMessage& /*msg*/) override {
+    ClockType::clock().increment_current_time(processing_time_);
+    return true;
+  }
+};
+
+TEST(LatencyTraceTest, UntracedQueueStoresNoTimestamps) {
+  using UntracedQueueType = Queue<CanBusMessage, 4, 1>;
+  using ExplicitlyUntracedQueueType =
+      Queue<CanBusMessage, 4, 1, QueueOrdering::FIFO, buffer::NoNotification, NoTracing>;
+  static_assert(sizeof(UntracedQueueType) == sizeof(ExplicitlyUntracedQueueType));
+  static_assert(sizeof(UntracedQueueType) == sizeof(RingBuffer<CanBusMessage, 4>) +
+                                                 sizeof(Processor<CanBusMessage>*));
+  static_assert(UntracedQueueType::trace_timestamp() == 0);
+}
+
+TEST(LatencyTraceTest, RecordsEachStagePerType) {
+  ClockType& clock{ClockType::clock()};
+  TracedQueueType queue{};
+  SlowProcessor processor{200us};
+  ASSERT_TRUE(queue.attach_processor(processor));
+
+  const TraceTimestamp received_at{queue.trace_timestamp()};
+  clock.increment_current_time(100us);
+  ASSERT_TRUE(queue.enqueue(CanBusMessage{Type::COMMAND}, received_at));
+  clock.increment_current_time(1ms);
+  queue.process_next_message();
+
+  const LatencyReport report{queue.latency_report()};
+  EXPECT_EQ(1, report.histogram(Type::COMMAND, LatencyStage::RECEIVE_TO_ENQUEUE).count);
+  EXPECT_EQ(100, report.histogram(Type::COMMAND, LatencyStage::RECEIVE_TO_ENQUEUE).max_us);
+  EXPECT_EQ(1000, report.histogram(Type::COMMAND, LatencyStage::QUEUED).max_us);
+  EXPECT_EQ(200, report.histogram(Type::COMMAND, LatencyStage::PROCESSING).max_us);
+  EXPECT_EQ(1300, report.histogram(Type::COMMAND, LatencyStage::TOTAL).max_us);
+  EXPECT_EQ(0, report.histogram(Type::TELEMETRY, LatencyStage::TOTAL).count);
+}
+
+TEST(LatencyTraceTest, TracesMessagesRoutedThroughDispatcher) {
+  ClockType& clock{ClockType::clock()};
+  TracedQueueType queue{};
+  Dispatcher<CanBusMessage> dispatcher{};
+  SlowProcessor processor{50us};
+  ASSERT_TRUE(dispatcher.attach_processor(Type::TELEMETRY, processor));
+
+  ASSERT_TRUE(queue.enqueue(CanBusMessage{Type::TELEMETRY}));
+  ASSERT_TRUE(queue.enqueue(CanBusMessage{Type::TELEMETRY}));
+  clock.increment_current_time(10us);
+  EXPECT_EQ(2, queue.drain<ClockType>(dispatcher, 2, 1s));
+
+  const LatencyReport report{queue.latency_report()};
+  const LatencyHistogram& queued{report.histogram(Type::TELEMETRY, LatencyStage::QUEUED)};
+  EXPECT_EQ(2, queued.count);
+  // The second message waits for the first to be processed.
+  EXPECT_EQ(60, queued.max_us);
+  // Without a receive timestamp, the message is taken to be received when it is enqueued.
+  EXPECT_EQ(0, report.histogram(Type::TELEMETRY, LatencyStage::RECEIVE_TO_ENQUEUE).max_us);
+
+  queue.reset_latency_trace();
+  EXPECT_EQ(0, queue.latency_report().histogram(Type::TELEMETRY, LatencyStage::QUEUED).count);
+}
+
+TEST(LatencyTraceTest, HistogramBucketsArePowersOfTwo) {
+  LatencyCounters counters{};
+  counters.record(0, LatencyStage::TOTAL, 0);
+  counters.record(0, LatencyStage::TOTAL, 1);
+  counters.record(0, LatencyStage::TOTAL, 3);
+  counters.record(0, LatencyStage::TOTAL, 1000);
+  // Identifiers past the last Type are counted with the last Type.
+  counters.record(0x7ff, LatencyStage::TOTAL, 0xffffffff);
+
+  const LatencyReport report{counters.snapshot()};
+  const LatencyHistogram& emergency{report.histogram(Type::EMERGENCY, LatencyStage::TOTAL)};
+  EXPECT_EQ(1, emergency.buckets[0]);
+  EXPECT_EQ(1, emergency.buckets[1]);
+  EXPECT_EQ(1, emergency.buckets[2]);
+  EXPECT_EQ(1, emergency.buckets[10]);
+  EXPECT_EQ(4, emergency.count);
+  EXPECT_EQ(3, emergency.percentile_us(0.75));
+  EXPECT_EQ(1000, emergency.percentile_us(1.0));
+
+  const LatencyHistogram& telemetry{report.histogram(Type::TELEMETRY, LatencyStage::TOTAL)};
+  EXPECT_EQ(1, telemetry.buckets[NUM_LATENCY_BUCKETS - 1]);
+}
+
+LatencyCounters shared_counters{};
+
+TEST(LatencyTraceTest, QueuesCanShareCounters) {
+  using SharedQueueType = Queue<CanBusMessage, 4, 1, QueueOrdering::FIFO, buffer::NoNotification,
+                                TraceLatencyTo<shared_counters, ClockType>>;
+  SharedQueueType first{};
+  SharedQueueType second{};
+  SlowProcessor processor{20us};
+  ASSERT_TRUE(first.attach_processor(processor));
+  ASSERT_TRUE(second.attach_processor(processor));
+
+  ASSERT_TRUE(first.enqueue(CanBusMessage{Type::PING}));
+  ASSERT_TRUE(second.enqueue(CanBusMessage{Type::PING}));
+  first.process_next_message();
+  second.process_next_message();
+
+  EXPECT_EQ(2, shared_counters.snapshot().histogram(Type::PING, LatencyStage::TOTAL).count);
+  EXPECT_EQ(std::string{"PING receive_to_enqueue: count: 2, p50 <= 0 us, p99 <= 0 us, max: 0 us\n"
+                        "PING queued: count: 2, p50 <= 0 us, p99 <= 20 us, max: 20 us\n"
+                        "PING processing: count: 2, p50 <= 20 us, p99 <= 20 us, max: 20 us\n"
+                        "PING total: count: 2, p50 <= 31 us, p99 <= 40 us, max: 40 us\n"},
+            to_string(first.latency_report()));
+}
+
+}  // namespace tvsc::message
@@ -3,24 +3,26 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "message/codec.h"
 #include "message/message.h"
 
 namespace tvsc::message {
 
+/**
+ * Payload of a COMMAND message to turn the LED on or off.
+ */
+struct LedCommand final {
+  Subsystem subsystem{Subsystem::LED};
+  bool turn_on{};
+};
+
+using LedCommandCodec =
+    Codec<LedCommand, Field<&LedCommand::subsystem>, Field<&LedCommand::turn_on>>;
+
 template <size_t PAYLOAD_SIZE>
 void create_led_command(Message<PAYLOAD_SIZE>& result, bool turn_on) {
-  static constexpr uint8_t ON_VALUE{0x01};
-  static constexpr uint8_t OFF_VALUE{0x00};
-  static constexpr Subsystem LED_SUBSYSTEM{Subsystem::LED};
   result.set_type(Type::COMMAND);
-  result.clear_payload();
-  result.append_payload(sizeof(std::underlying_type_t<Subsystem>),
-                        reinterpret_cast<const uint8_t*>(&LED_SUBSYSTEM));
-  if (turn_on) {
-    result.append_payload(1, &ON_VALUE);
-  } else {
-    result.append_payload(1, &OFF_VALUE);
-  }
+  LedCommandCodec::encode(LedCommand{.turn_on = turn_on}, result);
 }
 
 template <size_t PAYLOAD_SIZE>
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 
 #include "base/enums.h"
+#include "buffer/buffer_view.h"
 
 namespace tvsc::message {
 
@@ -18,11 +21,18 @@ enum class Type : uint8_t {
   TELEMETRY,
 };
 
+// Number of values of Type. Must be updated when a Type is added after TELEMETRY.
+inline constexpr size_t NUM_TYPES{static_cast<size_t>(Type::TELEMETRY) + 1};
+
 enum class Subsystem : uint8_t {
   LED = 1,
   MAGNETORQUER = 2,
 };
 
+// One more than the largest Subsystem. Subsystem values start at one, so this also counts the
+// unused value zero. Must be updated when a Subsystem is added after MAGNETORQUER.
+inline constexpr size_t NUM_SUBSYSTEMS{static_cast<size_t>(Subsystem::MAGNETORQUER) + 1};
+
 template <size_t MTU>
 class Message final {
  public:
@@ -69,6 +79,32 @@ class Message final {
   const Payload& payload() const { return payload_; }
   Payload& payload() { return payload_; }
 
+  /**
+   * Views of the size() bytes of the payload that are in use. These avoid copying the payload when
+   * parsing it or forwarding it to another layer.
+   */
+  buffer::BufferView<const uint8_t> payload_view() const {
+    return buffer::BufferView<const uint8_t>{payload_.data(), size_};
+  }
+  buffer::BufferView<uint8_t> payload_view() {
+    return buffer::BufferView<uint8_t>{payload_.data(), size_};
+  }
+
+  /**
+   * Replace the payload with the bytes viewed by data, truncated to the MTU. Returns the number of
+   * bytes copied.
+   */
+  size_t set_payload(buffer::BufferView<const uint8_t> data) {
+    const size_t amount_to_copy{std::min(MTU, data.size())};
+    std::memcpy(reinterpret_cast<void*>(payload_.data()),
+                reinterpret_cast<const void*>(data.data()), amount_to_copy);
+    // Keep the unused part of the payload zeroed so that operator== only depends on the contents.
+    std::memset(reinterpret_cast<void*>(payload_.data() + amount_to_copy), 0,
+                MTU - amount_to_copy);
+    size_ = amount_to_copy;
+    return amount_to_copy;
+  }
+
   size_t append_payload(size_t size, const uint8_t* data) {
     const size_t amount_to_copy{std::min(MTU - size_, size)};
     std::memcpy(reinterpret_cast<void*>(payload_.data() + size_),
@@ -77,6 +113,10 @@ class Message final {
     return amount_to_copy;
   }
 
+  size_t append_payload(buffer::BufferView<const uint8_t> data) {
+    return append_payload(data.size(), data.data());
+  }
+
   void clear_payload() {
     size_ = 0;
     std::memset(reinterpret_cast<void*>(payload_.data()), 0, MTU);
@@ -85,4 +125,17 @@ class Message final {
 
 using CanBusMessage = Message<8>;
 
+/**
+ * The message that an element of a queue or ring refers to: the element itself, or, for a handle
+ * such as a MessagePool::Handle, the message it points to.
+ */
+template <typename ElementT>
+const auto& message_of(const ElementT& element) {
+  if constexpr (requires { *element; }) {
+    return *element;
+  } else {
+    return element;
+  }
+}
+
 }  // namespace tvsc::message
@@ -0,0 +1,57 @@
+#include "message/message.h"
+
+#include <array>
+#include <cstdint>
+
+#include "buffer/buffer.h"
+#include "buffer/buffer_view.h"
+#include "gtest/gtest.h"
+
+namespace tvsc::message {
+
+TEST(MessageTest, PayloadViewCoversBytesInUse) {
+  CanBusMessage message{Type::COMMAND};
+  const std::array<uint8_t, 3> bytes{1, 2, 3};
+  message.append_payload(bytes.size(), bytes.data());
+
+  buffer::BufferView<const uint8_t> view{message.payload_view()};
+  EXPECT_EQ(3, view.size());
+  EXPECT_EQ(message.payload().data(), view.data());
+  EXPECT_EQ(3, view[2]);
+}
+
+TEST(MessageTest, CanSetPayloadFromView) {
+  buffer::Buffer<uint8_t, 16> frame{};
+  for (size_t i = 0; i < frame.size(); ++i) {
+    frame[i] = i;
+  }
+
+  CanBusMessage message{Type::TELEMETRY};
+  EXPECT_EQ(4, message.set_payload(frame.view(2, 4)));
+  EXPECT_EQ(4, message.size());
+  EXPECT_EQ(2, message.payload()[0]);
+  EXPECT_EQ(5, message.payload()[3]);
+  EXPECT_EQ(0, message.payload()[4]);
+}
+
+TEST(MessageTest, SetPayloadTruncatesToMtu) {
+  buffer::Buffer<uint8_t, 16> frame{};
+  CanBusMessage message{};
+  EXPECT_EQ(CanBusMessage::mtu(), message.set_payload(frame.view()));
+  EXPECT_EQ(CanBusMessage::mtu(), message.size());
+}
+
+TEST(MessageTest, SetPayloadReplacesPreviousPayload) {
+  const std::array<uint8_t, 8> long_payload{9, 9, 9, 9, 9, 9, 9, 9};
+  const std::array<uint8_t, 2> short_payload{1, 2};
+
+  CanBusMessage message{Type::COMMAND};
+  message.set_payload(long_payload);
+  message.set_payload(short_payload);
+
+  CanBusMessage expected{Type::COMMAND};
+  expected.append_payload(short_payload);
+  EXPECT_EQ(expected, message);
+}
+
+}  // namespace tvsc::message
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace tvsc::message {
+
+/**
+ * Fixed capacity pool of messages shared through reference-counted handles.
+ *
+ * Queue::enqueue() copies the whole message into the queue, so forwarding one message to a logger,
+ * a gateway and a local handler copies it three times. With a pool, the message is written once
+ * into a slot from allocate(), and only the Handle, a pointer and an index, is copied. Queues,
+ * rings and processors can hold Handles in place of messages. The slot returns to the pool when the
+ * last Handle referring to it is destroyed or reset.
+ *
+ * allocate() and the release of a Handle are lock-free: a slot is claimed by atomically clearing
+ * its bit in a bitmap of free slots, and returned by setting it again. Reference counts are updated
+ * with atomic increments and decrements. Both are safe to call from interrupt handlers and from
+ * multiple threads. A message must only be modified through the Handle returned by allocate(),
+ * before that Handle is copied and shared; after that, it should be treated as read-only.
+ *
+ * The pool must outlive all of its Handles.
+ */
+template <typename MessageT, size_t CAPACITY>
+class MessagePool final {
+ public:
+  using MessageType = MessageT;
+
+ private:
+  static_assert(CAPACITY > 0, "MessagePool must hold at least one message");
+
+  static constexpr size_t BITS_PER_WORD{32};
+  static constexpr size_t NUM_WORDS{(CAPACITY + BITS_PER_WORD - 1) / BITS_PER_WORD};
+
+  std::array<MessageType, CAPACITY> messages_{};
+  std::array<std::atomic<uint32_t>, CAPACITY> reference_counts_{};
+  // Bit i of word w is set when slot w * 32 + i is free.
+  std::array<std::atomic<uint32_t>, NUM_WORDS> free_slots_{};
+
+  static constexpr uint32_t initial_free_bits(size_t word) {
+    const size_t num_slots{std::min(BITS_PER_WORD, CAPACITY - word * BITS_PER_WORD)};
+    return num_slots == BITS_PER_WORD ? ~uint32_t{0} : (uint32_t{1} << num_slots) - 1;
+  }
+
+  void add_reference(size_t index) {
+    reference_counts_[index].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void remove_reference(size_t index) {
+    auto& reference_count{reference_counts_[index]};
+    // If this is the only reference, no other Handle can be copied from it concurrently, so the
+    // decrement does not need to be atomic. This saves one read-modify-write in the common case of
+    // a message with a single owner.
+    if (reference_count.load(std::memory_order_acquire) == 1 ||
+        reference_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      reference_count.store(0, std::memory_order_relaxed);
+      free_slots_[index / BITS_PER_WORD].fetch_or(uint32_t{1} << (index % BITS_PER_WORD),
+                                                  std::memory_order_release);
+    }
+  }
+
+ public:
+  /**
+   * Shared reference to a message in the pool. Copying a Handle adds a reference; destroying or
+   * resetting it removes one. A default-constructed Handle refers to nothing.
+   */
+  class Handle final {
+   private:
+    MessagePool* pool_{nullptr};
+    size_t index_{};
+
+    friend class MessagePool;
+
+    Handle(MessagePool& pool, size_t index) : pool_(&pool), index_(index) {}
+
+   public:
+    Handle() = default;
+
+    Handle(const Handle& rhs) : pool_(rhs.pool_), index_(rhs.index_) {
+      if (pool_ != nullptr) {
+        pool_->add_reference(index_);
+      }
+    }
+
+    Handle(Handle&& rhs) noexcept : pool_(std::exchange(rhs.pool_, nullptr)), index_(rhs.index_) {}
+
+    Handle& operator=(const Handle& rhs) {
+      if (this != &rhs) {
+        Handle copy{rhs};
+        *this = std::move(copy);
+      }
+      return *this;
+    }
+
+    Handle& operator=(Handle&& rhs) noexcept {
+      if (this != &rhs) {
+        reset();
+        pool_ = std::exchange(rhs.pool_, nullptr);
+        index_ = rhs.index_;
+      }
+      return *this;
+    }
+
+    ~Handle() { reset(); }
+
+    void reset() {
+      if (pool_ != nullptr) {
+        std::exchange(pool_, nullptr)->remove_reference(index_);
+      }
+    }
+
+    explicit operator bool() const { return pool_ != nullptr; }
+
+    MessageType& operator*() { return pool_->messages_[index_]; }
+    const MessageType& operator*() const { return pool_->messages_[index_]; }
+    MessageType* operator->() { return &pool_->messages_[index_]; }
+    const MessageType* operator->() const { return &pool_->messages_[index_]; }
+
+    /**
+     * Number of Handles that currently refer to this message, including this one.
+     */
+    uint32_t use_count() const {
+      return pool_ == nullptr
+                 ? 0
+                 : pool_->reference_counts_[index_].load(std::memory_order_relaxed);
+    }
+
+    bool operator==(const Handle& rhs) const {
+      return pool_ == rhs.pool_ && (pool_ == nullptr || index_ == rhs.index_);
+    }
+  };
+
+  MessagePool() {
+    for (size_t word = 0; word < NUM_WORDS; ++word) {
+      free_slots_[word].store(initial_free_bits(word), std::memory_order_relaxed);
+    }
+  }
+
+  MessagePool(const MessagePool&) = delete;
+  MessagePool& operator=(const MessagePool&) = delete;
+
+  static constexpr size_t capacity() { return CAPACITY; }
+
+  /**
+   * Number of free slots. Only a snapshot if other threads or interrupt handlers use the pool.
+   */
+  size_t num_available() const {
+    size_t count{0};
+    for (const auto& word : free_slots_) {
+      count += std::popcount(word.load(std::memory_order_relaxed));
+    }
+    return count;
+  }
+
+  /**
+   * Claim a free slot. Returns an empty Handle if the pool is exhausted. The message in the slot
+   * holds whatever was written to it last; the caller is expected to overwrite it.
+   */
+  [[nodiscard]] Handle allocate() {
+    for (size_t word = 0; word < NUM_WORDS; ++word) {
+      uint32_t free_bits{free_slots_[word].load(std::memory_order_relaxed)};
+      while (free_bits != 0) {
+        const uint32_t bit{uint32_t{1} << std::countr_zero(free_bits)};
+        if (free_slots_[word].compare_exchange_weak(free_bits, free_bits & ~bit,
+                                                    std::memory_order_acquire,
+                                                    std::memory_order_relaxed)) {
+          const size_t index{word * BITS_PER_WORD + std::countr_zero(bit)};
+          reference_counts_[index].store(1, std::memory_order_relaxed);
+          return Handle{*this, index};
+        }
+      }
+    }
+    return {};
+  }
+
+  /**
+   * Claim a free slot and copy msg into it. Returns an empty Handle if the pool is exhausted.
+   */
+  [[nodiscard]] Handle allocate(const MessageType& msg) {
+    Handle handle{allocate()};
+    if (handle) {
+      *handle = msg;
+    }
+    return handle;
+  }
+};
+
+}  // namespace tvsc::message
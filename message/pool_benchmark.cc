@@ -0,0 +1,114 @@
+/**
+ * Compares fanning a message out to three queues by value with fanning out handles to a single
+ * copy of it in a MessagePool, and with publishing it once to a BroadcastRing with three
+ * subscribers.
+ *
+ *   bazel run -c opt //message:pool_benchmark
+ */
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "message/broadcast_ring.h"
+#include "message/message.h"
+#include "message/pool.h"
+#include "message/processor.h"
+#include "message/queue.h"
+
+namespace tvsc::message {
+
+static constexpr size_t QUEUE_SIZE{16};
+static constexpr size_t NUM_QUEUES{3};
+
+template <typename ElementT>
+class Sink final : public Processor<ElementT> {
+ public:
+  bool process(const ElementT& element) override {
+    benchmark::DoNotOptimize(message_of(element).payload()[0]);
+    return true;
+  }
+};
+
+template <size_t MTU>
+void BM_FanOutByValue(benchmark::State& state) {
+  using MessageType = Message<MTU>;
+  Queue<MessageType, QUEUE_SIZE, 1> queues[NUM_QUEUES]{};
+  Sink<MessageType> sink{};
+  for (auto& queue : queues) {
+    (void)queue.attach_processor(sink);
+  }
+
+  MessageType msg{Type::TELEMETRY};
+  for (auto _ : state) {
+    msg.payload()[0] = static_cast<uint8_t>(state.iterations());
+    for (auto& queue : queues) {
+      (void)queue.enqueue(msg);
+    }
+    for (auto& queue : queues) {
+      queue.process_next_message();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <size_t MTU>
+void BM_FanOutByHandle(benchmark::State& state) {
+  using MessageType = Message<MTU>;
+  using PoolType = MessagePool<MessageType, QUEUE_SIZE>;
+  static PoolType pool{};
+  Queue<typename PoolType::Handle, QUEUE_SIZE, 1> queues[NUM_QUEUES]{};
+  Sink<typename PoolType::Handle> sink{};
+  for (auto& queue : queues) {
+    (void)queue.attach_processor(sink);
+  }
+
+  for (auto _ : state) {
+    auto handle{pool.allocate()};
+    handle->set_type(Type::TELEMETRY);
+    handle->payload()[0] = static_cast<uint8_t>(state.iterations());
+    // The last queue takes over the reference from allocate().
+    for (size_t i = 0; i + 1 < NUM_QUEUES; ++i) {
+      (void)queues[i].enqueue(handle);
+    }
+    (void)queues[NUM_QUEUES - 1].enqueue(std::move(handle));
+    for (auto& queue : queues) {
+      queue.process_next_message();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <size_t MTU>
+void BM_FanOutByBroadcast(benchmark::State& state) {
+  using MessageType = Message<MTU>;
+  using RingType = BroadcastRing<MessageType, QUEUE_SIZE, NUM_QUEUES>;
+  static RingType ring{};
+  typename RingType::Subscription subscriptions[NUM_QUEUES]{};
+  for (auto& subscription : subscriptions) {
+    subscription = ring.subscribe(SubscriberPolicy::BACKPRESSURE);
+  }
+  Sink<MessageType> sink{};
+
+  MessageType msg{Type::TELEMETRY};
+  for (auto _ : state) {
+    msg.payload()[0] = static_cast<uint8_t>(state.iterations());
+    (void)ring.publish(msg);
+    for (auto& subscription : subscriptions) {
+      subscription.poll([&sink](const MessageType& element) { sink.process(element); }, 1);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_FanOutByValue<8>);
+BENCHMARK(BM_FanOutByHandle<8>);
+BENCHMARK(BM_FanOutByBroadcast<8>);
+BENCHMARK(BM_FanOutByValue<256>);
+BENCHMARK(BM_FanOutByHandle<256>);
+BENCHMARK(BM_FanOutByBroadcast<256>);
+BENCHMARK(BM_FanOutByValue<1024>);
+BENCHMARK(BM_FanOutByHandle<1024>);
+BENCHMARK(BM_FanOutByBroadcast<1024>);
+
+}  // namespace tvsc::message
@@ -0,0 +1,149 @@
+#include "message/pool.h"
+
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "message/dispatcher.h"
+#include "message/message.h"
+#include "message/processor.h"
+#include "message/queue.h"
+
+namespace tvsc::message {
+
+using MessageType = Message<256>;
+using PoolType = MessagePool<MessageType, 4>;
+using HandleType = PoolType::Handle;
+
+class RecordingProcessor final : public Processor<HandleType> {
+ private:
+  std::vector<HandleType> handles_{};
+
+ public:
+  bool process(const HandleType& handle) override {
+    handles_.push_back(handle);
+    return true;
+  }
+
+  std::vector<HandleType>& handles() { return handles_; }
+};
+
+TEST(MessagePoolTest, NewPoolIsFull) {
+  PoolType pool{};
+  EXPECT_EQ(4, pool.capacity());
+  EXPECT_EQ(4, pool.num_available());
+}
+
+TEST(MessagePoolTest, CanAllocateUntilExhausted) {
+  PoolType pool{};
+  std::array<HandleType, 4> handles{};
+  for (auto& handle : handles) {
+    handle = pool.allocate();
+    EXPECT_TRUE(handle);
+    EXPECT_EQ(1, handle.use_count());
+  }
+  EXPECT_EQ(0, pool.num_available());
+  EXPECT_FALSE(pool.allocate());
+
+  handles[2].reset();
+  EXPECT_EQ(1, pool.num_available());
+  EXPECT_TRUE(pool.allocate());
+}
+
+TEST(MessagePoolTest, SlotIsReleasedWithLastHandle) {
+  PoolType pool{};
+  HandleType first{pool.allocate(MessageType{Type::PING})};
+  {
+    HandleType second{first};
+    HandleType third{};
+    third = second;
+    EXPECT_EQ(3, first.use_count());
+    EXPECT_EQ(first, third);
+    EXPECT_EQ(&*first, &*third);
+    EXPECT_EQ(3, pool.num_available());
+  }
+  EXPECT_EQ(1, first.use_count());
+  HandleType moved{std::move(first)};
+  EXPECT_FALSE(first);
+  EXPECT_EQ(1, moved.use_count());
+  EXPECT_EQ(Type::PING, moved->retrieve_type());
+
+  moved.reset();
+  EXPECT_EQ(4, pool.num_available());
+}
+
+TEST(MessagePoolTest, SupportsCapacitiesSpanningSeveralWords) {
+  MessagePool<Message<8>, 40> pool{};
+  EXPECT_EQ(40, pool.num_available());
+  std::vector<MessagePool<Message<8>, 40>::Handle> handles{};
+  while (auto handle{pool.allocate()}) {
+    handles.push_back(std::move(handle));
+  }
+  EXPECT_EQ(40, handles.size());
+  EXPECT_EQ(0, pool.num_available());
+}
+
+TEST(MessagePoolTest, QueuesShareOneCopyOfMessage) {
+  PoolType pool{};
+  Queue<HandleType, 4, 1> logger_queue{};
+  Queue<HandleType, 4, 1> gateway_queue{};
+  Queue<HandleType, 4, 1, QueueOrdering::PRIORITY> local_queue{};
+
+  HandleType handle{pool.allocate()};
+  handle->set_type(Type::COMMAND);
+  ASSERT_TRUE(logger_queue.enqueue(handle));
+  ASSERT_TRUE(gateway_queue.enqueue(handle));
+  ASSERT_TRUE(local_queue.enqueue(handle));
+  handle.reset();
+  EXPECT_EQ(3, pool.num_available());
+
+  RecordingProcessor logger{};
+  ASSERT_TRUE(logger_queue.attach_processor(logger));
+  logger_queue.process_next_message();
+  ASSERT_EQ(1, logger.handles().size());
+  EXPECT_EQ(3, logger.handles()[0].use_count());
+  logger.handles().clear();
+
+  // Processing drops the queue's reference, so the slot is free once every queue is done with it.
+  Dispatcher<HandleType> dispatcher{};
+  RecordingProcessor commands{};
+  ASSERT_TRUE(dispatcher.attach_processor(Type::COMMAND, commands));
+  gateway_queue.process_next_message(dispatcher);
+  local_queue.process_next_message(dispatcher);
+  ASSERT_EQ(2, commands.handles().size());
+  EXPECT_EQ(commands.handles()[0], commands.handles()[1]);
+  EXPECT_EQ(2, commands.handles()[0].use_count());
+  commands.handles().clear();
+  EXPECT_EQ(4, pool.num_available());
+}
+
+TEST(MessagePoolTest, ConcurrentAllocateAndRelease) {
+  static constexpr size_t NUM_THREADS{4};
+  static constexpr size_t NUM_ITERATIONS{20'000};
+  MessagePool<Message<8>, 8> pool{};
+
+  std::vector<std::thread> threads{};
+  for (size_t t = 0; t < NUM_THREADS; ++t) {
+    threads.emplace_back([&pool, t]() {
+      for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        auto handle{pool.allocate()};
+        if (!handle) {
+          continue;
+        }
+        // No other thread may hold this slot while we do.
+        handle->identifier() = static_cast<uint32_t>(t);
+        auto copy{handle};
+        handle.reset();
+        EXPECT_EQ(t, copy->identifier());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(8, pool.num_available());
+}
+
+}  // namespace tvsc::message
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "message/message.h"
+#include "message/ring_buffer.h"
+
+namespace tvsc::message {
+
+/**
+ * Fixed capacity store of messages that yields the highest priority message first.
+ *
+ * Messages are ordered by identifier, where lower identifiers have higher priority, matching CAN
+ * bus arbitration. Each of the NUM_PRIORITIES priorities has its own ring of CAPACITY_PER_PRIORITY
+ * messages. Identifiers at or beyond the last priority share the last ring, so by default,
+ * everything after TELEMETRY is queued with TELEMETRY. Within a priority, messages are kept in FIFO
+ * order.
+ *
+ * Because each priority has its own bounded ring, a flood of low priority messages cannot take the
+ * space needed by a high priority message; push() only refuses a message when its own ring is full.
+ *
+ * A bitmask tracks which rings are non-empty, so push(), peek() and pop() take constant time. The
+ * API matches RingBuffer so that the two can be used interchangeably by Queue. ElementT can be a
+ * message or a handle to one, like MessagePool::Handle.
+ */
+template <typename ElementT, size_t CAPACITY_PER_PRIORITY, size_t NUM_PRIORITIES = NUM_TYPES>
+class PriorityRingBuffer final {
+ public:
+  using ElementType = ElementT;
+
+ private:
+  static_assert(NUM_PRIORITIES > 0, "PriorityRingBuffer must have at least one priority");
+  static_assert(NUM_PRIORITIES <= 32, "PriorityRingBuffer supports at most 32 priorities");
+
+  std::array<RingBuffer<ElementType, CAPACITY_PER_PRIORITY>, NUM_PRIORITIES> rings_{};
+  // Bit i is set when rings_[i] is non-empty.
+  uint32_t non_empty_{};
+  size_t size_{};
+
+  static size_t priority_of(const ElementType& element) {
+    return std::min<size_t>(message_of(element).identifier(), NUM_PRIORITIES - 1);
+  }
+
+  // The last priority if the buffer is empty, so that peek() stays in bounds, like RingBuffer's.
+  size_t highest_priority() const {
+    return std::min<size_t>(std::countr_zero(non_empty_), NUM_PRIORITIES - 1);
+  }
+
+  template <typename T>
+  bool push_element(T&& msg) {
+    const size_t priority{priority_of(msg)};
+    if (!rings_[priority].push(std::forward<T>(msg))) {
+      return false;
+    }
+    non_empty_ |= uint32_t{1} << priority;
+    ++size_;
+    return true;
+  }
+
+ public:
+  bool is_empty() const { return non_empty_ == 0; }
+  size_t size() const { return size_; }
+  constexpr size_t capacity() const { return NUM_PRIORITIES * CAPACITY_PER_PRIORITY; }
+  static constexpr size_t capacity_per_priority() { return CAPACITY_PER_PRIORITY; }
+  static constexpr size_t num_priorities() { return NUM_PRIORITIES; }
+
+  /**
+   * Number of messages queued with the same priority as element.
+   */
+  size_t size_at_priority(const ElementType& element) const {
+    return rings_[priority_of(element)].size();
+  }
+
+  [[nodiscard]] bool push(const ElementType& msg) { return push_element(msg); }
+  [[nodiscard]] bool push(ElementType&& msg) { return push_element(std::move(msg)); }
+
+  /**
+   * Message at the given position in priority order. Peeking at the highest priority message is
+   * constant time; peeking further in walks the rings from highest to lowest priority.
+   *
+   * As with RingBuffer, the result is only meaningful if index is less than size(), but peeking
+   * further, or into an empty buffer, never reads outside of the buffer.
+   */
+  const auto& peek(size_t index = 0) const {
+    size_t priority{highest_priority()};
+    while (index >= rings_[priority].size() && priority + 1 < NUM_PRIORITIES) {
+      index -= rings_[priority].size();
+      ++priority;
+    }
+    return rings_[priority].peek(index);
+  }
+
+  void pop() {
+    if (is_empty()) {
+      return;
+    }
+    const size_t priority{highest_priority()};
+    auto& ring{rings_[priority]};
+    ring.pop();
+    --size_;
+    if (ring.is_empty()) {
+      non_empty_ &= ~(uint32_t{1} << priority);
+    }
+  }
+};
+
+}  // namespace tvsc::message
@@ -1,35 +1,141 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
+#include <utility>
 
+#include "buffer/notification.h"
+#include "message/coalescing_ring_buffer.h"
+#include "message/latency_trace.h"
 #include "message/message.h"
+#include "message/priority_ring_buffer.h"
 #include "message/processor.h"
 #include "message/ring_buffer.h"
 
 namespace tvsc::message {
 
+enum class QueueOrdering : uint8_t {
+  // Messages are processed in the order they were enqueued.
+  FIFO,
+  // Messages are processed highest priority (lowest identifier) first, and in the order they were
+  // enqueued within a priority.
+  PRIORITY,
+  // Messages are processed in the order they were enqueued, but only the latest TELEMETRY message
+  // is kept. It replaces any pending TELEMETRY message, keeping its place in FIFO order.
+  COALESCING,
+};
+
 /**
  * Simple fixed size message queue.
  *
- * This message queue is implemented as a ring buffer, using begin and end pointers (indices) and an
- * array for storage.
+ * With FIFO ordering, this message queue is implemented as a ring buffer, using begin and end
+ * pointers (indices) and an array for storage, and holds up to MAX_QUEUE_SIZE messages.
+ *
+ * With PRIORITY ordering, each message Type has its own ring of MAX_QUEUE_SIZE messages. An
+ * EMERGENCY message is processed next, no matter how many TELEMETRY messages are queued, and it is
+ * only refused if MAX_QUEUE_SIZE EMERGENCY messages are already waiting. See PriorityRingBuffer.
+ *
+ * With COALESCING ordering, the queue holds up to MAX_QUEUE_SIZE messages in FIFO order, but at
+ * most one TELEMETRY message. Enqueueing a TELEMETRY message while one is pending never fails; the
+ * stale message is replaced instead. This suits periodic messages, where only the latest value
+ * matters. Other Types are never coalesced, since the identifier is only the Type, and two COMMAND
+ * or EMERGENCY messages are both needed. See CoalescingRingBuffer.
  *
  * A fixed number of processors for the messages can be added, but once added, they cannot be
  * removed. The idea is to configure the processors early on and never change them. Currently, we do
  * not see any need to change the processors configuration once it has been set up.
+ *
+ * NotificationPolicyT optionally invokes a callback each time a message is enqueued, typically to
+ * wake the task that processes the queue so that it does not have to poll. It uses the same
+ * policies as buffer::RingBuffer, with the data available callback; see buffer/notification.h. By
+ * default, there is no callback.
+ *
+ * TracingPolicyT optionally records, for each message Type, how long messages take to reach the
+ * queue, wait in it and be processed. See message/latency_trace.h. By default, nothing is recorded
+ * and queued messages carry no timestamps.
  */
-template <typename MessageT, size_t MAX_QUEUE_SIZE, size_t MAX_PROCESSORS>
+template <typename MessageT, size_t MAX_QUEUE_SIZE, size_t MAX_PROCESSORS,
+          QueueOrdering ORDERING = QueueOrdering::FIFO,
+          typename NotificationPolicyT = buffer::NoNotification,
+          typename TracingPolicyT = NoTracing>
 class Queue final {
  public:
   using MessageType = MessageT;
   using ProcessorType = Processor<MessageType>;
 
  private:
-  RingBuffer<MessageType, MAX_QUEUE_SIZE> messages_{};
+  using NotifierType = buffer::internal::Notifier<NotificationPolicyT, Queue>;
+  using TracerType = internal::LatencyTracer<TracingPolicyT>;
+
+ public:
+  using MessageAvailableCallback = typename NotifierType::Callback;
+
+ private:
+  using ElementType = std::conditional_t<TracerType::ENABLED, TracedElement<MessageType>,
+                                         MessageType>;
+  using StorageType = std::conditional_t<
+      ORDERING == QueueOrdering::PRIORITY, PriorityRingBuffer<ElementType, MAX_QUEUE_SIZE>,
+      std::conditional_t<ORDERING == QueueOrdering::COALESCING,
+                         CoalescingRingBuffer<ElementType, MAX_QUEUE_SIZE>,
+                         RingBuffer<ElementType, MAX_QUEUE_SIZE>>>;
+
+  StorageType messages_{};
   std::array<ProcessorType*, MAX_PROCESSORS> processors_{};
+  [[no_unique_address]] NotifierType notifier_{};
+  [[no_unique_address]] TracerType tracer_{};
+
+  static const MessageType& stored_message(const ElementType& element) {
+    if constexpr (TracerType::ENABLED) {
+      return element.element;
+    } else {
+      return element;
+    }
+  }
+
+  template <typename T>
+  bool enqueue_element(T&& msg, [[maybe_unused]] TraceTimestamp received_at) {
+    bool success{};
+    if constexpr (TracerType::ENABLED) {
+      const TraceTimestamp enqueued_at{TracerType::now()};
+      const uint32_t identifier{message_of(msg).identifier()};
+      success = messages_.push(ElementType{std::forward<T>(msg), received_at, enqueued_at});
+      if (success) {
+        tracer_.record(identifier, LatencyStage::RECEIVE_TO_ENQUEUE, enqueued_at - received_at);
+      }
+    } else {
+      success = messages_.push(std::forward<T>(msg));
+    }
+    if (!success) {
+      return false;
+    }
+    if constexpr (NotifierType::ENABLED) {
+      if (notifier_.has_data_available()) {
+        notifier_.data_available(*this);
+      }
+    }
+    return true;
+  }
 
  public:
+  Queue() = default;
+
+  explicit Queue(MessageAvailableCallback message_available_callback)
+    requires NotifierType::RUNTIME_CONFIGURABLE
+      : notifier_(nullptr, std::move(message_available_callback)) {}
+
+  explicit Queue(NotificationPolicyT policy)
+    requires(NotifierType::ENABLED && !NotifierType::RUNTIME_CONFIGURABLE)
+      : notifier_(std::move(policy)) {}
+
+  void set_message_available_callback(MessageAvailableCallback callback)
+    requires NotifierType::RUNTIME_CONFIGURABLE
+  {
+    notifier_.set_data_available(std::move(callback));
+  }
+
   [[nodiscard]] bool attach_processor(ProcessorType& p) {
     for (size_t i = 0; i < processors_.size(); ++i) {
       if (processors_[i] == nullptr) {
@@ -52,15 +158,39 @@ class Queue final {
   size_t size() const { return messages_.size(); }
   constexpr size_t capacity() const { return messages_.capacity(); }
 
-  [[nodiscard]] bool enqueue(const MessageType& msg) { return messages_.push(msg); }
+  /**
+   * Timestamp to pass to enqueue() for a message that has just been received, so that the time it
+   * spends before reaching the queue is traced. Always zero if tracing is compiled out.
+   */
+  static constexpr TraceTimestamp trace_timestamp() { return TracerType::now(); }
+
+  /**
+   * Enqueue a message. When tracing, its receive time is the time it was enqueued.
+   */
+  [[nodiscard]] bool enqueue(const MessageType& msg) {
+    return enqueue_element(msg, TracerType::now());
+  }
+  [[nodiscard]] bool enqueue(MessageType&& msg) {
+    return enqueue_element(std::move(msg), TracerType::now());
+  }
+
+  /**
+   * Enqueue a message that was received at received_at, as returned by trace_timestamp(). Without
+   * tracing, received_at is ignored.
+   */
+  [[nodiscard]] bool enqueue(const MessageType& msg, TraceTimestamp received_at) {
+    return enqueue_element(msg, received_at);
+  }
+  [[nodiscard]] bool enqueue(MessageType&& msg, TraceTimestamp received_at) {
+    return enqueue_element(std::move(msg), received_at);
+  }
 
   bool has_message() const { return !messages_.is_empty(); }
 
-  const auto& peek(size_t index = 0) const { return messages_.peek(index); }
+  const MessageType& peek(size_t index = 0) const { return stored_message(messages_.peek(index)); }
 
   void process_next_message() {
-    if (!messages_.is_empty()) {
-      const auto& msg{messages_.peek()};
+    process_front([this](const MessageType& msg) {
       for (auto processor : processors_) {
         if (processor == nullptr) {
           // We are out of processors.
@@ -71,13 +201,105 @@ class Queue final {
           break;
         }
       }
-      // Whether it was handled or not, this message gets dropped from the queue.
-      messages_.pop();
+    });
+  }
+
+  /**
+   * Route the next message through dispatcher, rather than offering it to each of the processors
+   * attached to this queue. See Dispatcher.
+   */
+  template <typename DispatcherT>
+  void process_next_message(const DispatcherT& dispatcher) {
+    process_front([&dispatcher](const MessageType& msg) { (void)dispatcher.dispatch(msg); });
+  }
+
+  /**
+   * Snapshot of the latencies traced by this queue. Only available if TracingPolicyT traces
+   * latency.
+   */
+  LatencyReport latency_report() const
+    requires TracerType::ENABLED
+  {
+    return tracer_.counters().snapshot();
+  }
+
+  void reset_latency_trace()
+    requires TracerType::ENABLED
+  {
+    tracer_.counters().reset();
+  }
+
+  /**
+   * Process up to max_messages messages, stopping early if the queue is empty or once budget has
+   * elapsed on ClockType. At least one message is processed if the queue is not empty, so a budget
+   * shorter than the time to process a single message still makes progress. Returns the number of
+   * messages processed.
+   *
+   * Draining a batch at each wakeup, rather than a single message, lets throughput follow the
+   * arrival rate. The limits bound how long the calling task holds the CPU.
+   */
+  template <typename ClockType>
+  size_t drain(size_t max_messages, typename ClockType::duration budget) {
+    return drain_with<ClockType>(max_messages, budget, [this]() { process_next_message(); });
+  }
+
+  /**
+   * As above, but routing each message through dispatcher. See Dispatcher.
+   */
+  template <typename ClockType, typename DispatcherT>
+  size_t drain(const DispatcherT& dispatcher, size_t max_messages,
+               typename ClockType::duration budget) {
+    return drain_with<ClockType>(max_messages, budget,
+                                 [this, &dispatcher]() { process_next_message(dispatcher); });
+  }
+
+ private:
+  template <typename ProcessFn>
+  void process_front(ProcessFn&& process) {
+    if (messages_.is_empty()) {
+      return;
+    }
+    const ElementType& element{messages_.peek()};
+    if constexpr (TracerType::ENABLED) {
+      const TraceTimestamp dequeued_at{TracerType::now()};
+      process(stored_message(element));
+      const TraceTimestamp completed_at{TracerType::now()};
+      const uint32_t identifier{message_of(element).identifier()};
+      tracer_.record(identifier, LatencyStage::QUEUED, dequeued_at - element.enqueued_at);
+      tracer_.record(identifier, LatencyStage::PROCESSING, completed_at - dequeued_at);
+      tracer_.record(identifier, LatencyStage::TOTAL, completed_at - element.received_at);
+    } else {
+      process(element);
+    }
+    // Whether it was handled or not, this message gets dropped from the queue.
+    messages_.pop();
+  }
+
+  template <typename ClockType, typename ProcessFn>
+  size_t drain_with(size_t max_messages, typename ClockType::duration budget,
+                    ProcessFn&& process) {
+    const auto deadline{ClockType::now() + budget};
+    size_t count{0};
+    while (count < max_messages && has_message()) {
+      process();
+      ++count;
+      if (ClockType::now() >= deadline) {
+        break;
+      }
     }
+    return count;
   }
 };
 
 template <size_t QUEUE_SIZE, size_t NUM_PROCESSORS>
 using CanBusMessageQueue = Queue<CanBusMessage, QUEUE_SIZE, NUM_PROCESSORS>;
 
+template <size_t QUEUE_SIZE_PER_PRIORITY, size_t NUM_PROCESSORS>
+using CanBusPriorityMessageQueue =
+    Queue<CanBusMessage, QUEUE_SIZE_PER_PRIORITY, NUM_PROCESSORS, QueueOrdering::PRIORITY>;
+
+template <size_t QUEUE_SIZE, size_t NUM_PROCESSORS>
+using CanBusCoalescingMessageQueue =
+    Queue<CanBusMessage, QUEUE_SIZE, NUM_PROCESSORS, QueueOrdering::COALESCING>;
+
 }  // namespace tvsc::message
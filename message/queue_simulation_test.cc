@@ -0,0 +1,184 @@
+/**
+ * Simulation of message processing on the scheduler, comparing the polling task that processes one
+ * message every 50ms with a task that drains a batch of messages and is woken on enqueue.
+ *
+ * A producer task enqueues a burst of BURST_SIZE messages every ARRIVAL_INTERVAL, as when several
+ * boards answer the same command, and each message takes PROCESSING_TIME to process. Everything
+ * runs on the MockClock, so the results are deterministic. The tests check the properties that the
+ * change to the processing task is meant to deliver.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "buffer/notification.h"
+#include "gtest/gtest.h"
+#include "hal/rcc/rcc_noop.h"
+#include "message/message.h"
+#include "message/processor.h"
+#include "message/queue.h"
+#include "system/scheduler.h"
+#include "system/task.h"
+#include "time/mock_clock.h"
+
+namespace tvsc::message {
+
+using namespace std::chrono_literals;
+
+using ClockType = tvsc::time::MockClock;
+using TaskType = tvsc::system::TaskT<ClockType>;
+using SchedulerType = tvsc::system::SchedulerT<ClockType, 3>;
+using MessageType = Message<8>;
+
+static constexpr size_t QUEUE_SIZE{16};
+using QueueType =
+    Queue<MessageType, QUEUE_SIZE, 1, QueueOrdering::FIFO, buffer::StdFunctionNotification>;
+
+static constexpr size_t BURST_SIZE{4};
+static constexpr ClockType::duration ARRIVAL_INTERVAL{20ms};
+static constexpr ClockType::duration PROCESSING_TIME{200us};
+static constexpr ClockType::duration SIMULATION_TIME{10s};
+
+static constexpr ClockType::duration POLLING_INTERVAL{50ms};
+static constexpr size_t MAX_MESSAGES_PER_BATCH{8};
+static constexpr ClockType::duration BATCH_BUDGET{1ms};
+static constexpr ClockType::duration IDLE_TIMEOUT{1s};
+
+struct SimulationResults final {
+  size_t num_enqueued{};
+  size_t num_dropped{};
+  size_t num_processed{};
+  double throughput_per_second{};
+  ClockType::duration median_latency{};
+  ClockType::duration p99_latency{};
+};
+
+/**
+ * Records the time from enqueue to processing of each message. The index of the message's enqueue
+ * time is carried in its payload.
+ */
+class LatencyRecorder final : public Processor<MessageType> {
+ private:
+  const std::vector<ClockType::time_point>* enqueue_times_;
+  std::vector<ClockType::duration> latencies_{};
+
+ public:
+  explicit LatencyRecorder(const std::vector<ClockType::time_point>& enqueue_times)
+      : enqueue_times_(&enqueue_times) {}
+
+  bool process(const MessageType& msg) override {
+    ClockType::clock().increment_current_time(PROCESSING_TIME);
+    const uint32_t index{msg.payload()[0] | (uint32_t{msg.payload()[1]} << 8) |
+                         (uint32_t{msg.payload()[2]} << 16)};
+    latencies_.push_back(ClockType::now() - (*enqueue_times_)[index]);
+    return true;
+  }
+
+  std::vector<ClockType::duration>& latencies() { return latencies_; }
+};
+
+TaskType produce(QueueType& queue, std::vector<ClockType::time_point>& enqueue_times,
+                 size_t& num_dropped, ClockType::time_point end) {
+  while (ClockType::now() < end) {
+    for (size_t i = 0; i < BURST_SIZE; ++i) {
+      const uint32_t index{static_cast<uint32_t>(enqueue_times.size())};
+      MessageType msg{Type::TELEMETRY};
+      const uint8_t encoded_index[]{static_cast<uint8_t>(index), static_cast<uint8_t>(index >> 8),
+                                    static_cast<uint8_t>(index >> 16)};
+      msg.append_payload(sizeof(encoded_index), encoded_index);
+      enqueue_times.push_back(ClockType::now());
+      if (!queue.enqueue(msg)) {
+        ++num_dropped;
+      }
+    }
+    co_yield ARRIVAL_INTERVAL;
+  }
+}
+
+// The processing task as it was: one message per wakeup, polling every 50ms.
+TaskType process_by_polling(QueueType& queue) {
+  while (true) {
+    queue.process_next_message();
+    co_yield POLLING_INTERVAL;
+  }
+}
+
+// Drain a bounded batch at each wakeup, then sleep until woken by an enqueue.
+TaskType process_when_woken(QueueType& queue) {
+  while (true) {
+    queue.drain<ClockType>(MAX_MESSAGES_PER_BATCH, BATCH_BUDGET);
+    if (queue.has_message()) {
+      co_yield 0ms;
+    } else {
+      co_yield IDLE_TIMEOUT;
+    }
+  }
+}
+
+SimulationResults simulate(std::function<TaskType(QueueType&)> processing_task,
+                           bool wake_on_enqueue) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  SchedulerType scheduler{rcc};
+  ClockType& clock{ClockType::clock()};
+  QueueType queue{};
+
+  std::vector<ClockType::time_point> enqueue_times{};
+  LatencyRecorder recorder{enqueue_times};
+  EXPECT_TRUE(queue.attach_processor(recorder));
+
+  SimulationResults results{};
+  const auto start{clock.current_time()};
+  const auto end{start + SIMULATION_TIME};
+  scheduler.add_task(produce(queue, enqueue_times, results.num_dropped, end));
+  const size_t processing_task_index{scheduler.add_task(processing_task(queue))};
+  if (wake_on_enqueue) {
+    queue.set_message_available_callback(
+        [&scheduler, processing_task_index](QueueType&) {
+          scheduler.wake_task(processing_task_index);
+        });
+  }
+
+  while (clock.current_time() < end) {
+    const auto next_wakeup_time{scheduler.run_tasks_once()};
+    if (next_wakeup_time > clock.current_time()) {
+      clock.sleep(next_wakeup_time);
+    }
+  }
+
+  auto& latencies{recorder.latencies()};
+  std::sort(latencies.begin(), latencies.end());
+  results.num_enqueued = enqueue_times.size() - results.num_dropped;
+  results.num_processed = latencies.size();
+  results.throughput_per_second =
+      results.num_processed / std::chrono::duration<double>(SIMULATION_TIME).count();
+  if (!latencies.empty()) {
+    results.median_latency = latencies[latencies.size() / 2];
+    results.p99_latency = latencies[latencies.size() * 99 / 100];
+  }
+  return results;
+}
+
+TEST(QueueSimulationTest, PollingThroughputIsCappedByPollingInterval) {
+  const SimulationResults results{simulate(process_by_polling, /* wake_on_enqueue */ false)};
+
+  // One message per 50ms, no matter how fast they arrive. The queue fills and the rest are dropped.
+  EXPECT_LE(results.throughput_per_second, 1s / POLLING_INTERVAL + 1);
+  EXPECT_GT(results.num_dropped, results.num_processed);
+  EXPECT_GE(results.median_latency, (QUEUE_SIZE - 1) * POLLING_INTERVAL);
+}
+
+TEST(QueueSimulationTest, WakeOnEnqueueKeepsUpWithArrivals) {
+  const SimulationResults results{simulate(process_when_woken, /* wake_on_enqueue */ true)};
+
+  EXPECT_EQ(0, results.num_dropped);
+  EXPECT_GE(results.num_processed + 1, results.num_enqueued);
+  EXPECT_GE(results.throughput_per_second, 0.99 * BURST_SIZE * (1s / ARRIVAL_INTERVAL));
+  // Each burst is processed as soon as it arrives, so a message only waits for the rest of its
+  // burst.
+  EXPECT_LE(results.median_latency, BURST_SIZE * PROCESSING_TIME);
+  EXPECT_LE(results.p99_latency, BURST_SIZE * PROCESSING_TIME);
+}
+
+}  // namespace tvsc::message
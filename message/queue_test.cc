@@ -1,6 +1,11 @@
 #include "message/queue.h"
 
+#include <chrono>
+#include <cstdint>
+
+#include "buffer/notification.h"
 #include "gtest/gtest.h"
+#include "message/dispatcher.h"
 #include "message/message.h"
 #include "message/processor.h"
 
@@ -154,4 +159,310 @@ TEST(QueueTest, RejectsAddingTooManyProcessors) {
   }
 }
 
+using PriorityQueueType = Queue<DefaultMessageType, DEFAULT_QUEUE_SIZE, DEFAULT_NUM_PROCESSORS,
+                                 QueueOrdering::PRIORITY>;
+
+DefaultMessageType make_message(Type type, size_t size) {
+  DefaultMessageType msg{type};
+  msg.set_size(size);
+  return msg;
+}
+
+TEST(PriorityQueueTest, HasCapacityForEachType) {
+  PriorityQueueType queue{};
+  EXPECT_EQ(queue.capacity(), DEFAULT_QUEUE_SIZE * NUM_TYPES);
+}
+
+TEST(PriorityQueueTest, ProcessesHighestPriorityFirst) {
+  PriorityQueueType queue{};
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 0)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::COMMAND, 0)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::EMERGENCY, 0)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::PING, 0)));
+  ASSERT_EQ(queue.size(), 4);
+
+  EXPECT_EQ(queue.peek(0).retrieve_type(), Type::EMERGENCY);
+  EXPECT_EQ(queue.peek(1).retrieve_type(), Type::PING);
+  EXPECT_EQ(queue.peek(2).retrieve_type(), Type::COMMAND);
+  EXPECT_EQ(queue.peek(3).retrieve_type(), Type::TELEMETRY);
+
+  AlwaysHandles handler{};
+  EXPECT_TRUE(queue.attach_processor(handler));
+  for (Type expected : {Type::EMERGENCY, Type::PING, Type::COMMAND, Type::TELEMETRY}) {
+    queue.process_next_message();
+    EXPECT_EQ(last_message_handled.retrieve_type(), expected);
+  }
+  EXPECT_FALSE(queue.has_message());
+}
+
+TEST(PriorityQueueTest, PreservesOrderWithinPriority) {
+  PriorityQueueType queue{};
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 1)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::COMMAND, 1)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 2)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::COMMAND, 2)));
+
+  AlwaysHandles handler{};
+  EXPECT_TRUE(queue.attach_processor(handler));
+  for (Type expected_type : {Type::COMMAND, Type::TELEMETRY}) {
+    for (size_t expected_size : {1, 2}) {
+      queue.process_next_message();
+      EXPECT_EQ(last_message_handled.retrieve_type(), expected_type);
+      EXPECT_EQ(last_message_handled.size(), expected_size);
+    }
+  }
+}
+
+TEST(PriorityQueueTest, BoundsCapacityOfEachPriority) {
+  PriorityQueueType queue{};
+  for (size_t i = 0; i < DEFAULT_QUEUE_SIZE; ++i) {
+    EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, i)));
+  }
+  EXPECT_FALSE(queue.enqueue(make_message(Type::TELEMETRY, DEFAULT_QUEUE_SIZE)));
+
+  // A full TELEMETRY ring does not take space from the other priorities.
+  for (size_t i = 0; i < DEFAULT_QUEUE_SIZE; ++i) {
+    EXPECT_TRUE(queue.enqueue(make_message(Type::EMERGENCY, i)));
+  }
+  EXPECT_FALSE(queue.enqueue(make_message(Type::EMERGENCY, DEFAULT_QUEUE_SIZE)));
+  EXPECT_EQ(queue.size(), 2 * DEFAULT_QUEUE_SIZE);
+}
+
+TEST(PriorityQueueTest, QueuesUnknownIdentifiersAtLowestPriority) {
+  PriorityQueueType queue{};
+  DefaultMessageType unknown{};
+  unknown.identifier() = 0x7ff;
+  EXPECT_TRUE(queue.enqueue(unknown));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 0)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::ANNOUNCE, 0)));
+
+  EXPECT_EQ(queue.peek(0).retrieve_type(), Type::ANNOUNCE);
+  EXPECT_EQ(queue.peek(1).identifier(), 0x7ff);
+  EXPECT_EQ(queue.peek(2).retrieve_type(), Type::TELEMETRY);
+}
+
+TEST(PriorityQueueTest, PeekStaysInBounds) {
+  PriorityRingBuffer<DefaultMessageType, DEFAULT_QUEUE_SIZE> ring{};
+  const auto in_bounds{[&ring](const DefaultMessageType& msg) {
+    const auto* begin{reinterpret_cast<const char*>(&ring)};
+    const auto* address{reinterpret_cast<const char*>(&msg)};
+    return address >= begin && address + sizeof(msg) <= begin + sizeof(ring);
+  }};
+  EXPECT_TRUE(in_bounds(ring.peek()));
+  EXPECT_TRUE(in_bounds(ring.peek(3)));
+
+  ASSERT_TRUE(ring.push(make_message(Type::EMERGENCY, 1)));
+  EXPECT_EQ(Type::EMERGENCY, ring.peek().retrieve_type());
+  EXPECT_TRUE(in_bounds(ring.peek(DEFAULT_QUEUE_SIZE * NUM_TYPES)));
+}
+
+/**
+ * Counts the messages processed before, and including, the first EMERGENCY message.
+ */
+class EmergencyLatency final : public Processor<DefaultMessageType> {
+ private:
+  size_t num_processed_{0};
+  size_t latency_{0};
+
+ public:
+  bool process(const DefaultMessageType& msg) override {
+    ++num_processed_;
+    if (msg.retrieve_type() == Type::EMERGENCY && latency_ == 0) {
+      latency_ = num_processed_;
+    }
+    return true;
+  }
+
+  size_t latency() const { return latency_; }
+};
+
+/**
+ * Flood the queue with TELEMETRY, then enqueue an EMERGENCY message and measure how many messages
+ * are processed until the EMERGENCY message is handled. The FIFO queue processes every queued
+ * TELEMETRY message first; the priority queue processes the EMERGENCY message next.
+ */
+template <typename QueueT>
+size_t emergency_latency_under_telemetry_flood(size_t num_telemetry) {
+  QueueT queue{};
+  EmergencyLatency processor{};
+  EXPECT_TRUE(queue.attach_processor(processor));
+  for (size_t i = 0; i < num_telemetry; ++i) {
+    EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, i)));
+  }
+  if (!queue.enqueue(make_message(Type::EMERGENCY, 0))) {
+    return 0;
+  }
+  while (queue.has_message()) {
+    queue.process_next_message();
+  }
+  return processor.latency();
+}
+
+TEST(PriorityQueueTest, EmergencyLatencyIsIndependentOfTelemetryFlood) {
+  static constexpr size_t FLOOD_SIZE{64};
+  using FifoFloodQueue = Queue<DefaultMessageType, FLOOD_SIZE + 1, 1, QueueOrdering::FIFO>;
+  using PriorityFloodQueue = Queue<DefaultMessageType, FLOOD_SIZE, 1, QueueOrdering::PRIORITY>;
+
+  EXPECT_EQ(FLOOD_SIZE + 1, emergency_latency_under_telemetry_flood<FifoFloodQueue>(FLOOD_SIZE));
+  EXPECT_EQ(1, emergency_latency_under_telemetry_flood<PriorityFloodQueue>(FLOOD_SIZE));
+
+  // If the flood fills the FIFO queue, the EMERGENCY message is refused outright.
+  using FullFifoQueue = Queue<DefaultMessageType, FLOOD_SIZE, 1, QueueOrdering::FIFO>;
+  EXPECT_EQ(0, emergency_latency_under_telemetry_flood<FullFifoQueue>(FLOOD_SIZE));
+}
+
+using CoalescingQueueType =
+    Queue<DefaultMessageType, NUM_TYPES, DEFAULT_NUM_PROCESSORS, QueueOrdering::COALESCING>;
+
+TEST(CoalescingQueueTest, ReplacesPendingTelemetry) {
+  CoalescingQueueType queue{};
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 1)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::COMMAND, 1)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 2)));
+  ASSERT_EQ(queue.size(), 2);
+
+  // The latest TELEMETRY message keeps the place of the one it replaced.
+  EXPECT_EQ(queue.peek(0).retrieve_type(), Type::TELEMETRY);
+  EXPECT_EQ(queue.peek(0).size(), 2);
+  EXPECT_EQ(queue.peek(1).retrieve_type(), Type::COMMAND);
+
+  AlwaysHandles handler{};
+  EXPECT_TRUE(queue.attach_processor(handler));
+  queue.process_next_message();
+  EXPECT_EQ(last_message_handled.size(), 2);
+
+  // Once processed, the identifier is queued again at the back.
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 3)));
+  EXPECT_EQ(queue.peek(0).retrieve_type(), Type::COMMAND);
+  EXPECT_EQ(queue.peek(1).size(), 3);
+}
+
+TEST(CoalescingQueueTest, KeepsEveryMessageOfOtherTypes) {
+  CanBusCoalescingMessageQueue<NUM_TYPES, 1> queue{};
+  const auto command{[](Subsystem subsystem) {
+    CanBusMessage msg{Type::COMMAND};
+    const uint8_t subsystem_value{static_cast<uint8_t>(subsystem)};
+    msg.append_payload(1, &subsystem_value);
+    return msg;
+  }};
+  EXPECT_TRUE(queue.enqueue(command(Subsystem::LED)));
+  EXPECT_TRUE(queue.enqueue(command(Subsystem::MAGNETORQUER)));
+  EXPECT_TRUE(queue.enqueue(CanBusMessage{Type::EMERGENCY}));
+  EXPECT_TRUE(queue.enqueue(CanBusMessage{Type::EMERGENCY}));
+  ASSERT_EQ(4, queue.size());
+
+  // Commands for different subsystems have the same identifier, and both survive, in order.
+  EXPECT_EQ(static_cast<uint8_t>(Subsystem::LED), queue.peek(0).payload()[0]);
+  EXPECT_EQ(static_cast<uint8_t>(Subsystem::MAGNETORQUER), queue.peek(1).payload()[0]);
+  EXPECT_EQ(Type::EMERGENCY, queue.peek(2).retrieve_type());
+  EXPECT_EQ(Type::EMERGENCY, queue.peek(3).retrieve_type());
+}
+
+TEST(CoalescingQueueTest, RefusesOtherTypesWhenFull) {
+  Queue<DefaultMessageType, 2, DEFAULT_NUM_PROCESSORS, QueueOrdering::COALESCING> queue{};
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 1)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::COMMAND, 1)));
+  EXPECT_FALSE(queue.enqueue(make_message(Type::COMMAND, 2)));
+
+  // A pending TELEMETRY message can still be replaced.
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 2)));
+  ASSERT_EQ(2, queue.size());
+  EXPECT_EQ(2, queue.peek(0).size());
+  EXPECT_EQ(1, queue.peek(1).size());
+}
+
+TEST(CoalescingQueueTest, TracksPendingTypes) {
+  CoalescingRingBuffer<DefaultMessageType, 4> ring{};
+  const uint32_t telemetry{static_cast<uint32_t>(Type::TELEMETRY)};
+  EXPECT_FALSE(ring.is_pending(telemetry));
+  EXPECT_TRUE(ring.push(make_message(Type::TELEMETRY, 1)));
+  EXPECT_TRUE(ring.push(make_message(Type::TELEMETRY, 2)));
+  EXPECT_TRUE(ring.push(make_message(Type::PING, 0)));
+  EXPECT_TRUE(ring.is_pending(telemetry));
+  // Types that are not coalesced are never pending.
+  EXPECT_FALSE(ring.is_pending(static_cast<uint32_t>(Type::PING)));
+  EXPECT_EQ(2, ring.size());
+  EXPECT_EQ(1, ring.num_coalesced());
+
+  ring.pop();
+  EXPECT_FALSE(ring.is_pending(telemetry));
+  EXPECT_EQ(1, ring.size());
+}
+
+TEST(CoalescingQueueTest, CoalescesChosenTypes) {
+  CoalescingRingBuffer<DefaultMessageType, 4, TYPE_MASK<Type::ANNOUNCE, Type::TELEMETRY>> ring{};
+  EXPECT_TRUE(ring.push(make_message(Type::ANNOUNCE, 1)));
+  EXPECT_TRUE(ring.push(make_message(Type::TELEMETRY, 1)));
+  EXPECT_TRUE(ring.push(make_message(Type::ANNOUNCE, 2)));
+  EXPECT_TRUE(ring.push(make_message(Type::TELEMETRY, 2)));
+  ASSERT_EQ(2, ring.size());
+  EXPECT_EQ(Type::ANNOUNCE, ring.peek(0).retrieve_type());
+  EXPECT_EQ(2, ring.peek(0).size());
+  EXPECT_EQ(2, ring.peek(1).size());
+}
+
+TEST(CoalescingQueueTest, TelemetryFloodTakesOneSlot) {
+  static constexpr size_t FLOOD_SIZE{64};
+  // However much TELEMETRY arrives, it takes a single slot, so EMERGENCY is accepted and processed
+  // after at most one TELEMETRY message.
+  EXPECT_EQ(2, emergency_latency_under_telemetry_flood<CoalescingQueueType>(FLOOD_SIZE));
+}
+
+TEST(QueueTest, DrainIsBoundedByMessageCount) {
+  using namespace std::chrono_literals;
+  using QueueType = Queue<DefaultMessageType, 8, 1>;
+  QueueType queue{};
+  AlwaysHandles handler{};
+  EXPECT_TRUE(queue.attach_processor(handler));
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_TRUE(queue.enqueue(make_message(Type::PING, i)));
+  }
+
+  EXPECT_EQ(3, queue.drain<std::chrono::steady_clock>(3, 1s));
+  EXPECT_EQ(2, queue.size());
+  EXPECT_EQ(2, queue.drain<std::chrono::steady_clock>(3, 1s));
+  EXPECT_FALSE(queue.has_message());
+  EXPECT_EQ(0, queue.drain<std::chrono::steady_clock>(3, 1s));
+}
+
+TEST(QueueTest, DrainProcessesOneMessageWhenBudgetIsExhausted) {
+  using QueueType = Queue<DefaultMessageType, 8, 1>;
+  QueueType queue{};
+  AlwaysHandles handler{};
+  EXPECT_TRUE(queue.attach_processor(handler));
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_TRUE(queue.enqueue(make_message(Type::PING, i)));
+  }
+
+  EXPECT_EQ(1, queue.drain<std::chrono::steady_clock>(5, std::chrono::steady_clock::duration{0}));
+  EXPECT_EQ(4, queue.size());
+}
+
+TEST(QueueTest, CanDrainThroughDispatcher) {
+  using namespace std::chrono_literals;
+  using QueueType = Queue<DefaultMessageType, 8, 1>;
+  QueueType queue{};
+  Dispatcher<DefaultMessageType> dispatcher{};
+  AlwaysHandles handler{};
+  EXPECT_TRUE(dispatcher.attach_processor(Type::TELEMETRY, handler));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 1)));
+  EXPECT_TRUE(queue.enqueue(make_message(Type::TELEMETRY, 2)));
+
+  EXPECT_EQ(2, queue.drain<std::chrono::steady_clock>(dispatcher, 5, 1s));
+  EXPECT_EQ(2, last_message_handled.size());
+}
+
+TEST(QueueTest, NotifiesOnEnqueue) {
+  using QueueType = Queue<DefaultMessageType, 1, 1, QueueOrdering::FIFO,
+                          buffer::StdFunctionNotification>;
+  size_t num_notifications{0};
+  QueueType queue{[&num_notifications](QueueType&) { ++num_notifications; }};
+
+  EXPECT_TRUE(queue.enqueue(make_message(Type::PING, 0)));
+  EXPECT_EQ(1, num_notifications);
+  // Refused messages do not notify.
+  EXPECT_FALSE(queue.enqueue(make_message(Type::PING, 1)));
+  EXPECT_EQ(1, num_notifications);
+}
+
 }  // namespace tvsc::message
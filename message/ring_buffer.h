@@ -1,51 +1,110 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "buffer/statistics.h"
 
 namespace tvsc::message {
 
-template <typename ElementT, size_t CAPACITY, bool PRIORITIZE_EXISTING_ELEMENTS = true>
+/**
+ * Fixed capacity ring of messages.
+ *
+ * If PRIORITIZE_EXISTING_ELEMENTS is true, push() refuses new elements when the ring is full. If it
+ * is false, push() always succeeds and drops the oldest element to make room.
+ *
+ * StatisticsPolicyT optionally records dropped elements, the high-water mark, an occupancy
+ * histogram and the time spent full. See buffer/statistics.h. By default, nothing is recorded.
+ */
+template <typename ElementT, size_t CAPACITY, bool PRIORITIZE_EXISTING_ELEMENTS = true,
+          typename StatisticsPolicyT = buffer::NoStatistics>
 class RingBuffer final {
  public:
   using ElementType = ElementT;
 
  private:
+  using StatisticsType = buffer::internal::StatisticsRecorder<StatisticsPolicyT>;
+
   size_t begin_{};
   size_t end_{};
   std::array<ElementType, CAPACITY> elements_{};
+  [[no_unique_address]] StatisticsType statistics_{};
 
- public:
-  bool is_empty() const { return end_ == begin_; }
-  size_t size() const { return end_ - begin_; }
-  constexpr size_t capacity() const { return elements_.size(); }
+  void record_occupancy() {
+    if constexpr (StatisticsType::ENABLED) {
+      statistics_.record_occupancy(size(), capacity());
+    }
+  }
 
-  [[nodiscard]] bool push(const ElementType& msg) {
+  template <typename T>
+  bool push_element(T&& msg) {
     if constexpr (PRIORITIZE_EXISTING_ELEMENTS) {
       if (end_ - begin_ < elements_.size()) {
-        elements_[end_ % elements_.size()] = msg;
+        elements_[end_ % elements_.size()] = std::forward<T>(msg);
         ++end_;
+        record_occupancy();
         return true;
       } else {
+        statistics_.record_dropped(1);
+        record_occupancy();
         return false;
       }
     } else {
-      elements_[end_ % elements_.size()] = msg;
+      if (end_ - begin_ == elements_.size()) {
+        // The new element overwrites the oldest one.
+        ++begin_;
+        statistics_.record_dropped(1);
+      }
+      elements_[end_ % elements_.size()] = std::forward<T>(msg);
       ++end_;
+      record_occupancy();
       // This variation always succeeds.
       return true;
     }
   }
 
+ public:
+  bool is_empty() const { return end_ == begin_; }
+  size_t size() const { return end_ - begin_; }
+  constexpr size_t capacity() const { return elements_.size(); }
+
+  [[nodiscard]] bool push(const ElementType& msg) { return push_element(msg); }
+  [[nodiscard]] bool push(ElementType&& msg) { return push_element(std::move(msg)); }
+
   const auto& peek(size_t index = 0) const {
     return elements_[(begin_ + index) % elements_.size()];
   }
 
   void pop() {
     if (end_ - begin_ > 0) {
+      if constexpr (!std::is_trivially_destructible_v<ElementType>) {
+        // Release any resources held by the element, such as a reference to a pooled message, now
+        // rather than when its slot is reused.
+        elements_[begin_ % elements_.size()] = ElementType{};
+      }
       ++begin_;
+      record_occupancy();
     }
   }
+
+  /**
+   * Snapshot of the statistics recorded for this ring. Only available if StatisticsPolicyT records
+   * statistics.
+   */
+  buffer::RingStatistics statistics() const
+    requires StatisticsType::ENABLED
+  {
+    return statistics_.counters().snapshot();
+  }
+
+  void reset_statistics()
+    requires StatisticsType::ENABLED
+  {
+    statistics_.counters().reset();
+  }
 };
 
 }  // namespace tvsc::message
@@ -0,0 +1,83 @@
+#include "message/ring_buffer.h"
+
+#include <memory>
+
+#include "buffer/statistics.h"
+#include "gtest/gtest.h"
+
+namespace tvsc::message {
+
+TEST(RingBufferTest, RefusesNewElementsWhenFull) {
+  RingBuffer<int, 2> ring{};
+  EXPECT_TRUE(ring.push(1));
+  EXPECT_TRUE(ring.push(2));
+  EXPECT_FALSE(ring.push(3));
+  ASSERT_EQ(2, ring.size());
+  EXPECT_EQ(1, ring.peek());
+  EXPECT_EQ(2, ring.peek(1));
+}
+
+TEST(RingBufferTest, DropsOldestElementWhenFull) {
+  RingBuffer<int, 2, false> ring{};
+  EXPECT_TRUE(ring.push(1));
+  EXPECT_TRUE(ring.push(2));
+  EXPECT_TRUE(ring.push(3));
+  ASSERT_EQ(2, ring.size());
+  EXPECT_EQ(2, ring.peek());
+  EXPECT_EQ(3, ring.peek(1));
+}
+
+TEST(RingBufferTest, CountsRefusedElements) {
+  RingBuffer<int, 2, true, buffer::RecordStatistics<>> ring{};
+  EXPECT_TRUE(ring.push(1));
+  EXPECT_TRUE(ring.push(2));
+  EXPECT_FALSE(ring.push(3));
+  EXPECT_FALSE(ring.push(4));
+  ring.pop();
+  ring.pop();
+
+  const buffer::RingStatistics statistics{ring.statistics()};
+  EXPECT_EQ(2, statistics.elements_dropped);
+  EXPECT_EQ(2, statistics.high_water_mark);
+}
+
+TEST(RingBufferTest, CountsOverwrittenElements) {
+  RingBuffer<int, 2, false, buffer::RecordStatistics<>> ring{};
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(ring.push(i));
+  }
+  EXPECT_EQ(3, ring.statistics().elements_dropped);
+
+  ring.reset_statistics();
+  EXPECT_EQ(0, ring.statistics().elements_dropped);
+}
+
+buffer::RingCounters message_counters{};
+
+TEST(RingBufferTest, CanRecordIntoExternalCounters) {
+  RingBuffer<int, 2, true, buffer::RecordStatisticsTo<message_counters>> ring{};
+  EXPECT_EQ(sizeof(RingBuffer<int, 2>), sizeof(ring));
+  EXPECT_TRUE(ring.push(1));
+  EXPECT_TRUE(ring.push(2));
+  EXPECT_FALSE(ring.push(3));
+  EXPECT_EQ(1, message_counters.elements_dropped.load());
+}
+
+TEST(RingBufferTest, PopReleasesElement) {
+  RingBuffer<std::shared_ptr<int>, 2> ring{};
+  auto element{std::make_shared<int>(1)};
+  EXPECT_TRUE(ring.push(element));
+  EXPECT_EQ(2, element.use_count());
+  ring.pop();
+  EXPECT_EQ(1, element.use_count());
+}
+
+TEST(RingBufferTest, CanMoveElementsIn) {
+  RingBuffer<std::shared_ptr<int>, 2> ring{};
+  auto element{std::make_shared<int>(1)};
+  EXPECT_TRUE(ring.push(std::move(element)));
+  EXPECT_EQ(nullptr, element);
+  EXPECT_EQ(1, ring.peek().use_count());
+}
+
+}  // namespace tvsc::message
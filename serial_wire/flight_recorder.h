@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "buffer/flight_recorder.h"
+#include "serial_wire/serial_wire.h"
+#include "serial_wire/target.h"
+
+namespace tvsc::serial_wire {
+
+// Address of the .noinit section, and so of the flight recorder, on the STM32L4 boards. See
+// hal/flight_recorder.h.
+inline constexpr uint32_t FLIGHT_RECORDER_ADDRESS{0x2000'0000};
+
+/**
+ * Read a target's flight recorder over SWD into image. The events can then be decoded with
+ * image.for_each_event(). NUM_EVENTS must match the target's recorder; otherwise, the image will
+ * not be valid.
+ *
+ * The target should be halted, or held in reset, so that the recorder does not change while it is
+ * being read.
+ */
+template <size_t NUM_EVENTS>
+[[nodiscard]] Result read_flight_recorder(Target& target,
+                                          buffer::FlightRecorder<NUM_EVENTS>& image,
+                                          uint32_t address = FLIGHT_RECORDER_ADDRESS) {
+  static_assert(std::is_trivially_copyable_v<buffer::FlightRecorder<NUM_EVENTS>>);
+  static_assert(sizeof(buffer::FlightRecorder<NUM_EVENTS>) % sizeof(uint32_t) == 0);
+
+  // The MEM-AP only guarantees that the transfer address auto-increments within a 1KB block, so
+  // the recorder is read in chunks that do not cross a 1KB boundary.
+  static constexpr size_t AUTO_INCREMENT_BLOCK_BYTES{1024};
+  static constexpr size_t NUM_WORDS{sizeof(buffer::FlightRecorder<NUM_EVENTS>) / sizeof(uint32_t)};
+  uint32_t chunk[AUTO_INCREMENT_BLOCK_BYTES / sizeof(uint32_t)];
+
+  Result success{};
+  size_t words_read{0};
+  while (success && words_read < NUM_WORDS) {
+    const uint32_t chunk_address{static_cast<uint32_t>(address + words_read * sizeof(uint32_t))};
+    const size_t bytes_to_boundary{AUTO_INCREMENT_BLOCK_BYTES -
+                                   chunk_address % AUTO_INCREMENT_BLOCK_BYTES};
+    const size_t chunk_words{
+        std::min(NUM_WORDS - words_read, bytes_to_boundary / sizeof(uint32_t))};
+    success = target.ap_read_mem(chunk_address, chunk, chunk_words);
+    if (success) {
+      std::memcpy(reinterpret_cast<uint8_t*>(&image) + words_read * sizeof(uint32_t), chunk,
+                  chunk_words * sizeof(uint32_t));
+      words_read += chunk_words;
+    }
+  }
+  return success;
+}
+
+}  // namespace tvsc::serial_wire
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+
+namespace tvsc::system {
+
+/**
+ * Event that an interrupt handler or callback signals, and that a task can co_await instead of
+ * polling with co_yield. For example, a CAN RX pending, DMA half or full transfer complete, or GPIO
+ * edge interrupt can signal an event, and the task waiting on it runs in the scheduler's next pass.
+ *
+ *   while (true) {
+ *     co_await rx_pending;
+ *     // Drain the FIFO.
+ *   }
+ *
+ * signal() only stores an atomic flag and interrupts the clock's sleep, so it is safe to call from
+ * an interrupt handler. The scheduler sees that the waiting task is runnable when it checks the
+ * task, and the clock's sleep returns as soon as the event is signalled, so the reaction latency is
+ * the time to finish the current sleep instruction and run a pass, rather than a polling interval.
+ *
+ * The event stays signalled until a waiting task resumes, which clears it. Signals that arrive
+ * before the task waits are not lost, but several signals before the task resumes count as one, as
+ * with a binary semaphore. At most one task should wait on an event at a time.
+ *
+ * Waiting can also time out:
+ *
+ *   if (co_await rx_pending.wait_for(100ms)) {
+ *     // Signalled.
+ *   } else {
+ *     // Timed out.
+ *   }
+ */
+template <typename ClockT>
+class EventT final {
+ public:
+  using ClockType = ClockT;
+
+  class Awaiter final {
+   private:
+    EventT* event_;
+    typename ClockType::time_point deadline_;
+    bool signalled_{false};
+
+   public:
+    Awaiter(EventT& event, typename ClockType::time_point deadline) noexcept
+        : event_(&event), deadline_(deadline) {}
+
+    bool await_ready() noexcept {
+      signalled_ = event_->consume();
+      return signalled_;
+    }
+
+    template <typename PromiseT>
+    void await_suspend(std::coroutine_handle<PromiseT> handle) noexcept {
+      handle.promise().wait_for_event(*event_, deadline_);
+    }
+
+    /**
+     * True if the event was signalled, and false if the wait timed out or the task was woken some
+     * other way, such as with the scheduler's wake_task().
+     */
+    bool await_resume() noexcept { return signalled_ || event_->consume(); }
+  };
+
+ private:
+  std::atomic<bool> signalled_{false};
+
+ public:
+  EventT() noexcept = default;
+  EventT(const EventT&) = delete;
+  EventT& operator=(const EventT&) = delete;
+
+  /**
+   * Make the task waiting on this event runnable, and end the scheduler's sleep. Safe to call from
+   * an interrupt handler.
+   */
+  void signal() noexcept {
+    signalled_.store(true, std::memory_order_release);
+    ClockType::clock().interrupt_sleep();
+  }
+
+  bool is_signalled() const noexcept { return signalled_.load(std::memory_order_acquire); }
+
+  /**
+   * Clear the event, returning whether it was signalled.
+   */
+  bool consume() noexcept { return signalled_.exchange(false, std::memory_order_acq_rel); }
+
+  /**
+   * Wait for the event without a timeout.
+   */
+  Awaiter operator co_await() noexcept { return Awaiter{*this, ClockType::time_point::max()}; }
+
+  /**
+   * Wait for the event until the deadline. The result of the co_await is true if the event was
+   * signalled, and false if the wait timed out.
+   */
+  Awaiter wait_until(typename ClockType::time_point deadline) noexcept {
+    return Awaiter{*this, deadline};
+  }
+
+  template <typename Rep, typename Period>
+  Awaiter wait_for(std::chrono::duration<Rep, Period> timeout) noexcept {
+    return Awaiter{*this, ClockType::now() + timeout};
+  }
+};
+
+}  // namespace tvsc::system
@@ -0,0 +1,327 @@
+#include "system/event.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hal/rcc/rcc_noop.h"
+#include "system/heap_scheduler.h"
+#include "system/scheduler.h"
+#include "system/task.h"
+#include "time/clockable.h"
+#include "time/mock_clock.h"
+
+namespace tvsc::system {
+
+using namespace std::chrono_literals;
+
+using ClockType = tvsc::time::MockClock;
+using TaskType = TaskT<ClockType>;
+using EventType = EventT<ClockType>;
+
+/**
+ * Simulated peripheral that raises an interrupt at each of the given times. Its interrupt handler
+ * records the interrupt as pending work and signals the event.
+ */
+class InterruptSource final : public tvsc::time::Clockable<ClockType> {
+ private:
+  std::vector<ClockType::time_point> interrupt_times_;
+  size_t next_interrupt_{};
+
+ public:
+  EventType event{};
+  std::vector<ClockType::time_point> pending{};
+
+  explicit InterruptSource(std::vector<ClockType::time_point> interrupt_times)
+      : Clockable<ClockType>(ClockType::clock()), interrupt_times_(std::move(interrupt_times)) {}
+
+  ClockType::time_point update_time(ClockType::time_point requested_time) noexcept override {
+    if (next_interrupt_ < interrupt_times_.size() &&
+        interrupt_times_[next_interrupt_] > clock_->current_time()) {
+      return std::min(requested_time, interrupt_times_[next_interrupt_]);
+    }
+    return requested_time;
+  }
+
+  void run(ClockType::time_point current_time) noexcept override {
+    while (next_interrupt_ < interrupt_times_.size() &&
+           interrupt_times_[next_interrupt_] <= current_time) {
+      pending.push_back(interrupt_times_[next_interrupt_]);
+      ++next_interrupt_;
+      event.signal();
+    }
+  }
+};
+
+struct HandlerStats final {
+  size_t wakeups{};
+  std::vector<ClockType::duration> latencies{};
+
+  void handle(InterruptSource& source) {
+    for (const auto& raised_at : source.pending) {
+      latencies.push_back(ClockType::now() - raised_at);
+    }
+    source.pending.clear();
+  }
+
+  ClockType::duration max_latency() const {
+    return *std::max_element(latencies.begin(), latencies.end());
+  }
+};
+
+TaskType polling_handler(InterruptSource& source, HandlerStats& stats) {
+  while (true) {
+    ++stats.wakeups;
+    stats.handle(source);
+    co_yield 10ms;
+  }
+}
+
+TaskType event_handler(InterruptSource& source, HandlerStats& stats) {
+  while (true) {
+    co_await source.event;
+    ++stats.wakeups;
+    stats.handle(source);
+  }
+}
+
+template <typename SchedulerType>
+void run_for(SchedulerType& scheduler, ClockType::duration duration) {
+  ClockType& clock{ClockType::clock()};
+  const auto end{clock.current_time() + duration};
+  while (clock.current_time() < end) {
+    clock.sleep(std::min(end, scheduler.run_tasks_once()));
+  }
+}
+
+class EventTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Signals from earlier tests leave the clock's sleep interrupted. Clear that.
+    ClockType::clock().sleep(ClockType::now());
+  }
+};
+
+TEST_F(EventTest, AwaitingSignalledEventDoesNotSuspend) {
+  EventType event{};
+  int run_count{};
+  TaskType task{[](EventType& event, int& run_count) -> TaskType {
+    co_await event;
+    ++run_count;
+  }(event, run_count)};
+
+  event.signal();
+  task.run();
+  EXPECT_EQ(1, run_count);
+  EXPECT_TRUE(task.is_complete());
+  EXPECT_FALSE(event.is_signalled());
+}
+
+TEST_F(EventTest, TaskWaitingOnEventBecomesRunnableWhenSignalled) {
+  ClockType& clock{ClockType::clock()};
+  EventType event{};
+  int run_count{};
+  TaskType task{[](EventType& event, int& run_count) -> TaskType {
+    while (true) {
+      co_await event;
+      ++run_count;
+    }
+  }(event, run_count)};
+
+  task.run();
+  EXPECT_TRUE(task.is_waiting_on_event());
+  EXPECT_FALSE(task.is_runnable(clock.current_time() + 1h));
+  EXPECT_EQ(ClockType::time_point::max(), task.estimate_runnable_at());
+
+  event.signal();
+  EXPECT_TRUE(task.is_runnable(clock.current_time()));
+  EXPECT_LE(task.estimate_runnable_at(), clock.current_time());
+
+  task.run();
+  EXPECT_EQ(1, run_count);
+  // Resuming the task consumed the signal.
+  EXPECT_FALSE(event.is_signalled());
+  EXPECT_FALSE(task.is_runnable(clock.current_time()));
+}
+
+TEST_F(EventTest, WaitCanTimeOut) {
+  ClockType& clock{ClockType::clock()};
+  EventType event{};
+  std::vector<bool> results{};
+  TaskType task{[](EventType& event, std::vector<bool>& results) -> TaskType {
+    while (true) {
+      results.push_back(co_await event.wait_for(5ms));
+    }
+  }(event, results)};
+
+  task.run();
+  EXPECT_FALSE(task.is_runnable(clock.current_time()));
+  EXPECT_EQ(clock.current_time() + 5ms, task.estimate_runnable_at());
+
+  clock.increment_current_time(5ms);
+  ASSERT_TRUE(task.is_runnable(clock.current_time()));
+  task.run();
+  EXPECT_EQ((std::vector<bool>{false}), results);
+
+  event.signal();
+  task.run();
+  EXPECT_EQ((std::vector<bool>{false, true}), results);
+}
+
+TEST_F(EventTest, SignalEndsSleep) {
+  ClockType& clock{ClockType::clock()};
+  const auto start{clock.current_time()};
+  InterruptSource source{{start + 3ms}};
+
+  clock.sleep(start + 5s);
+  EXPECT_EQ(start + 3ms, clock.current_time());
+  EXPECT_TRUE(source.event.is_signalled());
+
+  // The interrupt has been handled, so the next sleep lasts its full interval.
+  clock.sleep(start + 5s);
+  EXPECT_EQ(start + 5s, clock.current_time());
+}
+
+TEST_F(EventTest, SignalBeforeSleepSkipsSleep) {
+  ClockType& clock{ClockType::clock()};
+  EventType event{};
+  const auto start{clock.current_time()};
+
+  event.signal();
+  clock.sleep(start + 1s);
+  EXPECT_EQ(start, clock.current_time());
+}
+
+template <typename SchedulerType>
+void expect_scheduler_runs_task_as_soon_as_signalled() {
+  tvsc::hal::rcc::RccNoop rcc{};
+  ClockType& clock{ClockType::clock()};
+  const auto start{clock.current_time()};
+  InterruptSource source{{start + 1234us, start + 2s}};
+  HandlerStats stats{};
+  SchedulerType scheduler{rcc};
+  scheduler.add_task(event_handler(source, stats));
+
+  // Nothing to do until the interrupt, so the scheduler asks to sleep for the maximum interval.
+  EXPECT_EQ(start + 5s, scheduler.run_tasks_once());
+  clock.sleep(start + 5s);
+  EXPECT_EQ(start + 1234us, clock.current_time());
+
+  scheduler.run_tasks_once();
+  EXPECT_EQ(1, stats.wakeups);
+  EXPECT_EQ(ClockType::duration::zero(), stats.max_latency());
+
+  run_for(scheduler, 3s);
+  EXPECT_EQ(2, stats.wakeups);
+  EXPECT_EQ(ClockType::duration::zero(), stats.max_latency());
+}
+
+TEST_F(EventTest, SchedulerRunsTaskAsSoonAsSignalled) {
+  expect_scheduler_runs_task_as_soon_as_signalled<SchedulerT<ClockType, 4>>();
+}
+
+TEST_F(EventTest, HeapSchedulerRunsTaskAsSoonAsSignalled) {
+  expect_scheduler_runs_task_as_soon_as_signalled<HeapSchedulerT<ClockType, 4>>();
+}
+
+TEST_F(EventTest, HeapSchedulerStopsTrackingRemovedWaiter) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  ClockType& clock{ClockType::clock()};
+  InterruptSource source{{}};
+  HandlerStats stats{};
+  HeapSchedulerT<ClockType, 4> scheduler{rcc};
+  const size_t index{scheduler.add_task(event_handler(source, stats))};
+  scheduler.run_tasks_once();
+
+  scheduler.remove_task(index);
+  source.event.signal();
+  EXPECT_EQ(clock.current_time() + 5s, scheduler.run_tasks_once());
+  EXPECT_EQ(0, stats.wakeups);
+}
+
+TEST_F(EventTest, HeapSchedulerRunsTimedOutAndSignalledWaiterInOrderOfDeadline) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  ClockType& clock{ClockType::clock()};
+  const auto start{clock.current_time()};
+  EventType event{};
+  std::vector<int> order{};
+  HeapSchedulerT<ClockType, 4> scheduler{rcc};
+  const auto run_at{[](std::vector<int>& order, int id, ClockType::time_point t) -> TaskType {
+    co_yield t;
+    order.push_back(id);
+  }};
+  scheduler.add_task(run_at(order, 1, start + 500us));
+  scheduler.add_task([](EventType& event, std::vector<int>& order,
+                        ClockType::time_point deadline) -> TaskType {
+    co_await event.wait_until(deadline);
+    order.push_back(2);
+  }(event, order, start + 1ms));
+  scheduler.add_task(run_at(order, 3, start + 2ms));
+  scheduler.run_tasks_once();
+
+  // The second task's wait has timed out and its event is signalled. Waking it must not delay it
+  // past the third task.
+  clock.set_current_time(start + 3ms);
+  event.signal();
+  scheduler.run_tasks_once();
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), order);
+}
+
+/**
+ * Compares a task that polls for interrupts every 10ms, as bringup/can_rx.h does for the CAN bus,
+ * with a task that awaits an event signalled by the interrupt handler.
+ */
+template <typename SchedulerType>
+void expect_events_replace_polling() {
+  tvsc::hal::rcc::RccNoop rcc{};
+  // About 10 interrupts per second, out of phase with the polling interval.
+  const auto interrupt_times{[] {
+    const auto start{ClockType::now()};
+    std::vector<ClockType::time_point> times{};
+    for (size_t i = 0; i < 100; ++i) {
+      times.push_back(start + 1700us + i * 97300us);
+    }
+    return times;
+  }};
+
+  HandlerStats polling{};
+  {
+    InterruptSource source{interrupt_times()};
+    SchedulerType scheduler{rcc};
+    scheduler.add_task(polling_handler(source, polling));
+    run_for(scheduler, 10s);
+  }
+
+  HandlerStats event_driven{};
+  {
+    InterruptSource source{interrupt_times()};
+    SchedulerType scheduler{rcc};
+    scheduler.add_task(event_handler(source, event_driven));
+    run_for(scheduler, 10s);
+  }
+
+  ASSERT_EQ(100, polling.latencies.size());
+  ASSERT_EQ(100, event_driven.latencies.size());
+
+  // Polling wakes up every 10ms whether or not there is anything to do, and each interrupt waits
+  // for the next poll.
+  EXPECT_GE(polling.wakeups, 1000);
+  EXPECT_GT(polling.max_latency(), 5ms);
+  EXPECT_LE(polling.max_latency(), 10ms);
+
+  // With an event, the task wakes once per interrupt, at the time of the interrupt.
+  EXPECT_EQ(100, event_driven.wakeups);
+  EXPECT_EQ(ClockType::duration::zero(), event_driven.max_latency());
+}
+
+TEST_F(EventTest, EventsReplacePollingWithScheduler) {
+  expect_events_replace_polling<SchedulerT<ClockType, 4>>();
+}
+
+TEST_F(EventTest, EventsReplacePollingWithHeapScheduler) {
+  expect_events_replace_polling<HeapSchedulerT<ClockType, 4>>();
+}
+
+}  // namespace tvsc::system
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#include "hal/error.h"
+#include "hal/rcc/rcc.h"
+#include "system/task.h"
+
+namespace tvsc::system {
+
+/**
+ * Scheduler with the same interface as SchedulerT that keeps its tasks in a binary min-heap ordered
+ * by the time at which each task next wants to run.
+ *
+ * SchedulerT scans every slot on every pass, reading the clock for each task, so a pass costs
+ * O(QUEUE_SIZE) even if a single task is due. Here, the clock is read once per pass, each task that
+ * is due is popped from the heap in O(log n), and the next wakeup time is at the top of the heap. A
+ * pass where k tasks are due costs O(k log n). This matters with many tasks that each run
+ * infrequently; with a handful of tasks, SchedulerT is just as fast and simpler.
+ *
+ * Each task runs at most once per pass. Tasks that have run are returned to the heap at the end of
+ * the pass, so a task that yields a wakeup time that has already passed runs again in the next
+ * pass, as with SchedulerT. Tasks added during a pass can run in that same pass.
+ *
+ * The heap caches the wakeup time of each task. A sleeping task must be woken with wake_task(), and
+ * not with TaskT::wake() directly, so that it is moved up the heap. An EventT can be signalled from
+ * an interrupt handler, where the heap cannot be touched, so the tasks waiting on events are also
+ * kept in a separate list that is checked at the start of each pass. That check costs O(w) for w
+ * waiting tasks.
+ */
+template <typename ClockT, size_t QUEUE_SIZE>
+class HeapSchedulerT final {
+ public:
+  using ClockType = ClockT;
+  using TaskType = TaskT<ClockType>;
+
+ private:
+  static constexpr size_t NOT_IN_HEAP{std::numeric_limits<size_t>::max()};
+  static constexpr size_t NOT_WAITING{std::numeric_limits<size_t>::max()};
+
+  struct Entry final {
+    typename ClockType::time_point wait_until{};
+    size_t index{};
+  };
+
+  ClockType* clock_{&ClockType::clock()};
+  tvsc::hal::rcc::Rcc* rcc_;
+  std::array<TaskType, QUEUE_SIZE> task_queue_{};
+  size_t num_tasks_{};
+
+  // Min-heap of the tasks waiting to run, and the position of each task in it.
+  std::array<Entry, QUEUE_SIZE> heap_{};
+  size_t heap_size_{};
+  std::array<size_t, QUEUE_SIZE> heap_positions_{};
+
+  // Tasks that have run during the current pass, to be returned to the heap when it ends.
+  std::array<size_t, QUEUE_SIZE> ran_this_pass_{};
+  size_t num_ran_this_pass_{};
+
+  // Tasks waiting on an event, and the position of each task in this list.
+  std::array<size_t, QUEUE_SIZE> event_waiters_{};
+  size_t num_event_waiters_{};
+  std::array<size_t, QUEUE_SIZE> event_waiter_positions_{};
+
+  bool stop_requested_{false};
+
+  void place(size_t position, const Entry& entry) {
+    heap_[position] = entry;
+    heap_positions_[entry.index] = position;
+  }
+
+  void sift_up(size_t position) {
+    const Entry entry{heap_[position]};
+    while (position > 0) {
+      const size_t parent{(position - 1) / 2};
+      if (heap_[parent].wait_until <= entry.wait_until) {
+        break;
+      }
+      place(position, heap_[parent]);
+      position = parent;
+    }
+    place(position, entry);
+  }
+
+  void sift_down(size_t position) {
+    const Entry entry{heap_[position]};
+    while (true) {
+      size_t child{2 * position + 1};
+      if (child >= heap_size_) {
+        break;
+      }
+      if (child + 1 < heap_size_ && heap_[child + 1].wait_until < heap_[child].wait_until) {
+        ++child;
+      }
+      if (entry.wait_until <= heap_[child].wait_until) {
+        break;
+      }
+      place(position, heap_[child]);
+      position = child;
+    }
+    place(position, entry);
+  }
+
+  void push(size_t index) {
+    place(heap_size_, Entry{task_queue_[index].estimate_runnable_at(), index});
+    ++heap_size_;
+    sift_up(heap_size_ - 1);
+    if (task_queue_[index].is_waiting_on_event()) {
+      event_waiter_positions_[index] = num_event_waiters_;
+      event_waiters_[num_event_waiters_++] = index;
+    }
+  }
+
+  void remove_event_waiter(size_t index) {
+    const size_t position{event_waiter_positions_[index]};
+    if (position == NOT_WAITING) {
+      return;
+    }
+    event_waiter_positions_[index] = NOT_WAITING;
+    --num_event_waiters_;
+    if (position != num_event_waiters_) {
+      const size_t moved{event_waiters_[num_event_waiters_]};
+      event_waiters_[position] = moved;
+      event_waiter_positions_[moved] = position;
+    }
+  }
+
+  // Move the tasks whose events have been signalled to the top of the heap.
+  void check_event_waiters(typename ClockType::time_point now) {
+    size_t i{0};
+    while (i < num_event_waiters_) {
+      const size_t index{event_waiters_[i]};
+      if (task_queue_[index].is_runnable(now)) {
+        remove_event_waiter(index);
+        // The wait may also have timed out, in which case the task is already due. Never raise its
+        // key, since it is only sifted up.
+        const size_t position{heap_positions_[index]};
+        heap_[position].wait_until = std::min(heap_[position].wait_until, now);
+        sift_up(position);
+      } else {
+        ++i;
+      }
+    }
+  }
+
+  void erase(size_t position) {
+    heap_positions_[heap_[position].index] = NOT_IN_HEAP;
+    --heap_size_;
+    if (position == heap_size_) {
+      return;
+    }
+    const auto removed_wait_until{heap_[position].wait_until};
+    place(position, heap_[heap_size_]);
+    if (heap_[position].wait_until < removed_wait_until) {
+      sift_up(position);
+    } else {
+      sift_down(position);
+    }
+  }
+
+ public:
+  HeapSchedulerT(tvsc::hal::rcc::Rcc& rcc) : rcc_(&rcc) {
+    heap_positions_.fill(NOT_IN_HEAP);
+    event_waiter_positions_.fill(NOT_WAITING);
+  }
+
+  size_t add_task(TaskType&& task) {
+    for (size_t i = 0; i < QUEUE_SIZE; ++i) {
+      if (!task_queue_[i].is_valid()) {
+        task_queue_[i] = std::move(task);
+        ++num_tasks_;
+        push(i);
+        return i;
+      }
+    }
+    // No more room for tasks. The size of the scheduler is fixed at compile-time and is required to
+    // have enough space for all possible tasks.
+    error();
+  }
+
+  void remove_task(size_t index) {
+    if (!task_queue_.at(index).is_valid()) {
+      return;
+    }
+    if (heap_positions_[index] != NOT_IN_HEAP) {
+      erase(heap_positions_[index]);
+    }
+    remove_event_waiter(index);
+    task_queue_[index] = {};
+    --num_tasks_;
+  }
+
+  /**
+   * Make the task at index runnable now. If this is called while the scheduler is running tasks,
+   * the woken task runs in the same pass if it has not already run, and in the next pass
+   * otherwise; either way, run_tasks_once() does not return a later wakeup time. Must not be called
+   * from an interrupt handler.
+   */
+  void wake_task(size_t index) {
+    TaskType& task{task_queue_.at(index)};
+    task.wake();
+    const size_t position{heap_positions_[index]};
+    if (position != NOT_IN_HEAP) {
+      heap_[position].wait_until = task.estimate_runnable_at();
+      sift_up(position);
+    }
+  }
+
+  TaskType& task(size_t index) noexcept { return task_queue_.at(index); }
+  const TaskType& task(size_t index) const noexcept { return task_queue_.at(index); }
+
+  size_t queue_size() const { return num_tasks_; }
+
+  auto run_tasks_once() {
+    using namespace std::chrono_literals;
+    const auto now{clock_->current_time()};
+
+    check_event_waiters(now);
+    num_ran_this_pass_ = 0;
+    while (heap_size_ > 0 && heap_[0].wait_until <= now) {
+      const size_t index{heap_[0].index};
+      erase(0);
+      remove_event_waiter(index);
+      TaskType& task{task_queue_[index]};
+      task.run();
+      if (task.is_complete()) {
+        task_queue_[index] = {};
+        --num_tasks_;
+      } else {
+        ran_this_pass_[num_ran_this_pass_++] = index;
+      }
+    }
+    for (size_t i = 0; i < num_ran_this_pass_; ++i) {
+      const size_t index{ran_this_pass_[i]};
+      // Another task may have removed this task after it ran, and may even have added a new task
+      // in its slot, which is already in the heap.
+      if (task_queue_[index].is_valid() && heap_positions_[index] == NOT_IN_HEAP) {
+        push(index);
+      }
+    }
+
+    auto next_wakeup_time{now + 5s};
+    if (heap_size_ > 0) {
+      next_wakeup_time = std::min(next_wakeup_time, heap_[0].wait_until);
+    }
+    for (size_t i = 0; i < num_event_waiters_; ++i) {
+      // An event signalled during the pass makes its task ready to run now.
+      next_wakeup_time =
+          std::min(next_wakeup_time, task_queue_[event_waiters_[i]].estimate_runnable_at());
+    }
+    return next_wakeup_time;
+  }
+
+  /**
+   * Run tasks until stop() is called, sleeping between passes. See SchedulerT::start() for the
+   * power strategy.
+   */
+  void start() {
+    rcc_->set_clock_to_energy_efficient_speed();
+    while (!stop_requested_) {
+      auto next_wakeup_time{run_tasks_once()};
+      clock_->sleep(next_wakeup_time);
+    }
+  }
+
+  void stop() { stop_requested_ = true; }
+};
+
+}  // namespace tvsc::system
@@ -0,0 +1,178 @@
+#include "system/heap_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hal/rcc/rcc_noop.h"
+#include "system/sample_tasks.h"
+#include "system/task.h"
+#include "time/mock_clock.h"
+
+namespace tvsc::system {
+
+using namespace std::chrono_literals;
+
+using ClockType = tvsc::time::MockClock;
+using TaskType = TaskT<ClockType>;
+static constexpr size_t DEFAULT_QUEUE_SIZE{8};
+using SchedulerType = HeapSchedulerT<ClockType, DEFAULT_QUEUE_SIZE>;
+
+TaskType record_runs(std::vector<int>& order, int id, ClockType::duration period) {
+  while (true) {
+    order.push_back(id);
+    co_yield period;
+  }
+}
+
+TEST(HeapSchedulerTest, RunsTaskThatRunsOnce) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  SchedulerType scheduler{rcc};
+  scheduler.add_task(just_return<ClockType>());
+  EXPECT_EQ(1, scheduler.queue_size());
+  scheduler.run_tasks_once();
+  EXPECT_EQ(0, scheduler.queue_size());
+}
+
+TEST(HeapSchedulerTest, RunsEachTaskAtMostOncePerPass) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  int run_count{};
+  SchedulerType scheduler{rcc};
+  const size_t task_index{scheduler.add_task(run_forever<ClockType>(run_count))};
+  scheduler.add_task(run_forever<ClockType>(run_count));
+
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_LE(scheduler.run_tasks_once(), ClockType::now());
+  }
+  EXPECT_EQ(20, run_count);
+  EXPECT_FALSE(scheduler.task(task_index).is_complete());
+}
+
+TEST(HeapSchedulerTest, RunsTasksInOrderOfWakeupTime) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  ClockType& clock{ClockType::clock()};
+  std::vector<int> order{};
+  SchedulerType scheduler{rcc};
+  scheduler.add_task(record_runs(order, 3, 3ms));
+  scheduler.add_task(record_runs(order, 1, 1ms));
+  scheduler.add_task(record_runs(order, 2, 2ms));
+  scheduler.run_tasks_once();
+  order.clear();
+
+  const auto start{clock.current_time()};
+  while (clock.current_time() < start + 6ms) {
+    clock.set_current_time(scheduler.run_tasks_once());
+  }
+  scheduler.run_tasks_once();
+
+  // Each task ran once per period, and the earliest wakeup came first. The order of tasks that wake
+  // at the same time is not specified.
+  EXPECT_EQ(1, order.front());
+  EXPECT_EQ(6, std::count(order.begin(), order.end(), 1));
+  EXPECT_EQ(3, std::count(order.begin(), order.end(), 2));
+  EXPECT_EQ(2, std::count(order.begin(), order.end(), 3));
+}
+
+TEST(HeapSchedulerTest, ReturnsNextWakeupTime) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  ClockType& clock{ClockType::clock()};
+  std::vector<int> order{};
+  SchedulerType scheduler{rcc};
+  scheduler.add_task(record_runs(order, 1, 30ms));
+  scheduler.add_task(record_runs(order, 2, 10ms));
+
+  const auto now{clock.current_time()};
+  EXPECT_EQ(now + 10ms, scheduler.run_tasks_once());
+  EXPECT_EQ(now + 10ms, scheduler.run_tasks_once());
+
+  // Nothing ever wants to run: wake up every 5s anyway, as SchedulerT does.
+  SchedulerType idle_scheduler{rcc};
+  EXPECT_EQ(now + 5s, idle_scheduler.run_tasks_once());
+}
+
+TEST(HeapSchedulerTest, CanRunTaskThatAddsSubtasks) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  int run_count{};
+  SchedulerType scheduler{rcc};
+  scheduler.add_task([](SchedulerType& scheduler, int& run_count) -> TaskType {
+    while (true) {
+      scheduler.add_task(run_forever<ClockType>(run_count));
+      ++run_count;
+      co_yield 0ms;
+    }
+  }(scheduler, run_count));
+
+  // As with SchedulerT, a subtask added during a pass runs in that pass.
+  scheduler.run_tasks_once();
+  EXPECT_EQ(2, scheduler.queue_size());
+  EXPECT_EQ(2, run_count);
+
+  run_count = 0;
+  scheduler.run_tasks_once();
+  EXPECT_EQ(3, scheduler.queue_size());
+  EXPECT_EQ(3, run_count);
+}
+
+TEST(HeapSchedulerTest, CanWakeSleepingTask) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  ClockType& clock{ClockType::clock()};
+  int run_count{};
+  SchedulerType scheduler{rcc};
+  scheduler.add_task(do_something<ClockType, 2, /* wake_interval_us */ 1'000'000>(run_count));
+  const size_t task_index{
+      scheduler.add_task(do_something<ClockType, 2, /* wake_interval_us */ 2'000'000>(run_count))};
+
+  scheduler.run_tasks_once();
+  EXPECT_EQ(2, run_count);
+  EXPECT_GT(scheduler.run_tasks_once(), clock.current_time() + 500ms);
+
+  scheduler.wake_task(task_index);
+  EXPECT_TRUE(scheduler.task(task_index).is_runnable(clock.current_time()));
+  scheduler.run_tasks_once();
+  EXPECT_EQ(3, run_count);
+}
+
+TEST(HeapSchedulerTest, TaskWokenByAnotherTaskRunsInSamePass) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  ClockType& clock{ClockType::clock()};
+  int run_count{};
+  SchedulerType scheduler{rcc};
+  const size_t sleeper_index{
+      scheduler.add_task(do_something<ClockType, 2, /* wake_interval_us */ 1'000'000>(run_count))};
+  scheduler.add_task([](SchedulerType& scheduler, size_t index) -> TaskType {
+    co_yield 1ms;
+    scheduler.wake_task(index);
+  }(scheduler, sleeper_index));
+
+  scheduler.run_tasks_once();
+  EXPECT_EQ(1, run_count);
+  clock.increment_current_time(1ms);
+  // The woken task moves to the top of the heap, so it runs without waiting for the next pass.
+  scheduler.run_tasks_once();
+  EXPECT_EQ(2, run_count);
+}
+
+TEST(HeapSchedulerTest, CanRemoveTasks) {
+  tvsc::hal::rcc::RccNoop rcc{};
+  ClockType& clock{ClockType::clock()};
+  std::vector<int> order{};
+  SchedulerType scheduler{rcc};
+  const size_t first{scheduler.add_task(record_runs(order, 1, 1ms))};
+  scheduler.add_task(record_runs(order, 2, 1ms));
+  scheduler.run_tasks_once();
+
+  scheduler.remove_task(first);
+  EXPECT_EQ(1, scheduler.queue_size());
+  clock.increment_current_time(1ms);
+  order.clear();
+  scheduler.run_tasks_once();
+  EXPECT_EQ((std::vector<int>{2}), order);
+
+  // The slot can be reused.
+  EXPECT_EQ(first, scheduler.add_task(record_runs(order, 3, 1ms)));
+  EXPECT_EQ(2, scheduler.queue_size());
+}
+
+}  // namespace tvsc::system
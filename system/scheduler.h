@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <coroutine>
@@ -29,6 +30,7 @@ class SchedulerT final {
   tvsc::hal::rcc::Rcc* rcc_;
   std::array<TaskType, QUEUE_SIZE> task_queue_{};
   bool stop_requested_{false};
+  bool wake_requested_{false};
 
   friend std::string to_string<ClockType, QUEUE_SIZE>(const SchedulerT&);
 
@@ -49,6 +51,17 @@ class SchedulerT final {
 
   void remove_task(size_t index) { task_queue_.at(index) = {}; }
 
+  /**
+   * Make the task at index runnable now. If this is called while the scheduler is running tasks,
+   * for example by a task that just enqueued work for the task at index, the scheduler runs the
+   * woken task before it sleeps again. Must not be called from an interrupt handler; there, signal
+   * an EventT that the task awaits instead.
+   */
+  void wake_task(size_t index) {
+    task_queue_.at(index).wake();
+    wake_requested_ = true;
+  }
+
   TaskType& task(size_t index) noexcept { return task_queue_.at(index); }
   const TaskType& task(size_t index) const noexcept { return task_queue_.at(index); }
 
@@ -65,6 +78,7 @@ class SchedulerT final {
   auto run_tasks_once() {
     using namespace std::chrono_literals;
     auto next_wakeup_time{clock_->current_time() + 5s};
+    wake_requested_ = false;
     for (size_t i = 0; i < QUEUE_SIZE; ++i) {
       TaskType& task{task_queue_[i]};
       if (task.is_valid()) {
@@ -77,6 +91,10 @@ class SchedulerT final {
         next_wakeup_time = std::min(next_wakeup_time, task.estimate_runnable_at());
       }
     }
+    if (wake_requested_) {
+      // A task woken after its wakeup time was estimated above is ready to run now.
+      next_wakeup_time = std::min(next_wakeup_time, clock_->current_time());
+    }
     return next_wakeup_time;
   }
 
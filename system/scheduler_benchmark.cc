@@ -0,0 +1,71 @@
+/**
+ * Compares the cost of a scheduler pass with SchedulerT, which scans every task, and with
+ * HeapSchedulerT, which keeps its tasks in a heap ordered by wakeup time.
+ *
+ * NUM_TASKS periodic tasks are staggered so that exactly one of them is due at each wakeup, as with
+ * many tasks that each run infrequently. Each iteration runs one pass and then advances the
+ * MockClock to the wakeup time that the pass returned.
+ *
+ *   bazel run -c opt //system:scheduler_benchmark
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "hal/rcc/rcc_noop.h"
+#include "system/heap_scheduler.h"
+#include "system/scheduler.h"
+#include "system/task.h"
+#include "time/mock_clock.h"
+
+namespace tvsc::system {
+
+using ClockType = tvsc::time::MockClock;
+using TaskType = TaskT<ClockType>;
+
+TaskType periodic(ClockType::time_point first_wakeup, ClockType::duration period,
+                  uint64_t& run_count) {
+  auto wakeup{first_wakeup};
+  while (true) {
+    co_yield wakeup;
+    ++run_count;
+    wakeup += period;
+  }
+}
+
+template <template <typename, size_t> class SchedulerTemplate, size_t NUM_TASKS>
+void BM_SchedulerPass(benchmark::State& state) {
+  using SchedulerType = SchedulerTemplate<ClockType, NUM_TASKS>;
+  tvsc::hal::rcc::RccNoop rcc{};
+  ClockType& clock{ClockType::clock()};
+  // Large schedulers do not fit on the stack.
+  auto scheduler{std::make_unique<SchedulerType>(rcc)};
+
+  uint64_t run_count{};
+  const auto start{clock.current_time()};
+  const ClockType::duration period{std::chrono::microseconds{NUM_TASKS}};
+  for (size_t i = 0; i < NUM_TASKS; ++i) {
+    scheduler->add_task(periodic(start + std::chrono::microseconds{i + 1}, period, run_count));
+  }
+  // Let every task reach its first wakeup.
+  scheduler->run_tasks_once();
+
+  for (auto _ : state) {
+    const auto next_wakeup_time{scheduler->run_tasks_once()};
+    clock.set_current_time(next_wakeup_time);
+  }
+  state.SetItemsProcessed(run_count);
+}
+
+BENCHMARK(BM_SchedulerPass<SchedulerT, 8>);
+BENCHMARK(BM_SchedulerPass<HeapSchedulerT, 8>);
+BENCHMARK(BM_SchedulerPass<SchedulerT, 64>);
+BENCHMARK(BM_SchedulerPass<HeapSchedulerT, 64>);
+BENCHMARK(BM_SchedulerPass<SchedulerT, 512>);
+BENCHMARK(BM_SchedulerPass<HeapSchedulerT, 512>);
+BENCHMARK(BM_SchedulerPass<SchedulerT, 4096>);
+BENCHMARK(BM_SchedulerPass<HeapSchedulerT, 4096>);
+
+}  // namespace tvsc::system
@@ -217,4 +217,51 @@ TEST(SchedulerTest, CanRunTaskThatSleepsMultipleTimes) {
   EXPECT_EQ(NUM_ITERATIONS, run_count);
 }
 
+TEST(SchedulerTest, CanWakeSleepingTask) {
+  using namespace std::chrono_literals;
+  static constexpr size_t NUM_ITERATIONS{2};
+  static constexpr uint64_t WAKE_INTERVAL_US{1'000'000};
+
+  tvsc::hal::rcc::RccNoop rcc{};
+  int run_count{};
+
+  SchedulerType scheduler{rcc};
+  ClockType& clock{ClockType::clock()};
+  size_t task_index{
+      scheduler.add_task(do_something<ClockType, NUM_ITERATIONS, WAKE_INTERVAL_US>(run_count))};
+
+  scheduler.run_tasks_once();
+  EXPECT_EQ(1, run_count);
+  EXPECT_GT(scheduler.run_tasks_once(), clock.current_time() + 500ms);
+  EXPECT_EQ(1, run_count);
+
+  scheduler.wake_task(task_index);
+  EXPECT_TRUE(scheduler.task(task_index).is_runnable(clock.current_time()));
+  scheduler.run_tasks_once();
+  EXPECT_EQ(2, run_count);
+}
+
+TEST(SchedulerTest, DoesNotSleepPastTaskWokenByAnotherTask) {
+  using namespace std::chrono_literals;
+  tvsc::hal::rcc::RccNoop rcc{};
+  int run_count{};
+
+  SchedulerType scheduler{rcc};
+  ClockType& clock{ClockType::clock()};
+  // The sleeping task comes first, so its wakeup time has already been estimated when the second
+  // task wakes it.
+  size_t sleeper_index{
+      scheduler.add_task(do_something<ClockType, 2, /* wake_interval_us */ 1'000'000>(run_count))};
+  scheduler.add_task([](SchedulerType& scheduler, size_t index) -> TaskType {
+    co_yield 1ms;
+    scheduler.wake_task(index);
+  }(scheduler, sleeper_index));
+
+  scheduler.run_tasks_once();
+  clock.increment_current_time(1ms);
+  EXPECT_LE(scheduler.run_tasks_once(), clock.current_time());
+  scheduler.run_tasks_once();
+  EXPECT_EQ(2, run_count);
+}
+
 }  // namespace tvsc::system
@@ -5,6 +5,7 @@
 #include "hal/board/board.h"
 #include "hal/mcu/mcu.h"
 #include "hal/pinout/pinout.h"
+#include "system/event.h"
 #include "system/scheduler.h"
 #include "system/task.h"
 #include "time/embedded_clock.h"
@@ -25,6 +26,7 @@ class System final {
   using ClockType = tvsc::time::EmbeddedClock;
   using Scheduler = SchedulerT<ClockType, SCHEDULER_QUEUE_SIZE>;
   using Task = TaskT<ClockType>;
+  using Event = EventT<ClockType>;
 
  private:
   McuType* const mcu_{&McuType::mcu()};
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <coroutine>
 #include <cstdint>
 
+#include "system/event.h"
+
 namespace tvsc::system {
 
 template <typename ClockType>
@@ -19,6 +22,9 @@ class TaskT final {
     // TODO(james): Replace these with a general task status that indicates what resources the task
     // is currently using, and when it might need access to the CPU again.
     ClockType::time_point wait_until_{};
+    // Event that the task is waiting on, if any. The task is runnable once this is signalled, even
+    // before wait_until_.
+    const EventT<ClockType>* waiting_on_{nullptr};
 
     TaskT get_return_object() noexcept { return TaskT{HandleType::from_promise(*this)}; }
 
@@ -36,6 +42,16 @@ class TaskT final {
       return {};
     }
 
+    void wait_for_event(const EventT<ClockType>& event,
+                        typename ClockType::time_point deadline) noexcept {
+      waiting_on_ = &event;
+      wait_until_ = deadline;
+    }
+
+    bool is_event_signalled() const noexcept {
+      return waiting_on_ != nullptr && waiting_on_->is_signalled();
+    }
+
     void unhandled_exception() noexcept {}
     void return_void() noexcept {}
   };
@@ -70,7 +86,7 @@ class TaskT final {
   bool is_runnable(ClockType::time_point now) const noexcept {
     if (handle_) {
       auto& promise{handle_.promise()};
-      return now >= promise.wait_until_;
+      return now >= promise.wait_until_ || promise.is_event_signalled();
     } else {
       return false;
     }
@@ -79,12 +95,23 @@ class TaskT final {
   ClockType::time_point estimate_runnable_at() const noexcept {
     if (handle_) {
       auto& promise{handle_.promise()};
+      if (promise.is_event_signalled()) {
+        return std::min(promise.wait_until_, ClockType::now());
+      }
       return promise.wait_until_;
     } else {
       return ClockType::time_point::max();
     }
   }
 
+  /**
+   * Whether the task is suspended in a co_await on an EventT. A signal can make such a task
+   * runnable before the time given by estimate_runnable_at().
+   */
+  bool is_waiting_on_event() const noexcept {
+    return handle_ && handle_.promise().waiting_on_ != nullptr;
+  }
+
   bool is_complete() const noexcept {
     if (handle_) {
       return handle_.done();
@@ -95,7 +122,21 @@ class TaskT final {
 
   bool is_valid() const noexcept { return bool(handle_); }
 
-  void run() noexcept { handle_(); }
+  /**
+   * Make the task runnable now, even if it yielded a later wakeup time. Used to signal a task that
+   * work has arrived so that it does not have to poll for it.
+   */
+  void wake() noexcept {
+    if (handle_) {
+      auto& promise{handle_.promise()};
+      promise.wait_until_ = std::min(promise.wait_until_, ClockType::now());
+    }
+  }
+
+  void run() noexcept {
+    handle_.promise().waiting_on_ = nullptr;
+    handle_();
+  }
 };
 
 }  // namespace tvsc::system
@@ -11,6 +11,11 @@ void EmbeddedClock::sleep_us(tvsc::hal::TimeType microseconds) noexcept {
   static constexpr tvsc::hal::TimeType TIME_TO_START_TIMER_US{25};
   static constexpr tvsc::hal::TimeType TIME_TO_WAKE_FROM_STOP_MODE_US{500};
 
+  // An interrupt has made work available since the scheduler last looked for it.
+  if (sleep_interrupted_.exchange(false, std::memory_order_acquire)) {
+    return;
+  }
+
   // We can't achieve any better precision than this, so just don't bother.
   if (microseconds < TIME_TO_START_TIMER_US) {
     return;
@@ -22,13 +27,20 @@ void EmbeddedClock::sleep_us(tvsc::hal::TimeType microseconds) noexcept {
   // is not running, its interrupt has fired. Alternatively, for short sleeps where the sleep time
   // is less than the time it takes to wake from stop mode, we simply block on WFI (Wait For
   // Interrupt). Note: entering stop mode is only 1-2 clock cycles, so we ignore that time.
+  //
+  // An interrupt handler can also end the sleep early with interrupt_sleep(). The flag is checked
+  // before each WFI, so an interrupt that lands between the check and the WFI delays the wakeup
+  // until the next interrupt, at the latest the end of the timer interval.
   timer_.start(microseconds);
+  bool interrupted{false};
   if (microseconds < TIME_TO_WAKE_FROM_STOP_MODE_US) {
-    while (timer_.is_running()) {
+    while (timer_.is_running() &&
+           !(interrupted = sleep_interrupted_.load(std::memory_order_acquire))) {
       power_peripheral_->enter_sleep_mode();
     }
   } else {
-    while (timer_.is_running()) {
+    while (timer_.is_running() &&
+           !(interrupted = sleep_interrupted_.load(std::memory_order_acquire))) {
       // TODO(james): Issue 23. Fix the CAN bus so that it can wake from stop 1 mode when receiving
       // a message. Then, remove the next line and replace it with
       // power_peripheral_->enter_stop_mode();
@@ -37,10 +49,18 @@ void EmbeddedClock::sleep_us(tvsc::hal::TimeType microseconds) noexcept {
       power_peripheral_->enter_sleep_mode();
     }
     // In stop mode, the SysTick is not running, so we manually update the tick counter with the
-    // amount of time we spent in stop mode.
-    sys_tick_->increment_micros(microseconds);
+    // amount of time we spent in stop mode. The timer cannot tell us how long an interrupted sleep
+    // lasted, so we only do this for a full interval. Until the MCU enters stop mode here, the
+    // SysTick keeps running during the sleep anyway.
+    if (!interrupted) {
+      sys_tick_->increment_micros(microseconds);
+    }
     rcc_->restore_clock_speed();
   }
+  if (interrupted) {
+    timer_.stop();
+    sleep_interrupted_.store(false, std::memory_order_relaxed);
+  }
 }
 
 void EmbeddedClock::wait_us(tvsc::hal::TimeType microseconds) noexcept {
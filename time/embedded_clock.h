@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 
 #include "hal/power/power.h"
@@ -20,6 +21,7 @@ class EmbeddedClock final {
   tvsc::hal::timer::Timer timer_;
   tvsc::hal::power::Power* power_peripheral_;
   tvsc::hal::rcc::Rcc* rcc_;
+  std::atomic<bool> sleep_interrupted_{false};
 
   EmbeddedClock(tvsc::hal::systick::SysTickType& sys_tick,            //
                 tvsc::hal::timer::TimerPeripheral& timer_peripheral,  //
@@ -55,6 +57,10 @@ class EmbeddedClock final {
     return time_point{std::chrono::microseconds{current_time_micros()}};
   }
 
+  /**
+   * Sleep for the given interval, or until interrupt_sleep() is called. If interrupt_sleep() was
+   * called since the last sleep, this returns at once.
+   */
   void sleep_us(tvsc::hal::TimeType microseconds) noexcept;
   void sleep_ms(tvsc::hal::TimeType milliseconds) noexcept { sleep_us(milliseconds * 1000); }
 
@@ -65,6 +71,12 @@ class EmbeddedClock final {
 
   void sleep(time_point t) noexcept { sleep(t - current_time()); }
 
+  /**
+   * End the current or the next sleep. Safe to call from an interrupt handler; this is how an
+   * interrupt that makes a task runnable gets the scheduler out of sleep before its next wakeup.
+   */
+  void interrupt_sleep() noexcept { sleep_interrupted_.store(true, std::memory_order_release); }
+
   void wait_us(tvsc::hal::TimeType microseconds) noexcept;
   void wait_ms(tvsc::hal::TimeType milliseconds) noexcept { wait_us(milliseconds * 1000); }
 
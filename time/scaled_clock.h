@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <vector>
@@ -33,7 +34,9 @@ class ScaledClock final {
 
   std::vector<ClockableType*> clockables_{};
 
-  void update_clockables(time_point requested_time) noexcept {
+  std::atomic<bool> sleep_interrupted_{false};
+
+  void update_clockables(time_point requested_time, bool interruptible = false) noexcept {
     scaled_time_offset_ = current_time();
     base_time_offset_ = BaseClockType::now();
     do {
@@ -45,7 +48,7 @@ class ScaledClock final {
       for (auto* clockable : clockables_) {
         clockable->run(scaled_time_offset_);
       }
-    } while (scaled_time_offset_ != requested_time);
+    } while (scaled_time_offset_ != requested_time && !(interruptible && sleep_interrupted_));
   }
 
   // Private constructor. Can only be instantiated by the clock() static method.
@@ -75,13 +78,28 @@ class ScaledClock final {
   // Setters/modifiers for simulation and testing.
   void set_current_time(ScaledClock::time_point t) noexcept { update_clockables(t); }
 
-  void sleep(ScaledClock::time_point t) noexcept { set_current_time(t); }
+  /**
+   * Advance the time to t, unless interrupt_sleep() is called first. As on the board, where an
+   * interrupt ends the sleep, a Clockable that calls interrupt_sleep() from run() stops the time at
+   * the moment it ran. If interrupt_sleep() was called since the last sleep, this returns at once.
+   */
+  void sleep(ScaledClock::time_point t) noexcept {
+    if (!sleep_interrupted_.exchange(false)) {
+      update_clockables(t, /* interruptible */ true);
+      sleep_interrupted_ = false;
+    }
+  }
 
   template <typename Rep, typename Period>
   void sleep(std::chrono::duration<Rep, Period> d) noexcept {
-    set_current_time(current_time() + std::chrono::duration_cast<duration>(d));
+    sleep(current_time() + std::chrono::duration_cast<duration>(d));
   }
 
+  /**
+   * End the current or the next call to sleep(). Safe to call from a Clockable or another thread.
+   */
+  void interrupt_sleep() noexcept { sleep_interrupted_ = true; }
+
   template <typename Rep, typename Period>
   void increment_current_time(std::chrono::duration<Rep, Period> d) noexcept {
     set_current_time(current_time() + std::chrono::duration_cast<duration>(d));